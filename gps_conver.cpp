@@ -47,217 +47,322 @@ typedef struct tagDOY
 	TOD tod;
 }DOY;//年积日
 typedef DOY *PDOY;
-double FRAC(double morigin)
+long long FloorDiv(long long a, long long b) noexcept//向下取整的整数除法(b>0)
 {
-	return morigin - long(morigin);// 取小数部分
+	long long q = a / b;
+	if (a % b < 0)
+		q--;
+	return q;
 }
-void CommonTimeToJulianDay(PCOMMONTIME pct, PJULIANDAY pjd) //通用时到儒略日的转换
+long long DaysFromCivil(long long year, int month, int day) noexcept//公历年月日到日数(1970-01-01为第0天)，纯整数运算
+{
+	year -= month <= 2;
+	long long era = FloorDiv(year, 400);
+	long long yoe = year - era * 400;
+	long long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + doe - 719468;
+}
+void CivilFromDays(long long days, int *pyear, int *pmonth, int *pday) noexcept//日数到公历年月日，纯整数运算
+{
+	long long z = days + 719468;
+	long long era = FloorDiv(z, 146097);
+	long long doe = z - era * 146097;
+	long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	long long mp = (5 * doy + 2) / 153;
+	*pday = int(doy - (153 * mp + 2) / 5 + 1);
+	*pmonth = int(mp < 10 ? mp + 3 : mp - 9);
+	*pyear = int(yoe + era * 400 + (*pmonth <= 2));
+}
+const long CIVIL_EPOCH_JD = 2440587;//1970-01-01 0时所在儒略日的整数部分
+const long GPS_EPOCH_JD = 2444244;//1980-01-06 0时所在儒略日的整数部分
+const long GPS_EPOCH_DAYS = 3657;//GPS起点相对1970-01-01的天数
+int FullYear(int year) noexcept//两位数年份：80-99为19xx，00-79为20xx
+{
+	if (year >= 0 && year < 100)
+		return year < 80 ? year + 2000 : year + 1900;
+	return year;
+}
+bool IsLeapYear(long long year) noexcept
+{
+	return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+void DOYFromDays(long long days, int *pyear, int *pday) noexcept//日数到年和年积日，不经过月日
 {
-	if (pct->year<1900)
+	long long z = days + 719468;
+	long long era = FloorDiv(z, 146097);
+	long long doe = z - era * 146097;
+	long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);//从3月1日起算
+	long long year = yoe + era * 400;
+	if (doy >= 306)//次年1月、2月
 	{
-		if (pct->year<80)
-			pct->year += 2000;
-		else pct->year += 1900;
+		*pyear = int(year + 1);
+		*pday = int(doy - 306 + 1);
 	}
-	double ut = pct->hour + pct->minute / 60.0 + pct->second / 3600.0;
-	if (pct->month <= 2)
+	else
 	{
-		pct->year -= 1;
-		pct->month += 12;
+		*pyear = int(year);
+		*pday = int(doy + 59 + IsLeapYear(year) + 1);
 	}
-	pjd->day = int(365.25*pct->year) + int(30.6001*(pct->month + 1)) + pct->day + int(ut / 24 + 1720981.5);
-	pjd->tod.sn = ((pct->hour + 12) % 24) * 3600 + pct->minute * 60 + (int)pct->second;//秒的整数部分
-	pjd->tod.tos = pct->second - (int)pct->second;//秒的小数部分
+}
+/*
+以下转换均按值返回结果，不分配堆内存，不抛出异常；
+每种转换直接由整数天数和天内秒数换算，不经过中间表示。
+*/
+JULIANDAY CommonTimeToJulianDay(const COMMONTIME &ct) noexcept//通用时到儒略日的转换
+{
+	int year = FullYear(ct.year);
+	int isec = int(ct.second);
+	long long t = DaysFromCivil(year, ct.month, ct.day) * 86400
+		+ ct.hour * 3600 + ct.minute * 60 + isec + 43200;//自儒略日CIVIL_EPOCH_JD起点(前一日正午)起的秒数
+	long long q = FloorDiv(t, 86400);
+	JULIANDAY jd;
+	jd.day = long(CIVIL_EPOCH_JD + q);
+	jd.tod.sn = long(t - q * 86400);//秒的整数部分
+	jd.tod.tos = ct.second - isec;//秒的小数部分
+	return jd;
+}
+COMMONTIME JulianDayToCommonTime(const JULIANDAY &jd) noexcept//儒略日到通用时的转换
+{
+	long long t = (long long)(jd.day - CIVIL_EPOCH_JD) * 86400 + jd.tod.sn - 43200;
+	long long days = FloorDiv(t, 86400);
+	long sod = long(t - days * 86400);
+	COMMONTIME ct;
+	CivilFromDays(days, &ct.year, &ct.month, &ct.day);
+	ct.hour = sod / 3600;
+	ct.minute = (sod % 3600) / 60;
+	ct.second = sod % 60 + jd.tod.tos;
+	return ct;
+}
+GPSTIME JulianDayToGPSTime(const JULIANDAY &jd) noexcept//儒略日到GPS时的转换
+{
+	long long t = (long long)(jd.day - GPS_EPOCH_JD) * 86400 + jd.tod.sn - 43200;//自GPS起点起的秒数
+	long long wn = FloorDiv(t, 604800);
+	GPSTIME gt;
+	gt.wn = int(wn);
+	gt.tow.sn = long(t - wn * 604800);
+	gt.tow.tos = jd.tod.tos;
+	return gt;
+}
+JULIANDAY GPSTimeToJulianDay(const GPSTIME &gt) noexcept//GPS时到儒略日的转换
+{
+	long long t = (long long)gt.tow.sn + 43200;
+	long long q = FloorDiv(t, 86400);
+	JULIANDAY jd;
+	jd.day = long(GPS_EPOCH_JD + (long long)gt.wn * 7 + q);
+	jd.tod.sn = long(t - q * 86400);
+	jd.tod.tos = gt.tow.tos;
+	return jd;
+}
+GPSTIME CommonTimeToGPSTime(const COMMONTIME &ct) noexcept//通用时到GPS时的转换
+{
+	int year = FullYear(ct.year);
+	int isec = int(ct.second);
+	long long t = (DaysFromCivil(year, ct.month, ct.day) - GPS_EPOCH_DAYS) * 86400
+		+ ct.hour * 3600 + ct.minute * 60 + isec;//自GPS起点起的秒数
+	long long wn = FloorDiv(t, 604800);
+	GPSTIME gt;
+	gt.wn = int(wn);
+	gt.tow.sn = long(t - wn * 604800);
+	gt.tow.tos = ct.second - isec;
+	return gt;
+}
+COMMONTIME GPSTimeToCommonTime(const GPSTIME &gt) noexcept//GPS时到通用时的转换
+{
+	long long t = (long long)gt.wn * 604800 + gt.tow.sn;
+	long long days = FloorDiv(t, 86400);
+	long sod = long(t - days * 86400);
+	COMMONTIME ct;
+	CivilFromDays(days + GPS_EPOCH_DAYS, &ct.year, &ct.month, &ct.day);
+	ct.hour = sod / 3600;
+	ct.minute = (sod % 3600) / 60;
+	ct.second = sod % 60 + gt.tow.tos;
+	return ct;
+}
+DOY CommonTimeToDOY(const COMMONTIME &ct) noexcept//通用时到年积日的转换
+{
+	static const unsigned short MonthDaysBefore[12] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+	int year = FullYear(ct.year);
+	DOY doy;
+	doy.day = (unsigned short)(MonthDaysBefore[ct.month - 1] + ct.day + (ct.month > 2 && IsLeapYear(year)));
+	doy.year = (unsigned short)year;
+	doy.tod.sn = long(ct.hour * 3600 + ct.minute * 60 + ct.second);
+	doy.tod.tos = ct.second - int(ct.second);
+	return doy;
+}
+COMMONTIME DOYToCommonTime(const DOY &doy) noexcept//年积日到通用时的转换
+{
+	long long days = DaysFromCivil(doy.year, 1, 1) + doy.day - 1;
+	COMMONTIME ct;
+	CivilFromDays(days, &ct.year, &ct.month, &ct.day);
+	ct.hour = int(doy.tod.sn / 3600);
+	ct.minute = int((doy.tod.sn % 3600) / 60);
+	ct.second = doy.tod.sn % 60 + doy.tod.tos;
+	return ct;
+}
+DOY GPSTimeToDOY(const GPSTIME &gt) noexcept//GPS时到年积日的转换
+{
+	long long t = (long long)gt.wn * 604800 + gt.tow.sn;
+	long long days = FloorDiv(t, 86400);
+	int year, day;
+	DOYFromDays(days + GPS_EPOCH_DAYS, &year, &day);
+	DOY doy;
+	doy.year = (unsigned short)year;
+	doy.day = (unsigned short)day;
+	doy.tod.sn = long(t - days * 86400);
+	doy.tod.tos = gt.tow.tos;
+	return doy;
+}
+GPSTIME DOYToGPSTime(const DOY &doy) noexcept//年积日到GPS时的转换
+{
+	long long t = (DaysFromCivil(doy.year, 1, 1) + doy.day - 1 - GPS_EPOCH_DAYS) * 86400 + doy.tod.sn;
+	long long wn = FloorDiv(t, 604800);
+	GPSTIME gt;
+	gt.wn = int(wn);
+	gt.tow.sn = long(t - wn * 604800);
+	gt.tow.tos = doy.tod.tos;
+	return gt;
+}
+DOY JulianDayToDOY(const JULIANDAY &jd) noexcept//儒略日到年积日的转换
+{
+	long long t = (long long)(jd.day - CIVIL_EPOCH_JD) * 86400 + jd.tod.sn - 43200;
+	long long days = FloorDiv(t, 86400);
+	int year, day;
+	DOYFromDays(days, &year, &day);
+	DOY doy;
+	doy.year = (unsigned short)year;
+	doy.day = (unsigned short)day;
+	doy.tod.sn = long(t - days * 86400);
+	doy.tod.tos = jd.tod.tos;
+	return doy;
+}
+JULIANDAY DOYToJulianDay(const DOY &doy) noexcept//年积日到儒略日的转换
+{
+	long long t = (DaysFromCivil(doy.year, 1, 1) + doy.day - 1) * 86400 + doy.tod.sn + 43200;
+	long long q = FloorDiv(t, 86400);
+	JULIANDAY jd;
+	jd.day = long(CIVIL_EPOCH_JD + q);
+	jd.tod.sn = long(t - q * 86400);
+	jd.tod.tos = doy.tod.tos;
+	return jd;
+}
+/*
+指针形式的接口保留以兼容原有调用，直接转调按值返回的版本。
+*/
+void CommonTimeToJulianDay(PCOMMONTIME pct, PJULIANDAY pjd) //通用时到儒略日的转换
+{
+	*pjd = CommonTimeToJulianDay(*pct);
 }
 void JulianDayToCommonTime(PJULIANDAY pjd, PCOMMONTIME pct)//儒略日到通用时的转换
 {
-	double x = pjd->day + (pjd->tod.sn + pjd->tod.tos) / (60.0*60.0 * 24);
-	int a = int(x + 0.5);
-	int b = a + 1537;
-	int c = int((b - 122.1) / 365.25);
-	int d = int(365.25*c);
-	int e = int((b - d) / 30.6001);
-	pct->day = b - d - int(30.6001*e);
-	pct->month = e - 1 - 12 * int(e / 14);
-	pct->year = c - 4715 - int((7 + pct->month) / 10);
-	pct->hour = (pjd->tod.sn / 3600 + 12) % 24;
-	pct->minute = (pjd->tod.sn % 3600) / 60;
-	pct->second = pjd->tod.sn % 60 + pjd->tod.tos;
-	int N = a % 7;
+	*pct = JulianDayToCommonTime(*pjd);
 }
 void JulianDayToGPSTime(PJULIANDAY pjd, PGPSTIME pgt)//儒略日到GPS时的转换
 {
-	double x = pjd->day + (pjd->tod.sn + pjd->tod.tos) / (60.0*60.0 * 24);
-	pgt->wn = int((x - 2444244.5) / 7);
-	pgt->tow.sn = int(((pjd->day - 2444244) % 7 + (pjd->tod.sn / (60.0*60.0 * 24) - 0.5)) * 86400);
-	pgt->tow.tos = pjd->tod.tos;
+	*pgt = JulianDayToGPSTime(*pjd);
 }
 void GPSTimeToJulianDay(PGPSTIME pgt, PJULIANDAY pjd)//GPS时到儒略日的转换
 {
-	pjd->day = int(pgt->wn * 7 + double(pgt->tow.sn) / 86400.0 + 2444244.5);
-	pjd->tod.sn = (pgt->tow.sn + 43200) % 86400;
-	pjd->tod.tos = pgt->tow.tos;
+	*pjd = GPSTimeToJulianDay(*pgt);
 }
 void CommonTimeToGPSTime(PCOMMONTIME pct, PGPSTIME pgt)//通用时到GPS时的转换
 {
-	PJULIANDAY pjd = new JULIANDAY;
-	CommonTimeToJulianDay(pct, pjd);
-	JulianDayToGPSTime(pjd, pgt);
+	*pgt = CommonTimeToGPSTime(*pct);
 }
 void GPSTimeToCommonTime(PGPSTIME pgt, PCOMMONTIME pct)//GPS时到通用时的转换
 {
-	PJULIANDAY pjd = new JULIANDAY;
-	GPSTimeToJulianDay(pgt, pjd);
-	JulianDayToCommonTime(pjd, pct);
+	*pct = GPSTimeToCommonTime(*pgt);
 }
 void CommonTimeToDOY(PCOMMONTIME pct, PDOY pdoy)
 {
-	PCOMMONTIME pcto = new COMMONTIME;
-	pcto->year = pct->year;
-	pcto->month = 1;
-	pcto->day = 1;
-	pcto->hour = 0;
-	pcto->minute = 0;
-	pcto->second = 0;
-
-	PJULIANDAY pjdo = new JULIANDAY;
-
-	double JD, JDO;
-	CommonTimeToJulianDay(pcto, pjdo);
-	JDO = pjdo->day + (pjdo->tod.sn + pjdo->tod.tos) / 86400;
-
-	PJULIANDAY pjd = new JULIANDAY;
-	CommonTimeToJulianDay(pct, pjd);
-
-	JD = pjd->day + (pjd->tod.sn + pjd->tod.tos) / 86400;
-
-	pdoy->day = short(JD - JDO + 1);
-	pdoy->year = pct->year;
-
-	pdoy->tod.sn = long(pct->hour * 3600
-		+ pct->minute * 60 + pct->second);
-	pdoy->tod.tos = pct->second - int(pct->second);    /*pct->hour*3600
-													   +pct->minute*60+pct->second-pdoy->tod.sn;*/
+	*pdoy = CommonTimeToDOY(*pct);
 }
 void DOYToCommonTime(PDOY pdoy, PCOMMONTIME pct)
 {
-	PCOMMONTIME pcto = new COMMONTIME;
-	pcto->year = pdoy->year;
-	pcto->month = 1;
-	pcto->day = 1;
-	pcto->hour = 0;
-	pcto->minute = 0;
-	pcto->second = 0;
-	PJULIANDAY pjdo = new JULIANDAY;
-	double JD, JDO;
-	CommonTimeToJulianDay(pcto, pjdo);
-	JDO = pjdo->day + (pjdo->tod.sn + pjdo->tod.tos) / 86400;
-	JD = JDO + pdoy->day + (pdoy->tod.sn + pdoy->tod.tos) / 86400 - 1;
-	long a, b, c, d, e;
-	a = (long)(JD + 0.5);
-	b = a + 1537;
-	c = (long)((b - 122.1) / 365.25);
-	d = (long)(365.25*c);
-	e = (long)((b - d) / 30.6001);
-	pct->day = short(b - d - (long)(30.6001*e) + FRAC(JD + 0.5));
-	pct->month = short(e - 1 - 12 * (long)(e / 14));
-	pct->year = short(c - 4715 - (long)((7 + pct->month) / 10));
-	pct->hour = short((pdoy->tod.sn + pdoy->tod.tos) / 3600);
-	pct->minute = short((pdoy->tod.sn + pdoy->tod.tos
-		- pct->hour * 3600) / 60);
-	pct->second = pdoy->tod.sn + pdoy->tod.tos
-		- pct->hour * 3600 - pct->minute * 60;
+	*pct = DOYToCommonTime(*pdoy);
 }
 void GPSTimeToDOY(PGPSTIME pgt, PDOY pdoy)
 {
-	PJULIANDAY pjd = new JULIANDAY;
-	GPSTimeToJulianDay(pgt, pjd);
-	PCOMMONTIME pct = new COMMONTIME;
-	JulianDayToCommonTime(pjd, pct);
-	CommonTimeToDOY(pct, pdoy);
+	*pdoy = GPSTimeToDOY(*pgt);
 }
 void DOYToGPSTime(PDOY pdoy, PGPSTIME pgt)
 {
-	PCOMMONTIME pct = new COMMONTIME;
-	DOYToCommonTime(pdoy, pct);
-	CommonTimeToGPSTime(pct, pgt);
+	*pgt = DOYToGPSTime(*pdoy);
 }
 void JulianDayToDOY(PJULIANDAY pjd, PDOY pdoy)
 {
-	PCOMMONTIME pct = new COMMONTIME;
-	JulianDayToCommonTime(pjd, pct);
-	CommonTimeToDOY(pct, pdoy);
+	*pdoy = JulianDayToDOY(*pjd);
 }
 void DOYToJulianDay(PDOY pdoy, PJULIANDAY pjd)
 {
-	PCOMMONTIME pct = new COMMONTIME;
-	DOYToCommonTime(pdoy, pct);
-	CommonTimeToJulianDay(pct, pjd);
+	*pjd = DOYToJulianDay(*pdoy);
 }
 void main()
 {
-	PCOMMONTIME pct = new COMMONTIME;
-	PJULIANDAY pjd = new JULIANDAY;
-	PDOY pdoy = new DOY;
-	PGPSTIME pgt = new GPSTIME;
-	pct->year = 2011;
-	pct->month = 1;
-	pct->day = 6;
-	pct->hour = 19;
-	pct->minute = 38;
-	pct->second = 45.26;
+	COMMONTIME ct;
+	JULIANDAY jd;
+	DOY doy;
+	GPSTIME gt;
+	ct.year = 2011;
+	ct.month = 1;
+	ct.day = 6;
+	ct.hour = 19;
+	ct.minute = 38;
+	ct.second = 45.26;
 	cout << "转换之前的通用时（当地时间）：";
-	cout << pct->year << " " << pct->month << " " << pct->day << " " << pct->hour << ":" << pct->minute << ":" << pct->second << endl;
+	cout << ct.year << " " << ct.month << " " << ct.day << " " << ct.hour << ":" << ct.minute << ":" << ct.second << endl;
 	cout << endl;
-	CommonTimeToJulianDay(pct, pjd);//通用时->儒略日的转换
+	jd = CommonTimeToJulianDay(ct);//通用时->儒略日的转换
 	cout << "通用时->儒略日的转换:";
-	cout << pjd->day << "  " << pjd->tod.sn << "  " << pjd->tod.tos << endl;
+	cout << jd.day << "  " << jd.tod.sn << "  " << jd.tod.tos << endl;
 	cout << endl;
-	JulianDayToCommonTime(pjd, pct);//儒略日->通用时的转换
+	ct = JulianDayToCommonTime(jd);//儒略日->通用时的转换
 	cout << "儒略日->通用时的转换:";
-	cout << pct->year << " " << pct->month << " " << pct->day << " " << pct->hour << ":" << pct->minute << ":" << pct->second << endl;
+	cout << ct.year << " " << ct.month << " " << ct.day << " " << ct.hour << ":" << ct.minute << ":" << ct.second << endl;
 	cout << endl;
-	JulianDayToGPSTime(pjd, pgt);//儒略日->GPS时的转换
+	gt = JulianDayToGPSTime(jd);//儒略日->GPS时的转换
 	cout << "儒略日->GPS时的转换:";
-	cout << pgt->wn << "  " << pgt->tow.sn << "  " << pgt->tow.tos << endl;
+	cout << gt.wn << "  " << gt.tow.sn << "  " << gt.tow.tos << endl;
 	cout << endl;
-	GPSTimeToJulianDay(pgt, pjd);//GPS时->儒略日的转换
+	jd = GPSTimeToJulianDay(gt);//GPS时->儒略日的转换
 	cout << "GPS时->儒略日的转换:";
-	cout << pjd->day << "  " << pjd->tod.sn << "  " << pjd->tod.tos << endl;
+	cout << jd.day << "  " << jd.tod.sn << "  " << jd.tod.tos << endl;
 	cout << endl;
-	CommonTimeToGPSTime(pct, pgt);//通用时->GPS时的转换
+	gt = CommonTimeToGPSTime(ct);//通用时->GPS时的转换
 	cout << "通用时->GPS时的转换:";
-	cout << pgt->wn << "  " << pgt->tow.sn << "  " << pgt->tow.tos << endl;
+	cout << gt.wn << "  " << gt.tow.sn << "  " << gt.tow.tos << endl;
 	cout << endl;
-	GPSTimeToCommonTime(pgt, pct);//GPS时->通用时的转换
+	ct = GPSTimeToCommonTime(gt);//GPS时->通用时的转换
 	cout << "GPS时->通用时的转换:";
-	cout << pct->year << " " << pct->month << " " << pct->day << " " << pct->hour << ":" << pct->minute << ":" << pct->second << endl;
+	cout << ct.year << " " << ct.month << " " << ct.day << " " << ct.hour << ":" << ct.minute << ":" << ct.second << endl;
 	cout << endl;
-	CommonTimeToDOY(pct, pdoy);//通用时->年积日
+	doy = CommonTimeToDOY(ct);//通用时->年积日
 	cout << "通用时->年积日:";
-	cout << pdoy->year << "  " << pdoy->day << "  " << pdoy->tod.sn << "  " << pdoy->tod.tos << endl;
+	cout << doy.year << "  " << doy.day << "  " << doy.tod.sn << "  " << doy.tod.tos << endl;
 	cout << endl;
-	DOYToCommonTime(pdoy, pct);//年积日->通用时
+	ct = DOYToCommonTime(doy);//年积日->通用时
 	cout << "年积日->通用时:";
-	cout << pct->year << " " << pct->month << " " << pct->day << " " << pct->hour << ":" << pct->minute << ":" << pct->second << endl;
+	cout << ct.year << " " << ct.month << " " << ct.day << " " << ct.hour << ":" << ct.minute << ":" << ct.second << endl;
 	cout << endl;
-	GPSTimeToDOY(pgt, pdoy);//GPS时->年积日
+	doy = GPSTimeToDOY(gt);//GPS时->年积日
 	cout << "GPS时->年积日:";
-	cout << pdoy->year << "  " << pdoy->day << "  " << pdoy->tod.sn << "  " << pdoy->tod.tos << endl;
+	cout << doy.year << "  " << doy.day << "  " << doy.tod.sn << "  " << doy.tod.tos << endl;
 	cout << endl;
-	DOYToGPSTime(pdoy, pgt);//年积日->GPS时
+	gt = DOYToGPSTime(doy);//年积日->GPS时
 	cout << "年积日->GPS时:";
-	cout << pgt->wn << "  " << pgt->tow.sn << "  " << pgt->tow.tos << endl;
+	cout << gt.wn << "  " << gt.tow.sn << "  " << gt.tow.tos << endl;
 	cout << endl;
-	JulianDayToDOY(pjd, pdoy);//儒略日->年积日
+	doy = JulianDayToDOY(jd);//儒略日->年积日
 	cout << "儒略日->年积日:";
-	cout << pdoy->year << "  " << pdoy->day << "  " << pdoy->tod.sn << "  " << pdoy->tod.tos << endl;
+	cout << doy.year << "  " << doy.day << "  " << doy.tod.sn << "  " << doy.tod.tos << endl;
 	cout << endl;
-	DOYToJulianDay(pdoy, pjd);//年积日->儒略日
+	jd = DOYToJulianDay(doy);//年积日->儒略日
 	cout << "年积日->儒略日:";
-	cout << pjd->day << "  " << pjd->tod.sn << "  " << pjd->tod.tos << endl;
+	cout << jd.day << "  " << jd.tod.sn << "  " << jd.tod.tos << endl;
 	cout << endl;
 	cout << "经过各种转换后还原得到的通用时:";
-	cout << pct->year << " " << pct->month << " " << pct->day << " " << pct->hour << ":" << pct->minute << ":" << pct->second << endl;
+	cout << ct.year << " " << ct.month << " " << ct.day << " " << ct.hour << ":" << ct.minute << ":" << ct.second << endl;
 	cout << endl;
 }
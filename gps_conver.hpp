@@ -0,0 +1,302 @@
+/*
+通用时、儒略日、简化儒略日、GPS时、年积日的强类型C++接口，只有头文件，需要C++14。
+每种时间是独立的类型，不能互相赋值或混用；所有转换都是constexpr，
+常量历元在编译期算出，运行时的调用内联为整数运算。
+Convert<目标类型>(时间)在编译期按源、目标类型选择转换路径：
+一般经自GPS起点起的秒数换算，儒略日与简化儒略日、通用时到年积日等有直接路径的不经过中间量。
+*/
+#ifndef GPS_CONVER_HPP
+#define GPS_CONVER_HPP
+namespace TimeConver
+{
+struct Seconds
+{
+	long sn;   //秒数的整数部分
+	double tos;//秒数的小数部分
+};
+struct CivilTime
+{
+	int year;
+	int month;
+	int day;
+	int hour;
+	int minute;
+	double second;
+};//通用时
+struct JulianDay
+{
+	long day;   //整数天数
+	Seconds tod;//正午起的天内秒数
+};//儒略日
+struct Mjd
+{
+	long day;
+	Seconds tod;//0时起的天内秒数
+};//简化儒略日
+struct GpsTime
+{
+	int wn;     //周数
+	Seconds tow;//一周内的秒数
+};//GPS时
+struct Doy
+{
+	int year;
+	int day;
+	Seconds tod;
+};//年积日
+constexpr long long DAY_SECONDS = 86400;
+constexpr long long WEEK_SECONDS = 604800;
+constexpr long long GPS_EPOCH_JD = 2444244;  //1980-01-06 0时所在儒略日的整数部分
+constexpr long long GPS_EPOCH_MJD = 44244;   //1980-01-06的简化儒略日
+constexpr long long GPS_EPOCH_DAYS = 3657;   //GPS起点相对1970-01-01的天数
+namespace Detail
+{
+struct Linear
+{
+	long long t;//自GPS起点起的秒数的整数部分
+	double tos; //秒数的小数部分
+};//各类型互相转换的公共中间量
+struct YearDay
+{
+	int year;
+	int day;
+};
+constexpr long long FloorDiv(long long a, long long b) noexcept//向下取整的整数除法(b>0)
+{
+	return a / b - (a % b < 0);
+}
+constexpr long long DaysFromCivil(long long year, int month, int day) noexcept//公历年月日到日数(1970-01-01为第0天)
+{
+	year -= month <= 2;
+	long long era = FloorDiv(year, 400);
+	long long yoe = year - era * 400;
+	long long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + doe - 719468;
+}
+constexpr CivilTime CivilFromDays(long long days) noexcept//日数到公历年月日，时分秒为0
+{
+	long long z = days + 719468;
+	long long era = FloorDiv(z, 146097);
+	long long doe = z - era * 146097;
+	long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	long long mp = (5 * doy + 2) / 153;
+	int month = int(mp < 10 ? mp + 3 : mp - 9);
+	return { int(yoe + era * 400 + (month <= 2)), month, int(doy - (153 * mp + 2) / 5 + 1), 0, 0, 0.0 };
+}
+constexpr YearDay DOYFromDays(long long days) noexcept//日数到年和年积日，不经过月日
+{
+	long long z = days + 719468;
+	long long era = FloorDiv(z, 146097);
+	long long doe = z - era * 146097;
+	long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);//从3月1日起算
+	long long year = yoe + era * 400;
+	bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+	if (doy >= 306)//次年1月、2月
+		return { int(year + 1), int(doy - 306 + 1) };
+	return { int(year), int(doy + 59 + leap + 1) };
+}
+constexpr int FullYear(int year) noexcept//两位数年份：80-99为19xx，00-79为20xx
+{
+	if (year >= 0 && year < 100)
+		return year < 80 ? year + 2000 : year + 1900;
+	return year;
+}
+constexpr bool SameTime(const Seconds &a, const Seconds &b) noexcept//各字段相同
+{
+	return a.sn == b.sn && a.tos == b.tos;
+}
+constexpr bool SameTime(const CivilTime &a, const CivilTime &b) noexcept
+{
+	return a.year == b.year && a.month == b.month && a.day == b.day && a.hour == b.hour && a.minute == b.minute
+		&& a.second == b.second;
+}
+constexpr bool SameTime(const JulianDay &a, const JulianDay &b) noexcept
+{
+	return a.day == b.day && SameTime(a.tod, b.tod);
+}
+constexpr bool SameTime(const Mjd &a, const Mjd &b) noexcept
+{
+	return a.day == b.day && SameTime(a.tod, b.tod);
+}
+constexpr bool SameTime(const Doy &a, const Doy &b) noexcept
+{
+	return a.year == b.year && a.day == b.day && SameTime(a.tod, b.tod);
+}
+}
+/*
+TimeTraits<T>给出类型T与公共中间量之间的换算，没有特化的类型不能参与转换。
+*/
+template<class T> struct TimeTraits;
+template<> struct TimeTraits<GpsTime>
+{
+	static constexpr Detail::Linear ToLinear(const GpsTime &gt) noexcept
+	{
+		return { (long long)gt.wn * WEEK_SECONDS + gt.tow.sn, gt.tow.tos };
+	}
+	static constexpr GpsTime FromLinear(const Detail::Linear &l) noexcept
+	{
+		long long wn = Detail::FloorDiv(l.t, WEEK_SECONDS);
+		return { int(wn), { long(l.t - wn * WEEK_SECONDS), l.tos } };
+	}
+};
+template<> struct TimeTraits<JulianDay>
+{
+	static constexpr Detail::Linear ToLinear(const JulianDay &jd) noexcept
+	{
+		return { (jd.day - GPS_EPOCH_JD) * DAY_SECONDS + jd.tod.sn - 43200, jd.tod.tos };
+	}
+	static constexpr JulianDay FromLinear(const Detail::Linear &l) noexcept
+	{
+		long long t = l.t + 43200;//自GPS起点前一日正午起的秒数
+		long long q = Detail::FloorDiv(t, DAY_SECONDS);
+		return { long(GPS_EPOCH_JD + q), { long(t - q * DAY_SECONDS), l.tos } };
+	}
+};
+template<> struct TimeTraits<Mjd>
+{
+	static constexpr Detail::Linear ToLinear(const Mjd &mjd) noexcept
+	{
+		return { (mjd.day - GPS_EPOCH_MJD) * DAY_SECONDS + mjd.tod.sn, mjd.tod.tos };
+	}
+	static constexpr Mjd FromLinear(const Detail::Linear &l) noexcept
+	{
+		long long q = Detail::FloorDiv(l.t, DAY_SECONDS);
+		return { long(GPS_EPOCH_MJD + q), { long(l.t - q * DAY_SECONDS), l.tos } };
+	}
+};
+template<> struct TimeTraits<Doy>
+{
+	static constexpr Detail::Linear ToLinear(const Doy &doy) noexcept
+	{
+		long long days = Detail::DaysFromCivil(Detail::FullYear(doy.year), 1, 1) + doy.day - 1;
+		return { (days - GPS_EPOCH_DAYS) * DAY_SECONDS + doy.tod.sn, doy.tod.tos };
+	}
+	static constexpr Doy FromLinear(const Detail::Linear &l) noexcept
+	{
+		long long q = Detail::FloorDiv(l.t, DAY_SECONDS);
+		Detail::YearDay yd = Detail::DOYFromDays(GPS_EPOCH_DAYS + q);
+		return { yd.year, yd.day, { long(l.t - q * DAY_SECONDS), l.tos } };
+	}
+};
+template<> struct TimeTraits<CivilTime>
+{
+	static constexpr Detail::Linear ToLinear(const CivilTime &ct) noexcept
+	{
+		int isec = int(ct.second);
+		long long days = Detail::DaysFromCivil(Detail::FullYear(ct.year), ct.month, ct.day);
+		return { (days - GPS_EPOCH_DAYS) * DAY_SECONDS + ct.hour * 3600 + ct.minute * 60 + isec, ct.second - isec };
+	}
+	static constexpr CivilTime FromLinear(const Detail::Linear &l) noexcept
+	{
+		long long q = Detail::FloorDiv(l.t, DAY_SECONDS);
+		long long sod = l.t - q * DAY_SECONDS;
+		CivilTime ct = Detail::CivilFromDays(GPS_EPOCH_DAYS + q);
+		ct.hour = int(sod / 3600);
+		ct.minute = int(sod % 3600 / 60);
+		ct.second = sod % 60 + l.tos;
+		return ct;
+	}
+};
+/*
+Converter<To, From>是From到To的转换路径，缺省经公共中间量，
+有更短路径的类型对在下面特化，编译期按类型选定，没有运行时分派。
+*/
+template<class To, class From> struct Converter
+{
+	static constexpr To Apply(const From &from) noexcept
+	{
+		return TimeTraits<To>::FromLinear(TimeTraits<From>::ToLinear(from));
+	}
+};
+template<class T> struct Converter<T, T>
+{
+	static constexpr T Apply(const T &from) noexcept
+	{
+		return from;
+	}
+};
+template<> struct Converter<Mjd, JulianDay>//天数差2400000.5，天内秒超出一天时进位到天数
+{
+	static constexpr Mjd Apply(const JulianDay &jd) noexcept
+	{
+		long long t = jd.tod.sn + 43200LL;//自儒略日前一日正午起的秒数
+		long long q = Detail::FloorDiv(t, DAY_SECONDS);
+		return { long(jd.day - 2400001 + q), { long(t - q * DAY_SECONDS), jd.tod.tos } };
+	}
+};
+template<> struct Converter<JulianDay, Mjd>
+{
+	static constexpr JulianDay Apply(const Mjd &mjd) noexcept
+	{
+		long long t = mjd.tod.sn + 43200LL;
+		long long q = Detail::FloorDiv(t, DAY_SECONDS);
+		return { long(mjd.day + 2400000 + q), { long(t - q * DAY_SECONDS), mjd.tod.tos } };
+	}
+};
+template<> struct Converter<Doy, CivilTime>//同一年内只换算年积日和天内秒，时分秒超出一天时进位到日期
+{
+	static constexpr Doy Apply(const CivilTime &ct) noexcept
+	{
+		int year = Detail::FullYear(ct.year);
+		int isec = int(ct.second);
+		long long sod = ct.hour * 3600LL + ct.minute * 60 + isec;
+		long long q = Detail::FloorDiv(sod, DAY_SECONDS);
+		long long start = Detail::DaysFromCivil(year, 1, 1);
+		long long days = Detail::DaysFromCivil(year, ct.month, ct.day) + q;
+		if (days < start || days >= Detail::DaysFromCivil(year + 1, 1, 1))
+		{
+			Detail::YearDay yd = Detail::DOYFromDays(days);
+			return { yd.year, yd.day, { long(sod - q * DAY_SECONDS), ct.second - isec } };
+		}
+		return { year, int(days - start + 1), { long(sod - q * DAY_SECONDS), ct.second - isec } };
+	}
+};
+template<> struct Converter<CivilTime, Doy>
+{
+	static constexpr CivilTime Apply(const Doy &doy) noexcept
+	{
+		long long q = Detail::FloorDiv(doy.tod.sn, DAY_SECONDS);
+		long long sod = doy.tod.sn - q * DAY_SECONDS;
+		CivilTime ct = Detail::CivilFromDays(Detail::DaysFromCivil(Detail::FullYear(doy.year), 1, 1) + doy.day - 1 + q);
+		ct.hour = int(sod / 3600);
+		ct.minute = int(sod % 3600 / 60);
+		ct.second = sod % 60 + doy.tod.tos;
+		return ct;
+	}
+};
+template<class To, class From> constexpr To Convert(const From &from) noexcept//From到To的转换
+{
+	return Converter<To, From>::Apply(from);
+}
+//编译期核对GPS起点
+static_assert(Convert<JulianDay>(GpsTime{ 0, { 0, 0.0 } }).day == GPS_EPOCH_JD
+	&& Convert<JulianDay>(GpsTime{ 0, { 0, 0.0 } }).tod.sn == 43200, "GPS epoch JD");
+static_assert(Convert<Mjd>(CivilTime{ 1980, 1, 6, 0, 0, 0.0 }).day == GPS_EPOCH_MJD, "GPS epoch MJD");
+static_assert(Convert<GpsTime>(Doy{ 1980, 6, { 0, 0.0 } }).wn == 0, "GPS epoch DOY");
+//编译期核对直接路径: 天内秒、时分秒超出一天或为负时与经公共中间量的结果相同
+namespace Detail
+{
+template<class To, class From> constexpr bool SameAsLinear(const From &from) noexcept
+{
+	return Detail::SameTime(Convert<To>(from), TimeTraits<To>::FromLinear(TimeTraits<From>::ToLinear(from)));
+}
+}
+static_assert(Convert<CivilTime>(Doy{ 2011, 1, { 90000, 0.0 } }).day == 2
+	&& Convert<CivilTime>(Doy{ 2011, 1, { 90000, 0.0 } }).hour == 1, "DOY sod overflow");
+static_assert(Convert<JulianDay>(Mjd{ 55567, { 90000, 0.0 } }).day == 2455568
+	&& Convert<JulianDay>(Mjd{ 55567, { 90000, 0.0 } }).tod.sn == 46800, "MJD sod overflow");
+static_assert(Detail::SameAsLinear<CivilTime>(Doy{ 2011, 365, { 86400, 0.5 } })
+	&& Detail::SameAsLinear<CivilTime>(Doy{ 2012, 1, { -1, 0.0 } })
+	&& Detail::SameAsLinear<CivilTime>(Doy{ 11, 59, { 3 * DAY_SECONDS + 5, 0.0 } }), "DOY to civil");
+static_assert(Detail::SameAsLinear<Doy>(CivilTime{ 2011, 12, 31, 24, 0, 0.0 })
+	&& Detail::SameAsLinear<Doy>(CivilTime{ 2012, 1, 1, 0, 0, -1.0 })
+	&& Detail::SameAsLinear<Doy>(CivilTime{ 2012, 2, 28, 47, 59, 60.0 }), "civil to DOY");
+static_assert(Detail::SameAsLinear<JulianDay>(Mjd{ 55567, { 200000, 0.0 } })
+	&& Detail::SameAsLinear<JulianDay>(Mjd{ 55567, { -3600, 0.0 } })
+	&& Detail::SameAsLinear<Mjd>(JulianDay{ 2455567, { 90000, 0.0 } })
+	&& Detail::SameAsLinear<Mjd>(JulianDay{ 2455567, { -50000, 0.0 } }), "JD and MJD");
+}
+#endif
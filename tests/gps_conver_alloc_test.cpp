@@ -0,0 +1,92 @@
+/*
+gps_conver.cpp的零堆分配测试：替换全局operator new/delete计数，
+反复调用全部24个转换入口(12个按值返回、12个指针形式)，有任何堆分配即失败。
+编译运行：
+	g++ -O2 -o gps_conver_alloc_test tests/gps_conver_alloc_test.cpp && ./gps_conver_alloc_test
+*/
+#include<cstdio>
+#include<cstdlib>
+#include<new>
+#define main gps_conver_demo//只使用转换函数，不运行演示程序
+#include "../gps_conver.cpp"
+#undef main
+static unsigned long g_allocs = 0;//operator new的调用次数
+void *operator new(std::size_t size)
+{
+	g_allocs++;
+	void *p = std::malloc(size ? size : 1);
+	if (p == NULL)
+		throw std::bad_alloc();
+	return p;
+}
+void *operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+void operator delete[](void *p) noexcept
+{
+	std::free(p);
+}
+void operator delete(void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+void operator delete[](void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+static volatile long g_sink;//防止转换结果被优化掉
+int main()
+{
+	const int ROUNDS = 100000;
+	COMMONTIME ct = { 2011, 1, 6, 19, 38, 45.26 };
+	JULIANDAY jd;
+	GPSTIME gt;
+	DOY doy;
+	unsigned long before = g_allocs;
+	for (int i = 0; i < ROUNDS; i++)
+	{
+		ct.day = 1 + i % 28;
+		ct.second = (i % 6000) / 100.0;
+		//按值返回的12个入口
+		jd = CommonTimeToJulianDay(ct);
+		ct = JulianDayToCommonTime(jd);
+		gt = JulianDayToGPSTime(jd);
+		jd = GPSTimeToJulianDay(gt);
+		gt = CommonTimeToGPSTime(ct);
+		ct = GPSTimeToCommonTime(gt);
+		doy = CommonTimeToDOY(ct);
+		ct = DOYToCommonTime(doy);
+		doy = GPSTimeToDOY(gt);
+		gt = DOYToGPSTime(doy);
+		doy = JulianDayToDOY(jd);
+		jd = DOYToJulianDay(doy);
+		//指针形式的12个入口
+		CommonTimeToJulianDay(&ct, &jd);
+		JulianDayToCommonTime(&jd, &ct);
+		JulianDayToGPSTime(&jd, &gt);
+		GPSTimeToJulianDay(&gt, &jd);
+		CommonTimeToGPSTime(&ct, &gt);
+		GPSTimeToCommonTime(&gt, &ct);
+		CommonTimeToDOY(&ct, &doy);
+		DOYToCommonTime(&doy, &ct);
+		GPSTimeToDOY(&gt, &doy);
+		DOYToGPSTime(&doy, &gt);
+		JulianDayToDOY(&jd, &doy);
+		DOYToJulianDay(&doy, &jd);
+		g_sink += jd.day + gt.wn + doy.day + ct.year;
+	}
+	unsigned long allocs = g_allocs - before;
+	printf("%d rounds x 24 conversions: %lu heap allocations\n", ROUNDS, allocs);
+	if (allocs != 0)
+	{
+		printf("FAIL\n");
+		return 1;
+	}
+	printf("PASS\n");
+	return 0;
+}
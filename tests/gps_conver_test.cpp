@@ -0,0 +1,56 @@
+/*
+gps_conver.hpp直接转换路径的测试：随机的儒略日、简化儒略日、年积日、通用时
+(天内秒、时分秒超出一天或为负，含两位数年份)经直接特化转换的结果，
+必须与经公共中间量(自GPS起点起的秒数)转换的结果逐字段相同。
+编译运行：
+	g++ -std=c++14 -O2 -o gps_conver_test tests/gps_conver_test.cpp && ./gps_conver_test
+*/
+#include<cstdio>
+#include<cstdint>
+#include "../gps_conver.hpp"
+using namespace TimeConver;
+static const int TEST_ROUNDS = 1000000;
+static uint64_t TestRand(uint64_t &state)
+{
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return state * 2685821657736338717ULL;
+}
+static long TestSod(uint64_t &state)//一半在当天内，一半在前后两天内
+{
+	uint64_t r = TestRand(state);
+	if (r & 1)
+		return long(r >> 1 & 0xffffff) % DAY_SECONDS;
+	return long(r >> 1 & 0xffffff) % (4 * DAY_SECONDS) - 2 * DAY_SECONDS;
+}
+template<class To, class From> static bool TestSame(const From &from)
+{
+	return Detail::SameTime(Convert<To>(from), TimeTraits<To>::FromLinear(TimeTraits<From>::ToLinear(from)));
+}
+int main()
+{
+	uint64_t state = 20110106ULL;
+	unsigned long mismatch = 0;
+	for (int i = 0; i < TEST_ROUNDS; i++)
+	{
+		double tos = double(TestRand(state) % 1000) / 1e3;
+		int year = i % 5 == 0 ? int(TestRand(state) % 100) : 1980 + int(TestRand(state) % 60);
+		long day = 44244 + long(TestRand(state) % 25000);
+		Doy doy = { year, 1 + int(TestRand(state) % 366), { TestSod(state), tos } };
+		Mjd mjd = { day, { TestSod(state), tos } };
+		JulianDay jd = { day + 2400000, { TestSod(state), tos } };
+		uint64_t r = TestRand(state);
+		CivilTime ct = { year, 1 + int(r % 12), 1 + int(r >> 8 & 0xff) % 28, int(r >> 16 & 0xff) % 96 - 24,
+			int(r >> 24 & 0xff) % 60, double((r >> 32 & 0xff) % 61) + tos };
+		if (!TestSame<CivilTime>(doy) || !TestSame<Doy>(ct) || !TestSame<JulianDay>(mjd) || !TestSame<Mjd>(jd))
+		{
+			if (mismatch++ < 5)
+				printf("doy %d %d %ld, mjd %ld %ld, jd %ld %ld, civil %d-%d-%d %d:%d:%g\n", doy.year, doy.day, doy.tod.sn,
+					mjd.day, mjd.tod.sn, jd.day, jd.tod.sn, ct.year, ct.month, ct.day, ct.hour, ct.minute, ct.second);
+		}
+	}
+	printf("%lu mismatches\n", mismatch);
+	puts(mismatch ? "FAIL" : "PASS");
+	return mismatch ? 1 : 0;
+}
@@ -0,0 +1,67 @@
+/*
+gps_conver.cpp的取值测试：两位数年份(00-79为20xx，80-99为19xx)在通用时到儒略日、GPS时、年积日
+三个入口中一致补全，闰年的年积日按补全后的年份计算；随机的四位和两位数年份通用时经CommonTimeToDOY
+的结果与经GPS时换算(GPSTimeToDOY(CommonTimeToGPSTime))的结果相同。
+编译运行：
+	g++ -O2 -o gps_conver_value_test tests/gps_conver_value_test.cpp && ./gps_conver_value_test
+*/
+#include<cstdio>
+#include<cstdint>
+#define main gps_conver_demo//只使用转换函数，不运行演示程序
+#include "../gps_conver.cpp"
+#undef main
+static uint64_t TestRand(uint64_t &state)
+{
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return state * 2685821657736338717ULL;
+}
+static bool SameDOY(const DOY &a, const DOY &b)
+{
+	return a.year == b.year && a.day == b.day && a.tod.sn == b.tod.sn && a.tod.tos == b.tod.tos;
+}
+int main()
+{
+	const int ROUNDS = 1000000;
+	static const int MonthDays[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	unsigned long mismatch = 0;
+	//固定用例：11-03-01为2011年第60天，12-03-01为闰年2012年第61天，99-12-31为1999年第365天
+	DOY doy = CommonTimeToDOY(COMMONTIME{ 11, 3, 1, 1, 0, 0.5 });
+	if (doy.year != 2011 || doy.day != 60 || doy.tod.sn != 3600)
+		mismatch++;
+	doy = CommonTimeToDOY(COMMONTIME{ 12, 3, 1, 0, 0, 0.0 });
+	if (doy.year != 2012 || doy.day != 61)
+		mismatch++;
+	doy = CommonTimeToDOY(COMMONTIME{ 99, 12, 31, 0, 0, 0.0 });
+	if (doy.year != 1999 || doy.day != 365)
+		mismatch++;
+	if (CommonTimeToJulianDay(COMMONTIME{ 11, 1, 6, 0, 0, 0.0 }).day != CommonTimeToJulianDay(COMMONTIME{ 2011, 1, 6, 0, 0, 0.0 }).day
+		|| CommonTimeToGPSTime(COMMONTIME{ 80, 1, 6, 0, 0, 0.0 }).wn != 0)
+		mismatch++;
+	if (mismatch)
+		printf("fixed cases: %lu mismatches\n", mismatch);
+	uint64_t state = 20110106ULL;
+	for (int i = 0; i < ROUNDS; i++)
+	{
+		COMMONTIME ct;
+		ct.year = i % 2 ? int(TestRand(state) % 100) : 1980 + int(TestRand(state) % 120);
+		ct.month = 1 + int(TestRand(state) % 12);
+		int days = MonthDays[ct.month - 1] + (ct.month == 2 && IsLeapYear(FullYear(ct.year)));
+		ct.day = 1 + int(TestRand(state) % days);
+		ct.hour = int(TestRand(state) % 24);
+		ct.minute = int(TestRand(state) % 60);
+		ct.second = double(TestRand(state) % 60) + double(TestRand(state) % 1000) / 1e3;
+		DOY direct = CommonTimeToDOY(ct);
+		DOY viaGps = GPSTimeToDOY(CommonTimeToGPSTime(ct));
+		if (!SameDOY(direct, viaGps))
+		{
+			if (mismatch++ < 5)
+				printf("%d-%d-%d %d:%d:%g -> %u %u, via gps %u %u\n", ct.year, ct.month, ct.day, ct.hour, ct.minute,
+					ct.second, direct.year, direct.day, viaGps.year, viaGps.day);
+		}
+	}
+	printf("%lu mismatches\n", mismatch);
+	puts(mismatch ? "FAIL" : "PASS");
+	return mismatch ? 1 : 0;
+}
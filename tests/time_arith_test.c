@@ -0,0 +1,282 @@
+/*
+ * 时间间隔运算测试: 随机GPS时(一半落在天、周、年边界前后)换算为五种表示后,
+ *     各表示直接求差、比较的结果与纳秒时间之差一致; 批量加秒后与先加秒再换算的结果一致;
+ *     就地筛选保留的记录与逐条比较一致; 通用时、年积日规格化和年积日求差总是把两位年份补全为四位;
+ *     年积日加秒超出100-65535年时返回-1且原值不变, 批处理输出年积日时按行号报告超出范围的记录.
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_arith_test tests/time_arith_test.c && ./time_arith_test
+ */
+#define main time_conver_main       //只使用运算函数, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_INPUTS         (100000)
+#define TEST_TOLERANCE      (1e-6)      //秒小数之差、通用时的double秒都有舍入
+
+static time_convert_ctx_t g_a[TEST_INPUTS], g_b[TEST_INPUTS];
+static common_time_t g_ct[TEST_INPUTS];
+static julianday_t g_jd[TEST_INPUTS];
+static gps_time_t g_gt[TEST_INPUTS];
+static doy_t g_doy[TEST_INPUTS];
+static new_julianday_t g_mjd[TEST_INPUTS];
+static double g_diff[TEST_INPUTS];
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+static void test_fill(time_convert_ctx_t *pc, const gps_time_t *pgt)
+{
+    pc->gt = *pgt;
+    time_conver_gpstime_to_commontime(pgt, &pc->ct);
+    time_conver_gpstime_to_julianday(pgt, &pc->jd);
+    time_conver_gpstime_to_doy(pgt, &pc->doy);
+    time_conver_gpstime_to_mjd(pgt, &pc->mjd);
+}
+
+static double test_ns_seconds(const gps_time_t *pa, const gps_time_t *pb)
+{
+    time_ns_t a, b;
+
+    time_conver_gpstime_to_ns(pa, &a);
+    time_conver_gpstime_to_ns(pb, &b);
+
+    return (double)(a - b) / 1e9;
+}
+
+static bool test_near(double a, double b)
+{
+    return a - b < TEST_TOLERANCE && b - a < TEST_TOLERANCE;
+}
+
+//随机GPS时, 一半在2000-2040年各年1月1日0时前后一天内
+static void test_random(uint64_t *pstate, gps_time_t *pgt, size_t i)
+{
+    common_time_t ct = { 2000 + (int)(test_rand(pstate) % 40), 1, 1, 0, 0, 0.0 };
+
+    if (i & 1) {
+        pgt->wn = 1000 + (int)(test_rand(pstate) % 2000);
+        pgt->tow.sn = (long)(test_rand(pstate) % ONE_WEEK_SECONDS);
+    } else {
+        time_conver_commontime_to_gpstime(&ct, pgt);
+        pgt->tow.sn += (long)(test_rand(pstate) % (2 * ONE_DAY_SECONDS)) - ONE_DAY_SECONDS;
+        time_gpstime_normalize(pgt);
+    }
+    pgt->tow.tos = (double)(test_rand(pstate) % 1000) / 1e3;
+}
+
+static bool test_same_doy(const doy_t *pdoy, unsigned short year, unsigned short day, long sn, double tos)
+{
+    return pdoy->year == year && pdoy->day == day && pdoy->tod.sn == sn && pdoy->tod.tos == tos;
+}
+
+/*
+ * 年积日: 两位年份在规格化和求差中补全; 加秒超出100-65535年时返回-1且原值不变;
+ * 批处理输出年积日时, 平移后超出范围的第1、3行(约公元前13万年、191万年后)按行号报告, 第2行照常输出.
+ */
+static size_t test_doy_range(void)
+{
+    static const char text[] = "-7000000 0\n1617 1.5\n100000000 0\n";
+    doy_t a, b;
+    gps_time_t gt;
+    time_batch_ctx_t ctx;
+    char out[256], want[64];
+    size_t mismatch = 0;
+    size_t len;
+    FILE *fp;
+
+    a = (doy_t){ 11, 6, { 70724, 0.5 } };
+    mismatch += time_doy_add(&a, 1.0) != 0 || !test_same_doy(&a, 2011, 6, 70725, 0.5);
+    a = (doy_t){ 99, 365, { 86399, 0.5 } };
+    mismatch += time_doy_add(&a, 0.5) != 0 || !test_same_doy(&a, 2000, 1, 0, 0.0);
+    a = (doy_t){ 20, 60, { 0, 0.0 } };
+    b = (doy_t){ 2020, 60, { 0, 0.0 } };
+    mismatch += time_doy_diff(&a, &b) != 0.0 || time_doy_cmp(&a, &b) != 0;
+
+    //上界: 65535年最后一秒的后半秒
+    a = (doy_t){ 65535, 365, { 86399, 0.25 } };
+    mismatch += time_doy_add(&a, 0.5) != 0 || !test_same_doy(&a, 65535, 365, 86399, 0.75);
+    mismatch += time_doy_add(&a, 0.25) != -1 || !test_same_doy(&a, 65535, 365, 86399, 0.75);
+    //下界: 200年元旦向前100年(含24个闰年)为100年元旦, 再往前的年份会被当作两位年份
+    a = (doy_t){ 200, 1, { 0, 0.0 } };
+    mismatch += time_doy_add(&a, -36524.0 * ONE_DAY_SECONDS) != 0 || !test_same_doy(&a, 100, 1, 0, 0.0);
+    mismatch += time_doy_add(&a, -0.5) != -1 || !test_same_doy(&a, 100, 1, 0, 0.0);
+    //一次换算约12.7万年, 不逐年循环
+    a = (doy_t){ 2011, 2, { 0, 0.0 } };
+    mismatch += time_doy_add(&a, -4e12) != -1 || !test_same_doy(&a, 2011, 2, 0, 0.0);
+    mismatch += time_doy_add(&a, 1e12) != 0 || a.year != 33699;
+    if (mismatch) {
+        printf("doy: %zu\n", mismatch);
+    }
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.from = TIME_GPS;
+    ctx.to[0] = TIME_doy_t;
+    ctx.nto = 1;
+    ctx.fmt = TIME_FMT_CSV;
+    ctx.nthread = 1;
+    ctx.shift = -1e9;
+    ctx.pb = malloc(sizeof(*ctx.pb));
+    ctx.out = malloc((size_t)TIME_BATCH_RECORDS * TIME_MAX * (TIME_FMT_TIME_MAX + 1));
+    fp = tmpfile();
+    if (ctx.pb == NULL || ctx.out == NULL || fp == NULL) {
+        printf("doy batch: no memory\n");
+        return mismatch + 1;
+    }
+    ctx.pb->n = 0;
+    ctx.out_fd = fileno(fp);
+
+    if (time_batch_feed(&ctx, text, sizeof(text) - 1, true) != sizeof(text) - 1 || time_batch_flush(&ctx) != 0) {
+        printf("doy batch: failed\n");
+        mismatch++;
+    }
+    rewind(fp);
+    len = fread(out, 1, sizeof(out) - 1, fp);
+    out[len] = '\0';
+
+    gt = (gps_time_t){ 1617, { 1, 0.5 } };
+    time_gpstime_add(&gt, ctx.shift);
+    time_conver_gpstime_to_doy(&gt, &a);
+    snprintf(want, sizeof(want), "%u,%u,%ld.5\n", a.year, a.day, a.tod.sn);
+    if (ctx.errors != 2 || strcmp(out, want) != 0) {
+        printf("doy batch: %zu errors, %s", ctx.errors, out);
+        mismatch++;
+    }
+
+    fclose(fp);
+    free(ctx.pb);
+    free(ctx.out);
+
+    return mismatch;
+}
+
+int main(void)
+{
+    static const double secs[] = { 30.0, -30.0, 0.75, -86400.5, 604800.25, 31536000.0, 1.5e9, -1.5e9 };
+    uint64_t state = 20110106ULL;
+    common_time_t ct;
+    gps_time_t gt, lo, hi;
+    time_convert_ctx_t want;
+    size_t i, k, n, mismatch = 0;
+    double d;
+
+    //两位年份: 在月内和跨月都补全为四位
+    ct = (common_time_t){ 11, 1, 6, 19, 38, 44.5 };
+    time_commontime_add(&ct, 1.0);
+    if (ct.year != 2011 || ct.month != 1 || ct.day != 6) {
+        printf("normalize: %d-%d-%d\n", ct.year, ct.month, ct.day);
+        mismatch++;
+    }
+    ct = (common_time_t){ 99, 12, 31, 23, 59, 59.5 };
+    time_commontime_add(&ct, 1.0);
+    if (ct.year != 2000 || ct.month != 1 || ct.day != 1) {
+        printf("normalize: %d-%d-%d\n", ct.year, ct.month, ct.day);
+        mismatch++;
+    }
+
+    mismatch += test_doy_range();
+
+    for (i = 0; i < TEST_INPUTS; i++) {
+        test_random(&state, &gt, i);
+        test_fill(&g_a[i], &gt);
+        test_random(&state, &gt, i);
+        test_fill(&g_b[i], &gt);
+    }
+
+    //求差、比较
+    for (i = 0; i < TEST_INPUTS; i++) {
+        d = test_ns_seconds(&g_a[i].gt, &g_b[i].gt);
+        if (!test_near(time_commontime_diff(&g_a[i].ct, &g_b[i].ct), d)
+            || !test_near(time_julianday_diff(&g_a[i].jd, &g_b[i].jd), d)
+            || !test_near(time_gpstime_diff(&g_a[i].gt, &g_b[i].gt), d)
+            || !test_near(time_doy_diff(&g_a[i].doy, &g_b[i].doy), d)
+            || !test_near(time_mjd_diff(&g_a[i].mjd, &g_b[i].mjd), d)
+            || time_commontime_cmp(&g_a[i].ct, &g_b[i].ct) != (d > 0) - (d < 0)
+            || time_julianday_cmp(&g_a[i].jd, &g_b[i].jd) != (d > 0) - (d < 0)
+            || time_gpstime_cmp(&g_a[i].gt, &g_b[i].gt) != (d > 0) - (d < 0)
+            || time_doy_cmp(&g_a[i].doy, &g_b[i].doy) != (d > 0) - (d < 0)
+            || time_mjd_cmp(&g_a[i].mjd, &g_b[i].mjd) != (d > 0) - (d < 0)) {
+            if (mismatch++ < 5) {
+                printf("diff: gps %d %ld - %d %ld\n", g_a[i].gt.wn, g_a[i].gt.tow.sn, g_b[i].gt.wn, g_b[i].gt.tow.sn);
+            }
+        }
+    }
+
+    for (i = 0; i < TEST_INPUTS; i++) {
+        g_ct[i] = g_b[i].ct;
+    }
+    time_commontime_diff_batch(g_ct, g_ct + 1, g_diff, TEST_INPUTS - 1);
+    for (i = 0; i + 1 < TEST_INPUTS; i++) {
+        if (!test_near(g_diff[i], test_ns_seconds(&g_b[i].gt, &g_b[i + 1].gt))) {
+            if (mismatch++ < 5) {
+                printf("diff_batch: %zu\n", i);
+            }
+        }
+    }
+
+    //批量加秒与先对GPS时加秒再换算比较
+    for (k = 0; k < sizeof(secs) / sizeof(secs[0]); k++) {
+        for (i = 0; i < TEST_INPUTS; i++) {
+            g_ct[i] = g_a[i].ct;
+            g_jd[i] = g_a[i].jd;
+            g_gt[i] = g_a[i].gt;
+            g_doy[i] = g_a[i].doy;
+            g_mjd[i] = g_a[i].mjd;
+        }
+        time_commontime_add_batch(g_ct, secs[k], TEST_INPUTS);
+        time_julianday_add_batch(g_jd, secs[k], TEST_INPUTS);
+        time_gpstime_add_batch(g_gt, secs[k], TEST_INPUTS);
+        time_doy_add_batch(g_doy, secs[k], TEST_INPUTS);
+        time_mjd_add_batch(g_mjd, secs[k], TEST_INPUTS);
+        for (i = 0; i < TEST_INPUTS; i++) {
+            gt = g_a[i].gt;
+            time_gpstime_add(&gt, secs[k]);
+            test_fill(&want, &gt);
+            if (g_gt[i].wn != gt.wn || g_gt[i].tow.sn != gt.tow.sn || g_gt[i].tow.tos != gt.tow.tos
+                || g_ct[i].year != want.ct.year || g_ct[i].month != want.ct.month || g_ct[i].day != want.ct.day
+                || g_ct[i].hour != want.ct.hour || g_ct[i].minute != want.ct.minute
+                || !test_near(g_ct[i].second, want.ct.second)
+                || g_jd[i].day != want.jd.day || g_jd[i].tod.sn != want.jd.tod.sn
+                || g_doy[i].year != want.doy.year || g_doy[i].day != want.doy.day || g_doy[i].tod.sn != want.doy.tod.sn
+                || g_mjd[i].day != want.mjd.day || g_mjd[i].tod.sn != want.mjd.tod.sn) {
+                if (mismatch++ < 5) {
+                    printf("add %g: gps %d %ld\n", secs[k], g_a[i].gt.wn, g_a[i].gt.tow.sn);
+                }
+            }
+        }
+    }
+
+    //就地筛选[lo, hi)
+    lo.wn = 1500;
+    lo.tow.sn = 0;
+    lo.tow.tos = 0.0;
+    hi.wn = 2500;
+    hi.tow.sn = 302400;
+    hi.tow.tos = 0.5;
+    for (i = 0, k = 0; i < TEST_INPUTS; i++) {
+        g_gt[i] = g_a[i].gt;
+        if (time_gpstime_cmp(&g_gt[i], &lo) >= 0 && time_gpstime_cmp(&g_gt[i], &hi) < 0) {
+            k++;
+        }
+    }
+    n = time_gpstime_select(g_gt, TEST_INPUTS, &lo, &hi, NULL);
+    for (i = 0; i < n; i++) {
+        if (time_gpstime_cmp(&g_gt[i], &lo) < 0 || time_gpstime_cmp(&g_gt[i], &hi) >= 0) {
+            break;
+        }
+    }
+    if (n != k || i != n) {
+        printf("select: %zu of %zu\n", n, k);
+        mismatch++;
+    }
+
+    printf("%zu mismatches\n", mismatch);
+    puts(mismatch ? "FAIL" : "PASS");
+
+    return mismatch ? 1 : 0;
+}
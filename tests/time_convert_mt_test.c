@@ -0,0 +1,157 @@
+/*
+ * time_convert多线程压力测试: TEST_THREADS个线程同时开始(包括首次调用时的转换计划初始化),
+ *     各自持有time_convert_ctx_t, 按不同的起点轮流执行25种state, 结果必须与单线程逐条转换相同.
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_convert_mt_test tests/time_convert_mt_test.c && ./time_convert_mt_test
+ */
+#define main time_conver_main       //只使用转换函数, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_THREADS        (8)
+#define TEST_INPUTS         (2048)
+#define TEST_ROUNDS         (20)
+#define TEST_STATES         (TIME_MJD_TO_ALL + 1)
+
+static time_convert_ctx_t g_input[TEST_INPUTS];             //每条输入的五种表示
+static time_convert_ctx_t g_first[TEST_THREADS][TEST_STATES];   //各线程第一轮(与计划初始化并发)的结果
+static time_convert_ctx_t g_expect[TEST_INPUTS][TEST_STATES];
+static pthread_barrier_t g_start;
+static size_t g_mismatch[TEST_THREADS];
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+//随机GPS时(一半落在天、周边界前后2秒内)及由它换算出的其余四种表示
+static void test_generate(void)
+{
+    uint64_t state = 20110106ULL;
+    time_convert_ctx_t *pin;
+    size_t i;
+
+    for (i = 0; i < TEST_INPUTS; i++) {
+        pin = &g_input[i];
+        pin->gt.wn = (int)(test_rand(&state) % 3000);
+        if (i & 1) {
+            pin->gt.tow.sn = (long)(test_rand(&state) % ONE_WEEK_SECONDS);
+        } else {
+            pin->gt.tow.sn = (long)((test_rand(&state) % 7) * ONE_DAY_SECONDS + ONE_WEEK_SECONDS - 2
+                + test_rand(&state) % 4) % ONE_WEEK_SECONDS;
+        }
+        pin->gt.tow.tos = (double)(test_rand(&state) % 1000000) / 1e6;
+        time_conver_gpstime_to_commontime(&pin->gt, &pin->ct);
+        time_conver_gpstime_to_julianday(&pin->gt, &pin->jd);
+        time_conver_gpstime_to_doy(&pin->gt, &pin->doy);
+        time_conver_gpstime_to_mjd(&pin->gt, &pin->mjd);
+    }
+}
+
+//state的源时间
+static const void *test_source(const time_convert_ctx_t *pin, int state)
+{
+    static const size_t offset[TIME_MAX] = {
+        offsetof(time_convert_ctx_t, ct), offsetof(time_convert_ctx_t, jd), offsetof(time_convert_ctx_t, gt),
+        offsetof(time_convert_ctx_t, doy), offsetof(time_convert_ctx_t, mjd)
+    };
+    int from, to;
+
+    time_plan_state(state, &from, &to);
+
+    return (const char *)pin + offset[from];
+}
+
+static void test_run(time_convert_ctx_t *pctx, size_t i, int state)
+{
+    memset(pctx, 0, sizeof(*pctx));
+    time_convert(pctx, test_source(&g_input[i], state), state);
+}
+
+static bool test_equal(const time_convert_ctx_t *a, const time_convert_ctx_t *b)
+{
+    return a->ct.year == b->ct.year && a->ct.month == b->ct.month && a->ct.day == b->ct.day
+        && a->ct.hour == b->ct.hour && a->ct.minute == b->ct.minute && a->ct.second == b->ct.second
+        && a->jd.day == b->jd.day && a->jd.tod.sn == b->jd.tod.sn && a->jd.tod.tos == b->jd.tod.tos
+        && a->gt.wn == b->gt.wn && a->gt.tow.sn == b->gt.tow.sn && a->gt.tow.tos == b->gt.tow.tos
+        && a->doy.year == b->doy.year && a->doy.day == b->doy.day
+        && a->doy.tod.sn == b->doy.tod.sn && a->doy.tod.tos == b->doy.tod.tos
+        && a->mjd.day == b->mjd.day && a->mjd.tod.sn == b->mjd.tod.sn && a->mjd.tod.tos == b->mjd.tod.tos;
+}
+
+static void *test_worker(void *arg)
+{
+    int id = (int)(intptr_t)arg;
+    time_convert_ctx_t ctx;
+    size_t i, k;
+    int round, state;
+
+    //第一轮: 所有线程同时调用, 首次调用触发转换计划的初始化
+    pthread_barrier_wait(&g_start);
+    for (state = 0; state < TEST_STATES; state++) {
+        test_run(&g_first[id][state], (size_t)id, (state + id) % TEST_STATES);
+    }
+    pthread_barrier_wait(&g_start);     //第一轮结束
+    pthread_barrier_wait(&g_start);     //等待主线程算出单线程结果
+
+    for (round = 0; round < TEST_ROUNDS; round++) {
+        for (k = 0; k < TEST_INPUTS; k++) {
+            i = (k * 7 + (size_t)id * 131 + (size_t)round) % TEST_INPUTS;
+            for (state = 0; state < TEST_STATES; state++) {
+                test_run(&ctx, i, (state + id + round) % TEST_STATES);
+                if (!test_equal(&ctx, &g_expect[i][(state + id + round) % TEST_STATES])) {
+                    g_mismatch[id]++;
+                }
+            }
+        }
+    }
+
+    return NULL;
+}
+
+int main(void)
+{
+    pthread_t tid[TEST_THREADS];
+    size_t i, mismatch = 0;
+    int id, state;
+
+    test_generate();
+    pthread_barrier_init(&g_start, NULL, TEST_THREADS + 1);
+    for (id = 0; id < TEST_THREADS; id++) {
+        if (pthread_create(&tid[id], NULL, test_worker, (void *)(intptr_t)id) != 0) {
+            puts("FAIL");
+            return 1;
+        }
+    }
+
+    pthread_barrier_wait(&g_start);
+    pthread_barrier_wait(&g_start);     //各线程的第一轮结束后再算单线程结果
+    for (i = 0; i < TEST_INPUTS; i++) {
+        for (state = 0; state < TEST_STATES; state++) {
+            test_run(&g_expect[i][state], i, state);
+        }
+    }
+    for (id = 0; id < TEST_THREADS; id++) {
+        for (state = 0; state < TEST_STATES; state++) {
+            if (!test_equal(&g_first[id][state], &g_expect[id][(state + id) % TEST_STATES])) {
+                mismatch++;
+            }
+        }
+    }
+    pthread_barrier_wait(&g_start);
+
+    for (id = 0; id < TEST_THREADS; id++) {
+        pthread_join(tid[id], NULL);
+        mismatch += g_mismatch[id];
+    }
+    pthread_barrier_destroy(&g_start);
+
+    printf("%zu mismatches in %d threads x %d rounds\n", mismatch, TEST_THREADS, TEST_ROUNDS);
+    puts(mismatch ? "FAIL" : "PASS");
+
+    return mismatch ? 1 : 0;
+}
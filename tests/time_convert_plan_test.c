@@ -0,0 +1,175 @@
+/*
+ * 转换规划测试: 五种源类型的随机时间(通用时含两位年份和时分秒超出一天, 其余含天内秒、周内秒超出范围或为负,
+ *     秒小数含0和接近1的值)按25种state经time_convert规划的转换树转换, 每个目标必须与对应的直接转换函数
+ *     time_conver_*_to_*的结果逐位相同; 源指向pctx中的成员(就地转换)时结果也相同.
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_convert_plan_test tests/time_convert_plan_test.c && ./time_convert_plan_test
+ */
+#define main time_conver_main       //只使用转换函数, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_INPUTS         (200000)
+#define TEST_STATES         (TIME_MJD_TO_ALL + 1)
+
+static time_convert_ctx_t g_input[TEST_INPUTS];
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+//秒小数: 常见值之外含0和最接近1的double
+static double test_tos(uint64_t *pstate)
+{
+    switch (test_rand(pstate) % 4) {
+    case 0:
+        return 0.0;
+    case 1:
+        return 0.99999999999999989;
+    default:
+        return (double)(test_rand(pstate) % 1000000) / 1e6;
+    }
+}
+
+//天内秒: 多数在一天内, 其余在前后一天内
+static long test_sod(uint64_t *pstate)
+{
+    if (test_rand(pstate) % 4) {
+        return (long)(test_rand(pstate) % ONE_DAY_SECONDS);
+    }
+
+    return (long)(test_rand(pstate) % (3 * ONE_DAY_SECONDS)) - ONE_DAY_SECONDS;
+}
+
+//五种源时间各自独立生成, 不要求彼此对应
+static void test_generate(void)
+{
+    static const int mdays[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    uint64_t state = 20110106ULL;
+    time_convert_ctx_t *pin;
+    size_t i;
+
+    for (i = 0; i < TEST_INPUTS; i++) {
+        pin = &g_input[i];
+
+        pin->ct.year = (i % 5 == 0) ? (int)(test_rand(&state) % 100) : 1980 + (int)(test_rand(&state) % 60);
+        pin->ct.month = 1 + (int)(test_rand(&state) % 12);
+        pin->ct.day = 1 + (int)(test_rand(&state) % (unsigned)mdays[pin->ct.month - 1]);
+        pin->ct.hour = (i % 7 == 0) ? 24 : (int)(test_rand(&state) % ONE_DAY_HOURS);
+        pin->ct.minute = (int)(test_rand(&state) % ONE_HOUR_MINUTES);
+        pin->ct.second = (double)(test_rand(&state) % (ONE_MINUTE_SECONDS + 1)) + test_tos(&state);
+
+        pin->jd.day = 2444244 + (long)(test_rand(&state) % 22000);
+        pin->jd.tod.sn = test_sod(&state);
+        pin->jd.tod.tos = test_tos(&state);
+
+        pin->gt.wn = (int)(test_rand(&state) % 3000);
+        pin->gt.tow.sn = (long)(test_rand(&state) % (ONE_WEEK_SECONDS + ONE_DAY_SECONDS));
+        pin->gt.tow.tos = test_tos(&state);
+
+        pin->doy.year = (unsigned short)(1980 + test_rand(&state) % 60);
+        pin->doy.day = (unsigned short)(1 + test_rand(&state) % 366);
+        pin->doy.tod.sn = test_sod(&state);
+        pin->doy.tod.tos = test_tos(&state);
+
+        pin->mjd.day = 44244 + (long)(test_rand(&state) % 22000);
+        pin->mjd.tod.sn = test_sod(&state);
+        pin->mjd.tod.tos = test_tos(&state);
+    }
+}
+
+//直接转换: 源为pin中from类型的成员, 结果写入pout中to类型的成员
+static void test_direct(const time_convert_ctx_t *pin, int from, int to, time_convert_ctx_t *pout)
+{
+    switch (from * TIME_MAX + to) {
+    case TIME_COMMON * TIME_MAX + TIME_JULIAN: time_conver_commontime_to_julianday(&pin->ct, &pout->jd); break;
+    case TIME_COMMON * TIME_MAX + TIME_GPS: time_conver_commontime_to_gpstime(&pin->ct, &pout->gt); break;
+    case TIME_COMMON * TIME_MAX + TIME_doy_t: time_conver_commontime_to_doy(&pin->ct, &pout->doy); break;
+    case TIME_COMMON * TIME_MAX + TIME_MJD: time_conver_commontime_to_mjd(&pin->ct, &pout->mjd); break;
+    case TIME_JULIAN * TIME_MAX + TIME_COMMON: time_conver_julianday_to_commontime(&pin->jd, &pout->ct); break;
+    case TIME_JULIAN * TIME_MAX + TIME_GPS: time_conver_julianday_to_gpstime(&pin->jd, &pout->gt); break;
+    case TIME_JULIAN * TIME_MAX + TIME_doy_t: time_conver_julianday_to_doy(&pin->jd, &pout->doy); break;
+    case TIME_JULIAN * TIME_MAX + TIME_MJD: time_conver_julianday_to_mjd(&pin->jd, &pout->mjd); break;
+    case TIME_GPS * TIME_MAX + TIME_COMMON: time_conver_gpstime_to_commontime(&pin->gt, &pout->ct); break;
+    case TIME_GPS * TIME_MAX + TIME_JULIAN: time_conver_gpstime_to_julianday(&pin->gt, &pout->jd); break;
+    case TIME_GPS * TIME_MAX + TIME_doy_t: time_conver_gpstime_to_doy(&pin->gt, &pout->doy); break;
+    case TIME_GPS * TIME_MAX + TIME_MJD: time_conver_gpstime_to_mjd(&pin->gt, &pout->mjd); break;
+    case TIME_doy_t * TIME_MAX + TIME_COMMON: time_conver_doy_to_commontime(&pin->doy, &pout->ct); break;
+    case TIME_doy_t * TIME_MAX + TIME_JULIAN: time_conver_doy_to_julianday(&pin->doy, &pout->jd); break;
+    case TIME_doy_t * TIME_MAX + TIME_GPS: time_conver_doy_to_gpstime(&pin->doy, &pout->gt); break;
+    case TIME_doy_t * TIME_MAX + TIME_MJD: time_conver_doy_to_mjd(&pin->doy, &pout->mjd); break;
+    case TIME_MJD * TIME_MAX + TIME_COMMON: time_conver_mjd_to_commontime(&pin->mjd, &pout->ct); break;
+    case TIME_MJD * TIME_MAX + TIME_JULIAN: time_conver_mjd_to_julianday(&pin->mjd, &pout->jd); break;
+    case TIME_MJD * TIME_MAX + TIME_GPS: time_conver_mjd_to_gpstime(&pin->mjd, &pout->gt); break;
+    case TIME_MJD * TIME_MAX + TIME_doy_t: time_conver_mjd_to_doy(&pin->mjd, &pout->doy); break;
+    default: break;
+    }
+}
+
+//type类型的成员逐字段相同
+static bool test_equal(const time_convert_ctx_t *a, const time_convert_ctx_t *b, int type)
+{
+    switch (type) {
+    case TIME_COMMON:
+        return a->ct.year == b->ct.year && a->ct.month == b->ct.month && a->ct.day == b->ct.day
+            && a->ct.hour == b->ct.hour && a->ct.minute == b->ct.minute && a->ct.second == b->ct.second;
+    case TIME_JULIAN:
+        return a->jd.day == b->jd.day && a->jd.tod.sn == b->jd.tod.sn && a->jd.tod.tos == b->jd.tod.tos;
+    case TIME_GPS:
+        return a->gt.wn == b->gt.wn && a->gt.tow.sn == b->gt.tow.sn && a->gt.tow.tos == b->gt.tow.tos;
+    case TIME_doy_t:
+        return a->doy.year == b->doy.year && a->doy.day == b->doy.day
+            && a->doy.tod.sn == b->doy.tod.sn && a->doy.tod.tos == b->doy.tod.tos;
+    default:
+        return a->mjd.day == b->mjd.day && a->mjd.tod.sn == b->mjd.tod.sn && a->mjd.tod.tos == b->mjd.tod.tos;
+    }
+}
+
+int main(void)
+{
+    static const size_t offset[TIME_MAX] = {
+        offsetof(time_convert_ctx_t, ct), offsetof(time_convert_ctx_t, jd), offsetof(time_convert_ctx_t, gt),
+        offsetof(time_convert_ctx_t, doy), offsetof(time_convert_ctx_t, mjd)
+    };
+    time_convert_ctx_t ctx, inplace, want;
+    size_t i, mismatch = 0;
+    int state, from, to, type;
+
+    test_generate();
+    for (i = 0; i < TEST_INPUTS; i++) {
+        for (state = 0; state < TEST_STATES; state++) {
+            time_plan_state(state, &from, &to);
+            memset(&ctx, 0, sizeof(ctx));
+            memset(&want, 0, sizeof(want));
+            time_convert(&ctx, (const char *)&g_input[i] + offset[from], state);
+            inplace = g_input[i];
+            time_convert(&inplace, (const char *)&inplace + offset[from], state);
+
+            for (type = 0; type < TIME_MAX; type++) {
+                if (type == from ? to != TIME_MAX : to != TIME_MAX && to != type) {
+                    continue;
+                }
+                if (type == from) {
+                    want = g_input[i];
+                } else {
+                    test_direct(&g_input[i], from, type, &want);
+                }
+                if (!test_equal(&ctx, &want, type) || !test_equal(&inplace, &want, type)) {
+                    if (mismatch++ < 5) {
+                        printf("state %d input %zu: type %d\n", state, i, type);
+                    }
+                }
+            }
+        }
+    }
+
+    printf("%zu mismatches\n", mismatch);
+    puts(mismatch ? "FAIL" : "PASS");
+
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,357 @@
+/*
+ * 历元差分编码测试: 0.05秒和1秒等间隔、不规则间隔、时间倒退、跨周(含GPS起点之前)五组历元
+ *     按不等长分批编码, 编码流与一次编码逐字节相同, 等间隔数据流只有一个游程;
+ *     以不同的每次解码个数解出的GPS时还原原历元, 同时解出的通用时、儒略日、年积日与单点转换逐字段相同;
+ *     在每个字节处截断的编码流只在完整的游程边界处能解码, 损坏的首历元、游程、varint都被拒绝,
+ *     命令行解码路径报告"corrupt delta stream".
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_delta_test tests/time_delta_test.c && ./time_delta_test
+ */
+#define main time_conver_main       //只使用编码、解码函数, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_EPOCHS         (100000)
+#define TEST_SETS           (5)
+
+static time_ns_t g_ns[TEST_EPOCHS];
+static uint8_t g_enc[TIME_DELTA_BOUND(TEST_EPOCHS)];
+static uint8_t g_once[TIME_DELTA_BOUND(TEST_EPOCHS)];
+static gps_time_t g_gt[TEST_EPOCHS];
+static common_time_t g_ct[TEST_EPOCHS];
+static julianday_t g_jd[TEST_EPOCHS];
+static doy_t g_doy[TEST_EPOCHS];
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+//第k组历元, 返回个数
+static size_t test_fill(int k, uint64_t *pstate)
+{
+    time_ns_t start = 2086LL * TIME_NS_PER_WEEK + 302400LL * TIME_NS_PER_SECOND + 123456789;
+    size_t i, n = TEST_EPOCHS;
+
+    g_ns[0] = (k == TEST_SETS - 1) ? -TIME_NS_PER_WEEK - TIME_NS_PER_SECOND : start;
+    for (i = 1; i < n; i++) {
+        switch (k) {
+            case 0:     //10Hz的一半: 0.05秒等间隔
+                g_ns[i] = g_ns[i - 1] + TIME_NS_PER_SECOND / 20;
+                break;
+            case 1:     //1秒等间隔, 跨一周多
+                g_ns[i] = g_ns[i - 1] + TIME_NS_PER_SECOND;
+                break;
+            case 2:     //不规则间隔: 0-60秒的任意纳秒数, 偶尔连续几条等间隔
+                g_ns[i] = g_ns[i - 1] + ((i % 7 < 3) ? TIME_NS_PER_SECOND
+                    : (time_ns_t)(test_rand(pstate) % (60 * TIME_NS_PER_SECOND)));
+                break;
+            case 3:     //时间倒退: 一半的差为负
+                g_ns[i] = g_ns[i - 1] + (time_ns_t)(test_rand(pstate) % (20 * TIME_NS_PER_SECOND))
+                    - 10 * TIME_NS_PER_SECOND;
+                break;
+            default:    //跨周: 从GPS起点前一周的周末前1秒开始每隔0.25秒, 每1000条间隔多1纳秒
+                g_ns[i] = g_ns[i - 1] + TIME_NS_PER_SECOND / 4 + ((i % 1000 == 0) ? 1 : 0);
+                break;
+        }
+    }
+
+    return n;
+}
+
+//按1-3000条不等长分批编码, 返回编码流长度
+static size_t test_encode(const time_ns_t *pns, size_t n, uint8_t *out, uint64_t *pstate)
+{
+    time_delta_encoder_t enc;
+    size_t i, k, len = 0;
+
+    time_delta_encoder_init(&enc);
+    for (i = 0; i < n; i += k) {
+        k = (pstate != NULL) ? 1 + (size_t)(test_rand(pstate) % 3000) : n;
+        if (k > n - i) {
+            k = n - i;
+        }
+        len += time_delta_encode(&enc, pns + i, k, out + len);
+    }
+
+    return len + time_delta_finish(&enc, out + len);
+}
+
+//v的varint字节数
+static size_t test_varint_len(uint64_t v)
+{
+    uint8_t buf[TIME_DELTA_VARINT_MAX];
+
+    return (size_t)(time_delta_put_varint(buf, v) - buf);
+}
+
+//每次至多解码cap个, 与原历元及其单点转换比较; all为假时不要通用时
+static size_t test_decode(const uint8_t *data, size_t len, size_t n, size_t cap, bool all)
+{
+    time_delta_decoder_t dec;
+    common_time_t ct;
+    julianday_t jd;
+    doy_t doy;
+    gps_time_t gt;
+    size_t mismatch = 0;
+    size_t i = 0, k, got;
+
+    time_delta_decoder_init(&dec, data, len);
+    for (;;) {
+        if (time_delta_decode(&dec, g_gt + i, all ? g_ct + i : NULL, g_jd + i, g_doy + i, cap, &got) != 0) {
+            printf("decode: failed at epoch %zu\n", i);
+            return mismatch + 1;
+        }
+        if (got == 0) {
+            break;
+        }
+        if (got > cap || i + got > n) {
+            printf("decode: %zu epochs\n", i + got);
+            return mismatch + 1;
+        }
+        i += got;
+    }
+    if (i != n) {
+        printf("decode: %zu of %zu epochs\n", i, n);
+        mismatch++;
+    }
+
+    for (k = 0; k < i; k++) {
+        time_conver_ns_to_gpstime(&g_ns[k], &gt);
+        time_conver_gpstime_to_commontime(&gt, &ct);
+        time_conver_gpstime_to_julianday(&gt, &jd);
+        time_conver_gpstime_to_doy(&gt, &doy);
+        if (g_gt[k].wn != gt.wn || g_gt[k].tow.sn != gt.tow.sn || g_gt[k].tow.tos != gt.tow.tos
+            || (all && (g_ct[k].year != ct.year || g_ct[k].month != ct.month || g_ct[k].day != ct.day
+                || g_ct[k].hour != ct.hour || g_ct[k].minute != ct.minute || g_ct[k].second != ct.second))
+            || g_jd[k].day != jd.day || g_jd[k].tod.sn != jd.tod.sn || g_jd[k].tod.tos != jd.tod.tos
+            || g_doy[k].year != doy.year || g_doy[k].day != doy.day || g_doy[k].tod.sn != doy.tod.sn
+            || g_doy[k].tod.tos != doy.tod.tos) {
+            if (mismatch++ < 5) {
+                printf("decode: epoch %zu: gps %d %ld.%09lld\n", k, gt.wn, gt.tow.sn,
+                    time_ns_from_tos(gt.tow.tos));
+            }
+        }
+    }
+
+    return mismatch;
+}
+
+//解码到流末尾, 返回time_delta_decode的结果, 解出的个数写入*pn
+static int test_decode_all(const uint8_t *data, size_t len, size_t *pn)
+{
+    time_delta_decoder_t dec;
+    size_t got;
+    int rv;
+
+    *pn = 0;
+    time_delta_decoder_init(&dec, data, len);
+    do {
+        rv = time_delta_decode(&dec, g_gt, NULL, NULL, NULL, 4096, &got);
+        *pn += got;
+    } while (rv == 0 && got > 0);
+
+    return rv;
+}
+
+/*
+ * 在每个字节处截断: 只有截在首历元之后、完整的(差值, 个数)对之间时能解码, 解出截断处之前的历元;
+ * 其余位置(varint中间、一对中间)都返回-1.
+ */
+static size_t test_truncate(const uint8_t *data, size_t len)
+{
+    const uint8_t *p = data;
+    const uint8_t *end = data + len;
+    size_t mismatch = 0;
+    size_t cut, n;
+    size_t next;            //下一个完整边界的字节数
+    size_t count = 1;       //截在next处时可解出的历元数
+    uint64_t v1, v2;
+    int rv;
+
+    p = time_delta_get_varint(p, end, &v1);
+    p = time_delta_get_varint(p, end, &v2);
+    next = (size_t)(p - data);
+    for (cut = 0; cut < len; cut++) {
+        while (cut > next) {
+            p = time_delta_get_varint(p, end, &v1);
+            p = (p != NULL) ? time_delta_get_varint(p, end, &v2) : NULL;
+            if (p == NULL) {
+                next = (size_t)-1;  //最后一对跨过了len, 之后没有完整边界
+                break;
+            }
+            count += (size_t)v2;
+            next = (size_t)(p - data);
+        }
+        rv = test_decode_all(data, cut, &n);
+        if ((cut == 0 && (rv != 0 || n != 0)) || (cut == next && (rv != 0 || n != count))
+            || (cut != 0 && cut != next && rv != -1)) {
+            if (mismatch++ < 5) {
+                printf("truncate %zu of %zu: %d, %zu epochs\n", cut, len, rv, n);
+            }
+        }
+    }
+
+    return mismatch;
+}
+
+//首历元(周数, 周内纳秒数)加上一个游程(差值, 个数)的编码流, 返回长度
+static size_t test_stream(uint8_t *buf, int64_t wn, uint64_t tow, int64_t delta, uint64_t count)
+{
+    uint8_t *p = buf;
+
+    p = time_delta_put_varint(p, time_delta_zigzag(wn));
+    p = time_delta_put_varint(p, tow);
+    p = time_delta_put_varint(p, time_delta_zigzag(delta));
+    p = time_delta_put_varint(p, count);
+
+    return (size_t)(p - buf);
+}
+
+//损坏的编码流都返回-1, 对照的正常编码流可以解码
+static size_t test_corrupt(void)
+{
+    uint8_t buf[4 * TIME_DELTA_VARINT_MAX + 2];
+    size_t mismatch = 0;
+    size_t len, n;
+    int k;
+
+    len = test_stream(buf, 2086, 0, TIME_NS_PER_SECOND, 3);
+    if (test_decode_all(buf, len, &n) != 0 || n != 4) {
+        printf("corrupt: valid stream rejected\n");
+        mismatch++;
+    }
+
+    for (k = 0; k < 7; k++) {
+        switch (k) {
+            case 0:     //周内纳秒数等于一周
+                len = test_stream(buf, 2086, TIME_NS_PER_WEEK, TIME_NS_PER_SECOND, 3);
+                break;
+            case 1:     //周数乘一周的纳秒数超出int64
+                len = test_stream(buf, INT64_MAX / TIME_NS_PER_WEEK + 1, 0, TIME_NS_PER_SECOND, 3);
+                break;
+            case 2:
+                len = test_stream(buf, INT64_MIN / TIME_NS_PER_WEEK - 1, 0, TIME_NS_PER_SECOND, 3);
+                break;
+            case 3:     //游程的个数为0
+                len = test_stream(buf, 2086, 0, TIME_NS_PER_SECOND, 0);
+                break;
+            case 4:     //首历元只有周数
+                len = (size_t)(time_delta_put_varint(buf, time_delta_zigzag(2086)) - buf);
+                break;
+            case 5:     //游程只有差值
+                len = test_stream(buf, 2086, 0, TIME_NS_PER_SECOND, 3) - 1;
+                break;
+            default:    //超过10字节的varint
+                len = test_stream(buf, 2086, 0, TIME_NS_PER_SECOND, 3);
+                memset(buf + len, 0x80, TIME_DELTA_VARINT_MAX);
+                buf[len + TIME_DELTA_VARINT_MAX] = 0x01;
+                buf[len + TIME_DELTA_VARINT_MAX + 1] = 0x01;
+                len += TIME_DELTA_VARINT_MAX + 2;
+                break;
+        }
+        if (test_decode_all(buf, len, &n) != -1) {
+            printf("corrupt %d accepted\n", k);
+            mismatch++;
+        }
+    }
+
+    return mismatch;
+}
+
+//命令行解码路径: 截断的编码流返回-2并报告"corrupt delta stream"
+static size_t test_scan(const uint8_t *data, size_t len)
+{
+    time_batch_ctx_t ctx;
+    char msg[256];
+    size_t mismatch = 0;
+    FILE *out, *err;
+    int saved, rv;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.nto = 1;
+    ctx.to[0] = TIME_GPS;
+    ctx.fmt = TIME_FMT_CSV;
+    ctx.pb = malloc(sizeof(*ctx.pb));
+    ctx.out = malloc((size_t)TIME_BATCH_RECORDS * (TIME_FMT_TIME_MAX + 1));
+    out = tmpfile();
+    err = tmpfile();
+    if (ctx.pb == NULL || ctx.out == NULL || out == NULL || err == NULL) {
+        printf("scan: no memory\n");
+        return 1;
+    }
+    ctx.pb->n = 0;
+    ctx.out_fd = fileno(out);
+
+    fflush(stderr);
+    saved = dup(STDERR_FILENO);
+    dup2(fileno(err), STDERR_FILENO);
+    rv = time_delta_scan(&ctx, (const char *)data, len - 1);
+    fflush(stderr);
+    dup2(saved, STDERR_FILENO);
+    close(saved);
+
+    rewind(err);
+    msg[0] = '\0';
+    if (fgets(msg, sizeof(msg), err) == NULL || strstr(msg, "corrupt delta stream") == NULL || rv != -2) {
+        printf("scan: %d: %s\n", rv, msg);
+        mismatch++;
+    }
+
+    fclose(out);
+    fclose(err);
+    free(ctx.pb);
+    free(ctx.out);
+
+    return mismatch;
+}
+
+int main(void)
+{
+    static const size_t caps[] = { 1, 7, 4096, TEST_EPOCHS };
+    uint64_t state = 20110106ULL;
+    size_t mismatch = 0;
+    size_t n, len, once, runs;
+    size_t c;
+    int k;
+
+    for (k = 0; k < TEST_SETS; k++) {
+        n = test_fill(k, &state);
+        len = test_encode(g_ns, n, g_enc, &state);
+        once = test_encode(g_ns, n, g_once, NULL);
+        if (len != once || memcmp(g_enc, g_once, len) != 0) {
+            printf("set %d: chunked stream differs (%zu, %zu bytes)\n", k, len, once);
+            mismatch++;
+        }
+
+        //等间隔数据流: 首历元之后只有一个游程
+        if (k <= 1) {
+            runs = test_varint_len(time_delta_zigzag(time_floor_div(g_ns[0], TIME_NS_PER_WEEK)))
+                + test_varint_len((uint64_t)(g_ns[0] - time_floor_div(g_ns[0], TIME_NS_PER_WEEK) * TIME_NS_PER_WEEK))
+                + test_varint_len(time_delta_zigzag(g_ns[1] - g_ns[0])) + test_varint_len(n - 1);
+            if (len != runs) {
+                printf("set %d: %zu bytes, want %zu\n", k, len, runs);
+                mismatch++;
+            }
+        }
+
+        for (c = 0; c < sizeof(caps) / sizeof(caps[0]); c++) {
+            mismatch += test_decode(g_enc, len, n, caps[c], c != 1);
+        }
+        if (k >= 2) {
+            mismatch += test_truncate(g_enc, (len < 4096) ? len : 4096);
+        }
+    }
+
+    mismatch += test_corrupt();
+    mismatch += test_scan(g_enc, len);
+
+    printf("%zu mismatches\n", mismatch);
+    puts(mismatch ? "FAIL" : "PASS");
+
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,411 @@
+/*
+ * 历元文件测试: 跨年末的约3块历元(50ms间隔, 夹杂跳变和时间倒退)按不等长分批写入,
+ *     四种可选列组合读回的ns、GPS周和周内纳秒、年和年积日列与单点换算逐条相同, 块索引的最小、最大值正确;
+ *     范围外的数据块改写为范围内的值后按[since, until)输出, 结果与逐条筛选相同(证明按块索引整块跳过);
+ *     截断或损坏的头部、块索引都被拒绝.
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_epoch_test tests/time_epoch_test.c && ./time_epoch_test
+ */
+#define main time_conver_main       //只使用历元文件读写和批处理输出, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_EPOCHS         (2 * TIME_EPOCH_BLOCK_RECORDS + 1234)
+#define TEST_SMALL          (100)
+
+static time_ns_t g_ns[TEST_EPOCHS];
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+//2019-12-31 23:30起50ms间隔, 约千分之一的历元跳变0-10秒, 约万分之一倒退1秒
+static void test_fill(uint64_t *pstate)
+{
+    common_time_t ct = { 2019, 12, 31, 23, 30, 0.0 };
+    uint64_t v;
+    size_t i;
+
+    time_conver_commontime_to_ns(&ct, &g_ns[0]);
+    for (i = 1; i < TEST_EPOCHS; i++) {
+        v = test_rand(pstate);
+        g_ns[i] = g_ns[i - 1] + TIME_NS_PER_SECOND / 20;
+        if (v % 1000 == 0) {
+            g_ns[i] += (time_ns_t)(v >> 20) % (10 * TIME_NS_PER_SECOND);
+        } else if (v % 10000 == 1) {
+            g_ns[i] -= TIME_NS_PER_SECOND;
+        }
+    }
+}
+
+//临时文件路径写入path, 返回0
+static int test_temp(char *path, size_t len)
+{
+    int fd;
+
+    snprintf(path, len, "/tmp/time_epoch_test_XXXXXX");
+    fd = mkstemp(path);
+    if (fd < 0) {
+        return -1;
+    }
+    close(fd);
+
+    return 0;
+}
+
+//按1-5000条不等长分批写入前n条历元
+static int test_write(const char *path, uint32_t columns, size_t n, uint64_t *pstate)
+{
+    time_epoch_writer_t writer;
+    size_t i, k;
+
+    if (time_epoch_writer_open(&writer, path, columns) != 0) {
+        return -1;
+    }
+    for (i = 0; i < n; i += k) {
+        k = 1 + (size_t)(test_rand(pstate) % 5000);
+        if (k > n - i) {
+            k = n - i;
+        }
+        if (time_epoch_writer_add(&writer, &g_ns[i], k) != 0) {
+            time_epoch_writer_close(&writer);
+            return -1;
+        }
+    }
+
+    return time_epoch_writer_close(&writer);
+}
+
+//读回全部数据块, 与写入的历元及其单点换算逐条比较
+static size_t test_read(const char *path, uint32_t columns)
+{
+    time_epoch_reader_t reader;
+    time_epoch_block_t blk;
+    time_ns_t lo, hi;
+    gps_time_t gt;
+    doy_t doy;
+    size_t mismatch = 0;
+    size_t b, k, i = 0;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0 || time_epoch_reader_open(&reader, fd) != 0) {
+        printf("read %u: cannot open\n", columns);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return 1;
+    }
+    if (reader.hdr->count != TEST_EPOCHS || reader.hdr->nblocks != 3 || reader.hdr->columns != columns) {
+        printf("read %u: %llu epochs in %llu blocks\n", columns, (unsigned long long)reader.hdr->count,
+            (unsigned long long)reader.hdr->nblocks);
+        mismatch++;
+    }
+
+    for (b = 0; b < reader.hdr->nblocks; b++) {
+        time_epoch_reader_block(&reader, b, &blk);
+        if ((blk.tow != NULL) != ((columns & TIME_EPOCH_COL_GPS) != 0) || (blk.wn != NULL) != (blk.tow != NULL)
+            || (blk.doy != NULL) != ((columns & TIME_EPOCH_COL_DOY) != 0)) {
+            printf("read %u: block %zu columns\n", columns, b);
+            mismatch++;
+            break;
+        }
+
+        lo = g_ns[i];
+        hi = g_ns[i];
+        for (k = 0; k < blk.n && i < TEST_EPOCHS; k++, i++) {
+            lo = (g_ns[i] < lo) ? g_ns[i] : lo;
+            hi = (g_ns[i] > hi) ? g_ns[i] : hi;
+            time_conver_ns_to_gpstime(&g_ns[i], &gt);
+            time_conver_ns_to_doy(&g_ns[i], &doy);
+            if (blk.ns[k] != g_ns[i]
+                || (blk.tow != NULL && (blk.wn[k] != gt.wn
+                    || blk.tow[k] != (int64_t)gt.tow.sn * TIME_NS_PER_SECOND + time_ns_from_tos(gt.tow.tos)))
+                || (blk.doy != NULL && (blk.doy[k].year != doy.year || blk.doy[k].day != doy.day))) {
+                if (mismatch++ < 5) {
+                    printf("read %u: epoch %zu\n", columns, i);
+                }
+            }
+        }
+        if (k != blk.n || blk.min_ns != lo || blk.max_ns != hi) {
+            printf("read %u: block %zu: %zu epochs, min/max\n", columns, b, blk.n);
+            mismatch++;
+        }
+    }
+    if (i != TEST_EPOCHS) {
+        printf("read %u: %zu epochs\n", columns, i);
+        mismatch++;
+    }
+
+    time_epoch_reader_close(&reader);
+    close(fd);
+
+    return mismatch;
+}
+
+//按[since, until)输出GPS时文本, 读回后与逐条筛选的历元比较
+static size_t test_range(const char *path, time_ns_t since, time_ns_t until)
+{
+    time_batch_ctx_t ctx;
+    char line[TIME_BATCH_LINE_MAX];
+    size_t mismatch = 0;
+    size_t i = 0;
+    double tow;
+    FILE *fp;
+    int fd, wn;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.nto = 1;
+    ctx.to[0] = TIME_GPS;
+    ctx.fmt = TIME_FMT_CSV;
+    ctx.pb = malloc(sizeof(*ctx.pb));
+    ctx.out = malloc((size_t)TIME_BATCH_RECORDS * (TIME_FMT_TIME_MAX + 1));
+    fp = tmpfile();
+    fd = open(path, O_RDONLY);
+    if (ctx.pb == NULL || ctx.out == NULL || fp == NULL || fd < 0) {
+        printf("range: cannot open\n");
+        return 1;
+    }
+    ctx.pb->n = 0;
+    ctx.out_fd = fileno(fp);
+
+    if (time_epoch_run(&ctx, fd, since, until) != 0) {
+        printf("range: failed\n");
+        mismatch++;
+    }
+
+    rewind(fp);
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        while (i < TEST_EPOCHS && (g_ns[i] < since || g_ns[i] >= until)) {
+            i++;
+        }
+        if (sscanf(line, "%d,%lf", &wn, &tow) != 2 || i >= TEST_EPOCHS
+            || wn * TIME_NS_PER_WEEK + (time_ns_t)(tow * 1e9 + 0.5) != g_ns[i]) {
+            if (mismatch++ < 5) {
+                printf("range: epoch %zu: %s", i, line);
+            }
+        }
+        i++;
+    }
+    while (i < TEST_EPOCHS && (g_ns[i] < since || g_ns[i] >= until)) {
+        i++;
+    }
+    if (i < TEST_EPOCHS) {
+        printf("range: missing epoch %zu\n", i);
+        mismatch++;
+    }
+
+    fclose(fp);
+    close(fd);
+    free(ctx.pb);
+    free(ctx.out);
+
+    return mismatch;
+}
+
+/*
+ * 第0、2块的ns列改写为第1块中间的值(块索引不变)后只取第1块内的范围:
+ * 如果按块索引跳过失败, 改写的值会出现在输出中.
+ */
+static size_t test_skip(const char *path)
+{
+    time_epoch_reader_t reader;
+    time_epoch_block_t blk;
+    time_ns_t *fake;
+    time_ns_t since = g_ns[TIME_EPOCH_BLOCK_RECORDS + 10];
+    time_ns_t until = g_ns[TIME_EPOCH_BLOCK_RECORDS + 60000];
+    size_t mismatch = 0;
+    size_t b, k;
+    int fd;
+
+    fd = open(path, O_RDWR);
+    if (fd < 0 || time_epoch_reader_open(&reader, fd) != 0) {
+        printf("skip: cannot open\n");
+        return 1;
+    }
+    fake = malloc(TIME_EPOCH_BLOCK_RECORDS * sizeof(*fake));
+    if (fake == NULL) {
+        return 1;
+    }
+    for (k = 0; k < TIME_EPOCH_BLOCK_RECORDS; k++) {
+        fake[k] = g_ns[TIME_EPOCH_BLOCK_RECORDS + 30000];
+    }
+    for (b = 0; b < 3; b += 2) {
+        time_epoch_reader_block(&reader, b, &blk);
+        if (blk.max_ns >= since && blk.min_ns < until) {
+            printf("skip: block %zu overlaps the range\n", b);
+            mismatch++;
+        }
+        if (pwrite(fd, fake, blk.n * sizeof(*fake), (off_t)reader.index[b].offset) != (ssize_t)(blk.n * sizeof(*fake))) {
+            mismatch++;
+        }
+    }
+    time_epoch_reader_close(&reader);
+    close(fd);
+    free(fake);
+
+    return mismatch + test_range(path, since, until);
+}
+
+//把data改写后的内容写入path, 返回time_epoch_reader_open的结果
+static int test_open_bytes(const char *path, const char *data, size_t len)
+{
+    time_epoch_reader_t reader;
+    int fd, rv;
+
+    fd = open(path, O_RDWR | O_TRUNC);
+    if (fd < 0 || time_write_all(fd, data, len) != 0) {
+        return -1;
+    }
+    rv = time_epoch_reader_open(&reader, fd);
+    if (rv == 0) {
+        time_epoch_reader_close(&reader);
+    }
+    close(fd);
+
+    return rv;
+}
+
+//截断、损坏的头部和块索引都返回-2, 原样的文件可以打开
+static size_t test_corrupt(const char *path, uint64_t *pstate)
+{
+    static const size_t cut[] = { 0, 1, 32, sizeof(time_epoch_header_t) - 1 };
+    char *data, *copy;
+    time_epoch_header_t *phdr;
+    time_epoch_index_t *pi;
+    size_t mismatch = 0;
+    size_t len, i;
+    struct stat st;
+    int fd, rv, k;
+
+    if (test_write(path, TIME_EPOCH_COL_GPS | TIME_EPOCH_COL_DOY, TEST_SMALL, pstate) != 0
+        || stat(path, &st) != 0) {
+        printf("corrupt: cannot write\n");
+        return 1;
+    }
+    len = (size_t)st.st_size;
+    data = malloc(len);
+    copy = malloc(len);
+    fd = open(path, O_RDONLY);
+    if (data == NULL || copy == NULL || fd < 0 || read(fd, data, len) != (ssize_t)len) {
+        printf("corrupt: cannot read\n");
+        return 1;
+    }
+    close(fd);
+
+    if (test_open_bytes(path, data, len) != 0) {
+        printf("corrupt: valid file rejected\n");
+        mismatch++;
+    }
+
+    //截断的头部, 以及写入端没有回填的全零头部
+    for (i = 0; i < sizeof(cut) / sizeof(cut[0]); i++) {
+        if (test_open_bytes(path, data, cut[i]) != -2) {
+            printf("corrupt: %zu bytes accepted\n", cut[i]);
+            mismatch++;
+        }
+    }
+    memset(copy, 0, len);
+    if (test_open_bytes(path, copy, len) != -2) {
+        printf("corrupt: zero header accepted\n");
+        mismatch++;
+    }
+    //截掉块索引的最后一个字节
+    if (test_open_bytes(path, data, len - 1) != -2) {
+        printf("corrupt: truncated index accepted\n");
+        mismatch++;
+    }
+
+    phdr = (time_epoch_header_t *)copy;
+    for (k = 0; k < 11; k++) {
+        memcpy(copy, data, len);
+        pi = (time_epoch_index_t *)(copy + phdr->index_offset);
+        switch (k) {
+            case 0:
+                phdr->magic[7] ^= 1;
+                break;
+            case 1:
+                phdr->version++;
+                break;
+            case 2:
+                phdr->byte_order = 0x04030201U;
+                break;
+            case 3:
+                phdr->columns |= 1U << 5;
+                break;
+            case 4:
+                phdr->count++;
+                break;
+            case 5:
+                phdr->index_offset += 4;
+                break;
+            case 6:
+                phdr->index_offset = len + 8;
+                break;
+            case 7:
+                phdr->nblocks++;
+                break;
+            case 8:
+                pi->count = 0;
+                break;
+            case 9:
+                pi->offset = phdr->index_offset;
+                break;
+            default:
+                pi->offset = 4;
+                break;
+        }
+        rv = test_open_bytes(path, copy, len);
+        if (rv != -2) {
+            printf("corrupt: case %d: %d\n", k, rv);
+            mismatch++;
+        }
+    }
+
+    free(data);
+    free(copy);
+
+    return mismatch;
+}
+
+int main(void)
+{
+    static const uint32_t columns[] = {
+        0, TIME_EPOCH_COL_GPS, TIME_EPOCH_COL_DOY, TIME_EPOCH_COL_GPS | TIME_EPOCH_COL_DOY,
+    };
+    uint64_t state = 20110106ULL;
+    char path[64];
+    size_t mismatch = 0;
+    size_t i;
+
+    if (test_temp(path, sizeof(path)) != 0) {
+        puts("FAIL");
+        return 1;
+    }
+    test_fill(&state);
+
+    for (i = 0; i < sizeof(columns) / sizeof(columns[0]); i++) {
+        if (test_write(path, columns[i], TEST_EPOCHS, &state) != 0) {
+            printf("write %u: failed\n", columns[i]);
+            mismatch++;
+            continue;
+        }
+        mismatch += test_read(path, columns[i]);
+    }
+
+    mismatch += test_range(path, INT64_MIN, INT64_MAX);
+    mismatch += test_range(path, g_ns[1000], g_ns[TIME_EPOCH_BLOCK_RECORDS * 2 + 1000]);
+    mismatch += test_skip(path);
+    mismatch += test_corrupt(path, &state);
+    unlink(path);
+
+    printf("%zu mismatches\n", mismatch);
+    puts(mismatch ? "FAIL" : "PASS");
+
+    return mismatch ? 1 : 0;
+}
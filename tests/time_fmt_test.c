@@ -0,0 +1,73 @@
+/*
+ * time_conver.c文本输出测试: 随机数值(含需要17位有效数字、绝对值远小于0.1的值)
+ *     经time_fmt_double输出后由strtod读回, 经time_fmt_seconds输出为"周数 周内秒"后由time_parse_gpstime读回,
+ *     都必须得到原值.
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_fmt_test tests/time_fmt_test.c && ./time_fmt_test
+ */
+#define main time_conver_main       //只使用输出和解析函数, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_ROUNDS         (5000000)
+#define TEST_MIN_FRAC       (1e-14)     //小数位不超过TIME_PARSE_FRAC_MAX时能保留17位有效数字的下限
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+int main(void)
+{
+    uint64_t state = 20110106ULL;
+    char text[TIME_FMT_TIME_MAX];
+    gps_time_t gt;
+    double v;
+    long sn;
+    size_t n;
+    int i, halve;
+
+    //1.0000000003174137e-05需要17位有效数字, 小数点后有21位
+    n = (size_t)(time_fmt_double(text, 1.0000000003174137e-05, 0) - text);
+    text[n] = '\0';
+    if (strcmp(text, "0.000010000000003174137") != 0) {
+        printf("time_fmt_double: %s\n", text);
+        puts("FAIL");
+        return 1;
+    }
+
+    for (i = 0; i < TEST_ROUNDS; i++) {
+        v = (double)(test_rand(&state) >> 11) / 9007199254740992.0;
+        for (halve = (int)(test_rand(&state) % 48); halve > 0; halve--) {
+            v *= 0.5;
+        }
+        if (v < TEST_MIN_FRAC) {
+            continue;
+        }
+
+        n = (size_t)(time_fmt_double(text, (i % 3 == 0) ? v * 604800 : v, 0) - text);
+        text[n] = '\0';
+        if (strtod(text, NULL) != ((i % 3 == 0) ? v * 604800 : v)) {
+            printf("time_fmt_double: %.17g -> %s\n", (i % 3 == 0) ? v * 604800 : v, text);
+            puts("FAIL");
+            return 1;
+        }
+
+        sn = (long)(test_rand(&state) % ONE_WEEK_SECONDS);
+        memcpy(text, "1617 ", 5);
+        n = (size_t)(time_fmt_seconds(text + 5, sn, v, 0) - text);
+        if (time_parse_gpstime(text, n, &gt) != 0 || gt.tow.sn != sn || gt.tow.tos != v) {
+            printf("time_fmt_seconds: %ld + %.17g -> %.*s\n", sn, v, (int)n, text);
+            puts("FAIL");
+            return 1;
+        }
+    }
+
+    puts("PASS");
+
+    return 0;
+}
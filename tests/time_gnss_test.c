@@ -0,0 +1,127 @@
+/*
+ * 多GNSS系统时测试: 北斗、伽利略系统时的起点; 随机GPS时(一半落在周边界前后30秒内)
+ *     换算到BDT、GST、QZSST、GLONASST后, 两两之间直接批量转换的结果必须与经GPS时转换相同,
+ *     换算回GPS时必须得到原值(GLONASST以通用时表示, 秒的小数部分有double舍入, 只要求相差小于1ns).
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_gnss_test tests/time_gnss_test.c && ./time_gnss_test
+ */
+#define main time_conver_main       //只使用转换函数, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_INPUTS         (200000)
+
+static gps_time_t g_gt[TEST_INPUTS], g_back[TEST_INPUTS];
+static bdt_time_t g_bdt[TEST_INPUTS], g_bdt2[TEST_INPUTS];
+static gst_time_t g_gst[TEST_INPUTS], g_gst2[TEST_INPUTS];
+static qzsst_time_t g_qzs[TEST_INPUTS], g_qzs2[TEST_INPUTS];
+static common_time_t g_glo[TEST_INPUTS], g_glo2[TEST_INPUTS];
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+#define TEST_WEEK_EQUAL(a, b) ((a).wn == (b).wn && (a).tow.sn == (b).tow.sn && (a).tow.tos == (b).tow.tos)
+#define TEST_WEEK_NEAR(a, b) ((a).wn == (b).wn && (a).tow.sn == (b).tow.sn && (a).tow.tos - (b).tow.tos < 1e-9 \
+    && (b).tow.tos - (a).tow.tos < 1e-9)
+#define TEST_CIVIL_EQUAL(a, b) ((a).year == (b).year && (a).month == (b).month && (a).day == (b).day \
+    && (a).hour == (b).hour && (a).minute == (b).minute && (a).second == (b).second)
+
+//直接转换的结果(第二组数组)与经GPS时转换的结果(第一组数组)比较
+#define TEST_COMPARE(name, x, y, equal) \
+    for (i = 0; i < TEST_INPUTS; i++) { \
+        if (!equal(x[i], y[i])) { \
+            if (mismatch++ < 5) { \
+                printf("%s: gps %d %ld\n", name, g_gt[i].wn, g_gt[i].tow.sn); \
+            } \
+        } \
+    }
+
+int main(void)
+{
+    uint64_t state = 20110106ULL;
+    time_leap_table_t leap;
+    gps_time_t gt;
+    bdt_time_t bdt;
+    gst_time_t gst;
+    size_t i, mismatch = 0;
+
+    //北斗时起点为2006-01-01 0时(UTC), 即GPS第1356周起点之后14秒; 伽利略系统时起点为GPS第1024周起点
+    gt.wn = 1356;
+    gt.tow.sn = 14;
+    gt.tow.tos = 0.0;
+    time_conver_gpstime_to_bdt(&gt, &bdt);
+    gt.wn = 1024;
+    gt.tow.sn = 0;
+    time_conver_gpstime_to_gst(&gt, &gst);
+    if (bdt.wn != 0 || bdt.tow.sn != 0 || gst.wn != 0 || gst.tow.sn != 0) {
+        puts("FAIL");
+        return 1;
+    }
+
+    time_leap_table_init(&leap);
+    for (i = 0; i < TEST_INPUTS; i++) {
+        g_gt[i].wn = 1400 + (int)(test_rand(&state) % 1600);
+        if (i & 1) {
+            g_gt[i].tow.sn = (long)(test_rand(&state) % ONE_WEEK_SECONDS);
+        } else {
+            g_gt[i].tow.sn = (long)((test_rand(&state) % 60 + ONE_WEEK_SECONDS - 30) % ONE_WEEK_SECONDS);
+        }
+        g_gt[i].tow.tos = (double)(test_rand(&state) % 1000000) / 1e6;
+    }
+
+    time_conver_gpstime_to_bdt_batch(g_gt, g_bdt, TEST_INPUTS);
+    time_conver_gpstime_to_gst_batch(g_gt, g_gst, TEST_INPUTS);
+    time_conver_gpstime_to_qzsst_batch(g_gt, g_qzs, TEST_INPUTS);
+    time_conver_gpstime_to_glonasst_batch(&leap, g_gt, g_glo, TEST_INPUTS);
+
+    time_conver_bdt_to_gpstime_batch(g_bdt, g_back, TEST_INPUTS);
+    TEST_COMPARE("bdt->gps", g_gt, g_back, TEST_WEEK_EQUAL)
+    time_conver_gst_to_gpstime_batch(g_gst, g_back, TEST_INPUTS);
+    TEST_COMPARE("gst->gps", g_gt, g_back, TEST_WEEK_EQUAL)
+    time_conver_qzsst_to_gpstime_batch(g_qzs, g_back, TEST_INPUTS);
+    TEST_COMPARE("qzsst->gps", g_gt, g_back, TEST_WEEK_EQUAL)
+    time_conver_glonasst_to_gpstime_batch(&leap, g_glo, g_back, TEST_INPUTS);
+    TEST_COMPARE("glonasst->gps", g_gt, g_back, TEST_WEEK_NEAR)     //通用时的秒为double, 小数部分有舍入
+
+    time_conver_bdt_to_gst_batch(g_bdt, g_gst2, TEST_INPUTS);
+    TEST_COMPARE("bdt->gst", g_gst, g_gst2, TEST_WEEK_EQUAL)
+    time_conver_gst_to_bdt_batch(g_gst, g_bdt2, TEST_INPUTS);
+    TEST_COMPARE("gst->bdt", g_bdt, g_bdt2, TEST_WEEK_EQUAL)
+    time_conver_bdt_to_qzsst_batch(g_bdt, g_qzs2, TEST_INPUTS);
+    TEST_COMPARE("bdt->qzsst", g_qzs, g_qzs2, TEST_WEEK_EQUAL)
+    time_conver_qzsst_to_bdt_batch(g_qzs, g_bdt2, TEST_INPUTS);
+    TEST_COMPARE("qzsst->bdt", g_bdt, g_bdt2, TEST_WEEK_EQUAL)
+    time_conver_gst_to_qzsst_batch(g_gst, g_qzs2, TEST_INPUTS);
+    TEST_COMPARE("gst->qzsst", g_qzs, g_qzs2, TEST_WEEK_EQUAL)
+    time_conver_qzsst_to_gst_batch(g_qzs, g_gst2, TEST_INPUTS);
+    TEST_COMPARE("qzsst->gst", g_gst, g_gst2, TEST_WEEK_EQUAL)
+
+    time_conver_bdt_to_glonasst_batch(&leap, g_bdt, g_glo2, TEST_INPUTS);
+    TEST_COMPARE("bdt->glonasst", g_glo, g_glo2, TEST_CIVIL_EQUAL)
+    time_conver_gst_to_glonasst_batch(&leap, g_gst, g_glo2, TEST_INPUTS);
+    TEST_COMPARE("gst->glonasst", g_glo, g_glo2, TEST_CIVIL_EQUAL)
+    time_conver_qzsst_to_glonasst_batch(&leap, g_qzs, g_glo2, TEST_INPUTS);
+    TEST_COMPARE("qzsst->glonasst", g_glo, g_glo2, TEST_CIVIL_EQUAL)
+
+    //GLONASST到周计时系统时与先到GPS时(g_back)再换算比较
+    time_conver_gpstime_to_bdt_batch(g_back, g_bdt, TEST_INPUTS);
+    time_conver_gpstime_to_gst_batch(g_back, g_gst, TEST_INPUTS);
+    time_conver_gpstime_to_qzsst_batch(g_back, g_qzs, TEST_INPUTS);
+    time_conver_glonasst_to_bdt_batch(&leap, g_glo, g_bdt2, TEST_INPUTS);
+    TEST_COMPARE("glonasst->bdt", g_bdt, g_bdt2, TEST_WEEK_EQUAL)
+    time_conver_glonasst_to_gst_batch(&leap, g_glo, g_gst2, TEST_INPUTS);
+    TEST_COMPARE("glonasst->gst", g_gst, g_gst2, TEST_WEEK_EQUAL)
+    time_conver_glonasst_to_qzsst_batch(&leap, g_glo, g_qzs2, TEST_INPUTS);
+    TEST_COMPARE("glonasst->qzsst", g_qzs, g_qzs2, TEST_WEEK_EQUAL)
+
+    printf("%zu mismatches\n", mismatch);
+    puts(mismatch ? "FAIL" : "PASS");
+
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,298 @@
+/*
+ * 简化儒略日转换测试: 随机简化儒略日、儒略日、GPS时、通用时(含两位年份)、年积日(天内秒、周内秒、
+ *     时分秒超出范围或为负)与简化儒略日之间的直接转换, 与经儒略日转换的结果逐字段相同;
+ *     简化儒略日经四种表示往返得到规格化的原值; 8个批量转换(长度0-40)与单点转换逐位相同;
+ *     1858-11-17、GPS起点、1970-01-01等定点的值正确.
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_mjd_test tests/time_mjd_test.c && ./time_mjd_test
+ */
+#define main time_conver_main       //只使用转换函数, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_INPUTS         (100000)
+#define TEST_BATCH_MAX      (40)
+
+static new_julianday_t g_mjd[TEST_INPUTS];
+static julianday_t g_jd[TEST_INPUTS];
+static gps_time_t g_gt[TEST_INPUTS];
+static common_time_t g_ct[TEST_INPUTS];
+static doy_t g_doy[TEST_INPUTS];
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+//[lo, hi)内的随机整数
+static long long test_range(uint64_t *pstate, long long lo, long long hi)
+{
+    return lo + (long long)(test_rand(pstate) % (uint64_t)(hi - lo));
+}
+
+//[0, 1)内1/1024的整数倍, 各路径上的小数部分都精确
+static double test_frac(uint64_t *pstate)
+{
+    return (double)(test_rand(pstate) % 1024) / 1024.0;
+}
+
+//天内秒一半在[0, 86400)内, 一半在[-3天, 4天)内(含负值)
+static long test_tod(uint64_t *pstate)
+{
+    if (test_rand(pstate) & 1) {
+        return (long)test_range(pstate, 0, ONE_DAY_SECONDS);
+    }
+
+    return (long)test_range(pstate, -3LL * ONE_DAY_SECONDS, 4LL * ONE_DAY_SECONDS);
+}
+
+static void test_fill(uint64_t *pstate, size_t i)
+{
+    //日数保持在1-9999年之内, 年积日的年份不会截断
+    g_mjd[i].day = (long)test_range(pstate, -600000, 2900000);
+    g_mjd[i].tod.sn = test_tod(pstate);
+    g_mjd[i].tod.tos = test_frac(pstate);
+
+    g_jd[i].day = (long)test_range(pstate, 1800000, 5300000);
+    g_jd[i].tod.sn = test_tod(pstate);
+    g_jd[i].tod.tos = test_frac(pstate);
+
+    g_gt[i].wn = (int)test_range(pstate, -5000, 20000);
+    g_gt[i].tow.sn = (test_rand(pstate) & 1) ? (long)test_range(pstate, 0, ONE_WEEK_SECONDS)
+        : (long)test_range(pstate, -2LL * ONE_WEEK_SECONDS, 3LL * ONE_WEEK_SECONDS);
+    g_gt[i].tow.tos = test_frac(pstate);
+
+    g_ct[i].year = (int)((test_rand(pstate) & 1) ? test_range(pstate, 0, 100) : test_range(pstate, 1800, 2200));
+    g_ct[i].month = (int)test_range(pstate, 1, 13);
+    g_ct[i].day = (int)test_range(pstate, 1, 29);
+    if (test_rand(pstate) & 1) {
+        g_ct[i].hour = (int)test_range(pstate, 0, 24);
+        g_ct[i].minute = (int)test_range(pstate, 0, 60);
+        g_ct[i].second = (double)test_range(pstate, 0, 60) + test_frac(pstate);
+    } else {
+        g_ct[i].hour = (int)test_range(pstate, -50, 75);
+        g_ct[i].minute = (int)test_range(pstate, -100, 200);
+        g_ct[i].second = (double)test_range(pstate, 0, 300) + test_frac(pstate);
+    }
+
+    g_doy[i].year = (unsigned short)test_range(pstate, 1800, 2200);
+    g_doy[i].day = (unsigned short)test_range(pstate, 0, 500);
+    g_doy[i].tod.sn = test_tod(pstate);
+    g_doy[i].tod.tos = test_frac(pstate);
+}
+
+static bool test_same_mjd(const new_julianday_t *pa, const new_julianday_t *pb)
+{
+    return pa->day == pb->day && pa->tod.sn == pb->tod.sn && pa->tod.tos == pb->tod.tos;
+}
+
+static bool test_same_jd(const julianday_t *pa, const julianday_t *pb)
+{
+    return pa->day == pb->day && pa->tod.sn == pb->tod.sn && pa->tod.tos == pb->tod.tos;
+}
+
+static bool test_same_gt(const gps_time_t *pa, const gps_time_t *pb)
+{
+    return pa->wn == pb->wn && pa->tow.sn == pb->tow.sn && pa->tow.tos == pb->tow.tos;
+}
+
+static bool test_same_ct(const common_time_t *pa, const common_time_t *pb)
+{
+    return pa->year == pb->year && pa->month == pb->month && pa->day == pb->day && pa->hour == pb->hour
+        && pa->minute == pb->minute && pa->second == pb->second;
+}
+
+static bool test_same_doy(const doy_t *pa, const doy_t *pb)
+{
+    return pa->year == pb->year && pa->day == pb->day && pa->tod.sn == pb->tod.sn && pa->tod.tos == pb->tod.tos;
+}
+
+//天内秒超出[0, 86400)的部分进位到日数
+static void test_normalize(const new_julianday_t *pin, new_julianday_t *pout)
+{
+    long long q = time_floor_div(pin->tod.sn, ONE_DAY_SECONDS);
+
+    pout->day = (long)(pin->day + q);
+    pout->tod.sn = (long)(pin->tod.sn - q * ONE_DAY_SECONDS);
+    pout->tod.tos = pin->tod.tos;
+}
+
+//简化儒略日到各表示: 直接转换与先转儒略日再转换相同, 再转回得到规格化的原值
+static size_t test_from_mjd(const new_julianday_t *pmjd)
+{
+    new_julianday_t norm, back;
+    julianday_t jd;
+    gps_time_t gt, gt2;
+    common_time_t ct, ct2;
+    doy_t doy, doy2;
+    size_t mismatch = 0;
+
+    test_normalize(pmjd, &norm);
+    time_conver_mjd_to_julianday(pmjd, &jd);
+
+    time_conver_julianday_to_mjd(&jd, &back);
+    mismatch += !test_same_mjd(&back, &norm);
+
+    time_conver_mjd_to_gpstime(pmjd, &gt);
+    time_conver_julianday_to_gpstime(&jd, &gt2);
+    time_conver_gpstime_to_mjd(&gt, &back);
+    mismatch += !test_same_gt(&gt, &gt2) + !test_same_mjd(&back, &norm);
+
+    time_conver_mjd_to_commontime(pmjd, &ct);
+    time_conver_julianday_to_commontime(&jd, &ct2);
+    time_conver_commontime_to_mjd(&ct, &back);
+    mismatch += !test_same_ct(&ct, &ct2) + !test_same_mjd(&back, &norm);
+
+    time_conver_mjd_to_doy(pmjd, &doy);
+    time_conver_julianday_to_doy(&jd, &doy2);
+    time_conver_doy_to_mjd(&doy, &back);
+    mismatch += !test_same_doy(&doy, &doy2) + !test_same_mjd(&back, &norm);
+
+    return mismatch;
+}
+
+//各表示到简化儒略日: 直接转换与先转儒略日再转换相同
+static size_t test_to_mjd(size_t i)
+{
+    new_julianday_t mjd, mjd2;
+    julianday_t jd;
+    size_t mismatch = 0;
+
+    time_conver_julianday_to_mjd(&g_jd[i], &mjd);
+    time_conver_mjd_to_julianday(&mjd, &jd);
+    mismatch += !(jd.day == g_jd[i].day + time_floor_div(g_jd[i].tod.sn, ONE_DAY_SECONDS)
+        && jd.tod.sn == g_jd[i].tod.sn - time_floor_div(g_jd[i].tod.sn, ONE_DAY_SECONDS) * ONE_DAY_SECONDS);
+
+    time_conver_gpstime_to_mjd(&g_gt[i], &mjd);
+    time_conver_gpstime_to_julianday(&g_gt[i], &jd);
+    time_conver_julianday_to_mjd(&jd, &mjd2);
+    mismatch += !test_same_mjd(&mjd, &mjd2);
+
+    time_conver_commontime_to_mjd(&g_ct[i], &mjd);
+    time_conver_commontime_to_julianday(&g_ct[i], &jd);
+    time_conver_julianday_to_mjd(&jd, &mjd2);
+    mismatch += !test_same_mjd(&mjd, &mjd2);
+
+    time_conver_doy_to_mjd(&g_doy[i], &mjd);
+    time_conver_doy_to_julianday(&g_doy[i], &jd);
+    time_conver_julianday_to_mjd(&jd, &mjd2);
+    mismatch += !test_same_mjd(&mjd, &mjd2);
+
+    return mismatch;
+}
+
+//批量转换与逐个单点转换比较, 输出缓冲区先填满0xA5, 超出n的元素不得被改写
+#define TEST_BATCH_DEFINE(from, from_t, to, to_t, pin) \
+static size_t test_batch_##from##_to_##to(size_t off, size_t n) \
+{ \
+    static to_t out[TEST_BATCH_MAX + 1]; \
+    to_t one, guard; \
+    size_t mismatch = 0; \
+    size_t i; \
+    \
+    memset(out, 0xA5, sizeof(out)); \
+    memset(&guard, 0xA5, sizeof(guard)); \
+    time_conver_##from##_to_##to##_batch(&(pin)[off], out, n); \
+    for (i = 0; i < n; i++) { \
+        time_conver_##from##_to_##to(&(pin)[off + i], &one); \
+        mismatch += !test_same_##to(&out[i], &one); \
+    } \
+    mismatch += (memcmp(&out[n], &guard, sizeof(guard)) != 0); \
+    \
+    return mismatch; \
+}
+
+#define test_same_julianday     test_same_jd
+#define test_same_gpstime       test_same_gt
+#define test_same_commontime    test_same_ct
+
+TEST_BATCH_DEFINE(mjd, new_julianday_t, julianday, julianday_t, g_mjd)
+TEST_BATCH_DEFINE(julianday, julianday_t, mjd, new_julianday_t, g_jd)
+TEST_BATCH_DEFINE(mjd, new_julianday_t, gpstime, gps_time_t, g_mjd)
+TEST_BATCH_DEFINE(gpstime, gps_time_t, mjd, new_julianday_t, g_gt)
+TEST_BATCH_DEFINE(mjd, new_julianday_t, commontime, common_time_t, g_mjd)
+TEST_BATCH_DEFINE(commontime, common_time_t, mjd, new_julianday_t, g_ct)
+TEST_BATCH_DEFINE(mjd, new_julianday_t, doy, doy_t, g_mjd)
+TEST_BATCH_DEFINE(doy, doy_t, mjd, new_julianday_t, g_doy)
+
+static size_t test_batch(uint64_t *pstate)
+{
+    size_t mismatch = 0;
+    size_t n, off;
+
+    for (n = 0; n <= TEST_BATCH_MAX; n++) {
+        off = (size_t)test_range(pstate, 0, TEST_INPUTS - TEST_BATCH_MAX);
+        mismatch += test_batch_mjd_to_julianday(off, n) + test_batch_julianday_to_mjd(off, n)
+            + test_batch_mjd_to_gpstime(off, n) + test_batch_gpstime_to_mjd(off, n)
+            + test_batch_mjd_to_commontime(off, n) + test_batch_commontime_to_mjd(off, n)
+            + test_batch_mjd_to_doy(off, n) + test_batch_doy_to_mjd(off, n);
+    }
+
+    return mismatch;
+}
+
+//定点: MJD 0为1858-11-17 0时(JD 2400000.5), GPS起点为MJD 44244, 1970-01-01为MJD 40587
+static size_t test_fixed(void)
+{
+    static const new_julianday_t mjd0 = { 0, { 0, 0.0 } };
+    static const new_julianday_t gps0 = { TIME_GPS_EPOCH_MJD, { 0, 0.0 } };
+    static const common_time_t civil0 = { 1970, 1, 1, 0, 0, 0.0 };
+    static const common_time_t late = { 79, 10, 1, 0, 0, 0.0 };     //两位年份, 补全为2079年
+    new_julianday_t mjd;
+    julianday_t jd;
+    gps_time_t gt;
+    common_time_t ct;
+    size_t mismatch = 0;
+
+    time_conver_mjd_to_julianday(&mjd0, &jd);
+    time_conver_mjd_to_commontime(&mjd0, &ct);
+    mismatch += !(jd.day == 2400000 && jd.tod.sn == ONE_DAY_SECONDS / 2);
+    mismatch += !(ct.year == 1858 && ct.month == 11 && ct.day == 17 && ct.hour == 0 && ct.second == 0.0);
+
+    time_conver_mjd_to_gpstime(&gps0, &gt);
+    mismatch += !(gt.wn == 0 && gt.tow.sn == 0);
+
+    time_conver_commontime_to_mjd(&civil0, &mjd);
+    mismatch += !(mjd.day == TIME_CIVIL_EPOCH_MJD && mjd.tod.sn == 0);
+
+    //2079-10-01: 1979-10-01(MJD 44147)之后100年, 其中闰年25个
+    time_conver_commontime_to_mjd(&late, &mjd);
+    mismatch += !(mjd.day == 44147 + 100 * 365 + 25 && mjd.tod.sn == 0);
+
+    if (mismatch) {
+        printf("fixed: %zu\n", mismatch);
+    }
+
+    return mismatch;
+}
+
+int main(void)
+{
+    uint64_t state = 20110106ULL;
+    size_t mismatch = 0, bad;
+    size_t i;
+
+    for (i = 0; i < TEST_INPUTS; i++) {
+        test_fill(&state, i);
+    }
+
+    mismatch += test_fixed();
+    for (i = 0; i < TEST_INPUTS; i++) {
+        bad = test_from_mjd(&g_mjd[i]) + test_to_mjd(i);
+        if (bad && mismatch < 5) {
+            printf("input %zu: mjd %ld %ld, gps %d %ld, doy %u %u %ld\n", i, g_mjd[i].day, g_mjd[i].tod.sn,
+                g_gt[i].wn, g_gt[i].tow.sn, g_doy[i].year, g_doy[i].day, g_doy[i].tod.sn);
+        }
+        mismatch += bad;
+    }
+    mismatch += test_batch(&state);
+
+    printf("%zu mismatches\n", mismatch);
+    puts(mismatch ? "FAIL" : "PASS");
+
+    return mismatch ? 1 : 0;
+}
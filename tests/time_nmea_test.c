@@ -0,0 +1,236 @@
+/*
+ * NMEA解码测试: 一段含2016年末跳秒(23:59:60)、RMC空日期、校验和错误、超过128字节、非时间语句、
+ *     行首杂散字符和末行无换行符的语句流, 一次输入的结果与预期的历元(按跳秒表换算的GPS时)和计数相同;
+ *     在每个字节处切成两段输入、逐字节输入(每次最多输出1个历元)时, 历元、sentences、bad都与一次输入相同;
+ *     time_nmea_checksum对0-64字节(含8的倍数和非8的倍数)的随机内容与逐字节异或相同.
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_nmea_test tests/time_nmea_test.c && ./time_nmea_test
+ */
+#define main time_conver_main       //只使用NMEA解码器, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_EPOCHS         (16)
+#define TEST_STREAM_MAX     (2048)
+
+typedef struct test_result_s {
+    time_nmea_epoch_t epoch[TEST_EPOCHS];
+    size_t n;
+    size_t sentences;
+    size_t bad;
+} test_result_t;
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+//逐字节异或, 作为time_nmea_checksum的对照
+static unsigned int test_checksum(const char *s, size_t len)
+{
+    unsigned int c = 0;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        c ^= (unsigned char)s[i];
+    }
+
+    return c;
+}
+
+//追加一条语句: body为'$'与'*'之间的内容, good为假时校验和加1; 返回新的长度
+static size_t test_add(char *buf, size_t len, const char *body, bool good, const char *eol)
+{
+    unsigned int c = test_checksum(body, strlen(body)) + (good ? 0 : 1);
+
+    return len + (size_t)snprintf(buf + len, TEST_STREAM_MAX - len, "$%s*%02X%s", body, c & 0xFF, eol);
+}
+
+/*
+ * 语句流, 预期的5个历元依次为:
+ * 2016-12-31 23:59:59、跳秒23:59:60、2017-01-01 00:00:00(GPS时各差1秒), 1994-03-23 12:35:19.25,
+ * 以及末行无换行符的2017-01-01 00:00:01.5.
+ */
+static size_t test_stream(char *buf, size_t *plens8)
+{
+    char longer[160];
+    size_t len = 0;
+
+    memset(longer, 0, sizeof(longer));
+    memcpy(longer, "GPZDA,000002.00,01,01,2017,00,00", 32);
+    memset(longer + 32, ',', 120);          //校验和正确但超过128字节
+
+    len = test_add(buf, len, "GPZDA,235959.00,31,12,2016,00,00", true, "\r\n");
+    len = test_add(buf, len, "GPZDA,235960.00,31,12,2016,00,00", true, "\r\n");
+    len = test_add(buf, len, "GPZDA,000000.00,01,01,2017,00,00", true, "\n");
+    len = test_add(buf, len, "GPRMC,123519.25,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W", true, "\r\n");
+    len = test_add(buf, len, "GPRMC,123520.00,A,4807.038,N,01131.000,E,022.4,084.4,,003.1,W", true, "\r\n");
+    len = test_add(buf, len, "GPZDA,000003.00,01,01,2017,00,00", false, "\r\n");
+    len = test_add(buf, len, longer, true, "\r\n");
+    len += (size_t)snprintf(buf + len, TEST_STREAM_MAX - len, "noise ");
+    len = test_add(buf, len, "GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,", true, "\r\n");
+    len = test_add(buf, len, "GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1", true, "\n");
+    len = test_add(buf, len, "GNZDA,000001.50,01,01,2017,00,00", true, "");
+
+    //'$'与'*'之间的长度: 第3条32字节(8的倍数), 第4条67字节(非8的倍数)
+    *plens8 = (strlen("GPZDA,000000.00,01,01,2017,00,00") % 8 == 0)
+        + (strlen("GPRMC,123519.25,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W") % 8 != 0);
+
+    return len;
+}
+
+//把data按cut切成两段(cut为0时逐字节)输入, 每次最多输出cap个历元, 最后调用finish
+static void test_feed(time_leap_table_t *pleap, const char *data, size_t len, size_t cut, size_t cap,
+    test_result_t *pr)
+{
+    time_nmea_t nmea;
+    size_t off = 0, stop, done, count;
+
+    time_nmea_init(&nmea, pleap);
+    pr->n = 0;
+    while (off < len) {
+        stop = (cut == 0) ? off + 1 : (off < cut ? cut : len);
+        while (off < stop) {
+            done = time_nmea_feed(&nmea, data + off, stop - off, pr->epoch + pr->n,
+                (cap < TEST_EPOCHS - pr->n) ? cap : TEST_EPOCHS - pr->n, &count);
+            pr->n += count;
+            off += done;
+            if (done == 0 && count == 0) {
+                off = len;          //输出数组已满
+                break;
+            }
+        }
+    }
+    pr->n += time_nmea_finish(&nmea, pr->epoch + pr->n);
+    pr->sentences = nmea.sentences;
+    pr->bad = nmea.bad;
+}
+
+static bool test_same_epoch(const time_nmea_epoch_t *pa, const time_nmea_epoch_t *pb)
+{
+    return pa->type == pb->type && pa->utc.year == pb->utc.year && pa->utc.month == pb->utc.month
+        && pa->utc.day == pb->utc.day && pa->utc.hour == pb->utc.hour && pa->utc.minute == pb->utc.minute
+        && pa->utc.second == pb->utc.second && pa->gt.wn == pb->gt.wn && pa->gt.tow.sn == pb->gt.tow.sn
+        && pa->gt.tow.tos == pb->gt.tow.tos && pa->jd.day == pb->jd.day && pa->jd.tod.sn == pb->jd.tod.sn
+        && pa->jd.tod.tos == pb->jd.tod.tos;
+}
+
+static size_t test_compare(const char *what, size_t cut, const test_result_t *pa, const test_result_t *pb)
+{
+    size_t i;
+
+    if (pa->n != pb->n || pa->sentences != pb->sentences || pa->bad != pb->bad) {
+        printf("%s %zu: %zu epochs, %zu sentences, %zu bad\n", what, cut, pa->n, pa->sentences, pa->bad);
+        return 1;
+    }
+    for (i = 0; i < pa->n; i++) {
+        if (!test_same_epoch(&pa->epoch[i], &pb->epoch[i])) {
+            printf("%s %zu: epoch %zu\n", what, cut, i);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+//一次输入的结果: 历元按跳秒表换算, 跳秒前后GPS时连续
+static size_t test_expect(time_leap_table_t *pleap, const test_result_t *pr)
+{
+    static const common_time_t utc[] = {
+        { 2016, 12, 31, 23, 59, 59.0 }, { 2016, 12, 31, 23, 59, 60.0 }, { 2017, 1, 1, 0, 0, 0.0 },
+        { 1994, 3, 23, 12, 35, 19.25 }, { 2017, 1, 1, 0, 0, 1.5 },
+    };
+    static const time_nmea_type_t type[] = {
+        TIME_NMEA_ZDA, TIME_NMEA_ZDA, TIME_NMEA_ZDA, TIME_NMEA_RMC, TIME_NMEA_ZDA,
+    };
+    gps_time_t gt;
+    size_t mismatch = 0;
+    size_t i;
+
+    //校验和正确的语句: 4条ZDA、2条RMC、GGA、GSA; 错误: 校验和错误、超长各1条
+    if (pr->n != 5 || pr->sentences != 8 || pr->bad != 2) {
+        printf("expect: %zu epochs, %zu sentences, %zu bad\n", pr->n, pr->sentences, pr->bad);
+        return 1;
+    }
+    for (i = 0; i < pr->n; i++) {
+        time_conver_utc_to_gpstime(pleap, &utc[i], &gt);
+        gt.tow.tos = utc[i].second - (int)utc[i].second;
+        if (pr->epoch[i].type != type[i] || pr->epoch[i].gt.wn != gt.wn || pr->epoch[i].gt.tow.sn != gt.tow.sn
+            || pr->epoch[i].gt.tow.tos != gt.tow.tos || pr->epoch[i].utc.year != utc[i].year
+            || pr->epoch[i].utc.second != utc[i].second) {
+            printf("expect: epoch %zu: gps %d %ld\n", i, pr->epoch[i].gt.wn, pr->epoch[i].gt.tow.sn);
+            mismatch++;
+        }
+    }
+    //跳秒: 23:59:59、23:59:60、00:00:00的GPS时依次差1秒
+    for (i = 1; i < 3; i++) {
+        if ((long long)pr->epoch[i].gt.wn * ONE_WEEK_SECONDS + pr->epoch[i].gt.tow.sn
+            != (long long)pr->epoch[i - 1].gt.wn * ONE_WEEK_SECONDS + pr->epoch[i - 1].gt.tow.sn + 1) {
+            printf("expect: leap second at epoch %zu\n", i);
+            mismatch++;
+        }
+    }
+
+    return mismatch;
+}
+
+//0-64字节的随机内容, 从缓冲区的不同偏移开始(非对齐)
+static size_t test_checksum_fold(uint64_t *pstate)
+{
+    char buf[72];
+    size_t mismatch = 0;
+    size_t len, off, i;
+
+    for (len = 0; len <= 64; len++) {
+        for (off = 0; off < 8; off++) {
+            for (i = 0; i < sizeof(buf); i++) {
+                buf[i] = (char)test_rand(pstate);
+            }
+            if (time_nmea_checksum(buf + off, len) != test_checksum(buf + off, len)) {
+                if (mismatch++ < 5) {
+                    printf("checksum: %zu bytes at %zu\n", len, off);
+                }
+            }
+        }
+    }
+
+    return mismatch;
+}
+
+int main(void)
+{
+    static test_result_t whole, part;
+    time_leap_table_t leap;
+    char data[TEST_STREAM_MAX];
+    uint64_t state = 20110106ULL;
+    size_t mismatch = 0;
+    size_t len, lens8, cut;
+
+    time_leap_table_init(&leap);
+    len = test_stream(data, &lens8);
+    if (lens8 != 2) {
+        printf("stream: checksum lengths\n");
+        mismatch++;
+    }
+
+    test_feed(&leap, data, len, len, TEST_EPOCHS, &whole);
+    mismatch += test_expect(&leap, &whole);
+
+    for (cut = 1; cut < len; cut++) {
+        test_feed(&leap, data, len, cut, TEST_EPOCHS, &part);
+        mismatch += test_compare("split", cut, &part, &whole);
+    }
+    test_feed(&leap, data, len, 0, 1, &part);
+    mismatch += test_compare("bytes", 0, &part, &whole);
+
+    mismatch += test_checksum_fold(&state);
+
+    printf("%zu mismatches\n", mismatch);
+    puts(mismatch ? "FAIL" : "PASS");
+
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,306 @@
+/*
+ * 纳秒时间测试: 可表示范围内的随机纳秒时间换算为GPS时、通用时、儒略日、年积日后再转回得到原值;
+ *     范围边界内外的四种表示到纳秒时间的转换分别成功、返回-1(不发生int64溢出);
+ *     批量转换跳过越界的时间, 输出与行号一同紧凑排列; 差分编码批处理按行号报告越界记录, 其余历元解码还原.
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_ns_test tests/time_ns_test.c && ./time_ns_test
+ */
+#include <limits.h>
+#include <math.h>
+
+#define main time_conver_main       //只使用转换函数和批处理流程, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_INPUTS         (1000000)
+#define TEST_BATCH          (8)
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+//随机纳秒时间, 一半均匀分布在整个可表示范围内, 一半落在GPS起点前后10万秒内
+static time_ns_t test_random_ns(uint64_t *pstate)
+{
+    const uint64_t span = (uint64_t)TIME_NS_SECONDS_MAX * TIME_NS_PER_SECOND;
+    uint64_t v = test_rand(pstate);
+
+    if (v & 1) {
+        return (time_ns_t)(v % (2 * span + 1) - span);
+    }
+
+    return (time_ns_t)(v % (200000 * TIME_NS_PER_SECOND)) - 100000 * TIME_NS_PER_SECOND;
+}
+
+//四种表示转回纳秒时间都要得到ns
+static size_t test_round_trip(time_ns_t ns)
+{
+    gps_time_t gt;
+    common_time_t ct;
+    julianday_t jd;
+    doy_t doy;
+    time_ns_t back[4];
+    int rv[4];
+    size_t mismatch = 0;
+    int k;
+
+    time_conver_ns_to_gpstime(&ns, &gt);
+    time_conver_ns_to_commontime(&ns, &ct);
+    time_conver_ns_to_julianday(&ns, &jd);
+    time_conver_ns_to_doy(&ns, &doy);
+    rv[0] = time_conver_gpstime_to_ns(&gt, &back[0]);
+    rv[1] = time_conver_commontime_to_ns(&ct, &back[1]);
+    rv[2] = time_conver_julianday_to_ns(&jd, &back[2]);
+    rv[3] = time_conver_doy_to_ns(&doy, &back[3]);
+    for (k = 0; k < 4; k++) {
+        if (rv[k] != 0 || back[k] != ns) {
+            if (mismatch++ == 0) {
+                printf("round trip %lld: type %d rv %d back %lld\n", (long long)ns, k, rv[k], (long long)back[k]);
+            }
+        }
+    }
+
+    return mismatch;
+}
+
+//范围边界: 最大、最小整秒数可以转换, 再多一秒或秒小数不在(-1, 1)内时返回-1
+static size_t test_bounds(void)
+{
+    static const struct {
+        int wn;
+        long sn;
+        double tos;
+        int rv;
+    } gps[] = {
+        { (int)(TIME_NS_SECONDS_MAX / ONE_WEEK_SECONDS), (long)(TIME_NS_SECONDS_MAX % ONE_WEEK_SECONDS), 0.999999999, 0 },
+        { (int)(TIME_NS_SECONDS_MAX / ONE_WEEK_SECONDS), (long)(TIME_NS_SECONDS_MAX % ONE_WEEK_SECONDS) + 1, 0.0, -1 },
+        { -(int)(TIME_NS_SECONDS_MAX / ONE_WEEK_SECONDS), -(long)(TIME_NS_SECONDS_MAX % ONE_WEEK_SECONDS), 0.0, 0 },
+        { -(int)(TIME_NS_SECONDS_MAX / ONE_WEEK_SECONDS), -(long)(TIME_NS_SECONDS_MAX % ONE_WEEK_SECONDS) - 1, 0.0, -1 },
+        { 20000, 0, 0.0, -1 },
+        { -20000, 0, 0.0, -1 },
+        { 2000000000, 0, 0.0, -1 },
+        { 1617, 0, 1.0, -1 },
+        { 1617, 0, -1.0, -1 },
+        { 1617, 0, -0.5, 0 },
+    };
+    static const struct {
+        int year;
+        int rv;
+    } years[] = {
+        { 1689, 0 }, { 2261, 0 }, { 1600, -1 }, { 2300, -1 }, { 9999, -1 }, { 65535, -1 },
+    };
+    gps_time_t gt;
+    common_time_t ct;
+    julianday_t jd;
+    doy_t doy;
+    time_ns_t ns;
+    size_t mismatch = 0;
+    size_t i;
+    int rv[3];
+
+    for (i = 0; i < sizeof(gps) / sizeof(gps[0]); i++) {
+        gt.wn = gps[i].wn;
+        gt.tow.sn = gps[i].sn;
+        gt.tow.tos = gps[i].tos;
+        if (time_conver_gpstime_to_ns(&gt, &ns) != gps[i].rv) {
+            printf("bounds: gps %d %ld %g\n", gps[i].wn, gps[i].sn, gps[i].tos);
+            mismatch++;
+        }
+    }
+
+    gt.wn = 1617;
+    gt.tow.sn = 0;
+    gt.tow.tos = NAN;
+    if (time_conver_gpstime_to_ns(&gt, &ns) != -1) {
+        printf("bounds: gps tos nan\n");
+        mismatch++;
+    }
+
+    for (i = 0; i < sizeof(years) / sizeof(years[0]); i++) {
+        ct.year = years[i].year;
+        ct.month = 7;
+        ct.day = 1;
+        ct.hour = 0;
+        ct.minute = 0;
+        ct.second = 0.0;
+        doy.year = (unsigned short)years[i].year;
+        doy.day = 182;
+        doy.tod.sn = 0;
+        doy.tod.tos = 0.0;
+        time_conver_commontime_to_julianday(&ct, &jd);
+        rv[0] = time_conver_commontime_to_ns(&ct, &ns);
+        rv[1] = time_conver_doy_to_ns(&doy, &ns);
+        rv[2] = time_conver_julianday_to_ns(&jd, &ns);
+        if (rv[0] != years[i].rv || rv[1] != years[i].rv || rv[2] != years[i].rv) {
+            printf("bounds: year %d: ct %d doy %d jd %d\n", years[i].year, rv[0], rv[1], rv[2]);
+            mismatch++;
+        }
+    }
+
+    //各部分单独就超出范围, 不能先相乘再检查
+    jd.day = LONG_MAX;
+    jd.tod.sn = 0;
+    jd.tod.tos = 0.0;
+    rv[0] = time_conver_julianday_to_ns(&jd, &ns);
+    jd.day = TIME_GPS_EPOCH_JD;
+    jd.tod.sn = LONG_MIN;
+    rv[1] = time_conver_julianday_to_ns(&jd, &ns);
+    gt.wn = 0;
+    gt.tow.sn = LONG_MAX;
+    gt.tow.tos = 0.0;
+    rv[2] = time_conver_gpstime_to_ns(&gt, &ns);
+    if (rv[0] != -1 || rv[1] != -1 || rv[2] != -1) {
+        printf("bounds: jd day %d, jd sn %d, gps sn %d\n", rv[0], rv[1], rv[2]);
+        mismatch++;
+    }
+    ct.year = INT_MAX;
+    ct.month = 1;
+    ct.day = 1;
+    ct.hour = INT_MAX;
+    ct.minute = INT_MIN;
+    ct.second = 1e300;
+    if (time_conver_commontime_to_ns(&ct, &ns) != -1) {
+        printf("bounds: ct %d\n", ct.year);
+        mismatch++;
+    }
+    ct.second = 0.0;
+    if (time_conver_commontime_to_ns(&ct, &ns) != -1) {
+        printf("bounds: ct %d\n", ct.year);
+        mismatch++;
+    }
+
+    return mismatch;
+}
+
+//批量转换: 越界的时间不输出, 行号随输出压缩, 越界时间的行号依次写入bad
+static size_t test_batch(void)
+{
+    static const int wn[TEST_BATCH] = { 1617, 20000, 1618, 1619, -20000, 2000000000, 1620, 0 };
+    gps_time_t gt[TEST_BATCH];
+    time_ns_t ns[TEST_BATCH], want;
+    size_t line[TEST_BATCH], bad[TEST_BATCH];
+    size_t mismatch = 0;
+    size_t i, m, k, nbad;
+
+    for (i = 0; i < TEST_BATCH; i++) {
+        gt[i].wn = wn[i];
+        gt[i].tow.sn = (long)i;
+        gt[i].tow.tos = 0.25;
+        line[i] = 100 + i;
+    }
+
+    m = time_conver_gpstime_to_ns_batch(gt, ns, TEST_BATCH, line, bad);
+    for (i = 0, k = 0, nbad = 0; i < TEST_BATCH; i++) {
+        if (time_conver_gpstime_to_ns(&gt[i], &want) != 0) {
+            if (nbad >= TEST_BATCH - m || bad[nbad++] != 100 + i) {
+                mismatch++;
+            }
+            continue;
+        }
+        if (k >= m || ns[k] != want || line[k] != 100 + i) {
+            mismatch++;
+        }
+        k++;
+    }
+    if (k != m || nbad != TEST_BATCH - m || m != 5) {
+        mismatch++;
+    }
+    if (mismatch) {
+        printf("batch: %zu of %d converted\n", m, TEST_BATCH);
+    }
+
+    return mismatch;
+}
+
+/*
+ * 差分编码批处理: --since丢弃第1行, 第3、5行越界按原行号报告, 第2、4行编码;
+ * 解码得到第2、4行的GPS时. 报告的行号与错误数都要正确.
+ */
+static size_t test_encode(void)
+{
+    static const char text[] = "1617 0\n1617 1.5\n20000 0\n1618 302400\n30000 5\n";
+    time_batch_ctx_t ctx;
+    time_delta_encoder_t enc;
+    time_delta_decoder_t dec;
+    gps_time_t gt[TEST_BATCH];
+    uint8_t buf[256];
+    size_t mismatch = 0;
+    size_t len, n;
+    FILE *fp;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.from = TIME_GPS;
+    ctx.nthread = 1;
+    ctx.pb = malloc(sizeof(*ctx.pb));
+    ctx.out = malloc(TIME_DELTA_BOUND(TIME_BATCH_RECORDS));
+    fp = tmpfile();
+    if (ctx.pb == NULL || ctx.out == NULL || fp == NULL) {
+        printf("encode: no memory\n");
+        return 1;
+    }
+    ctx.pb->n = 0;
+    ctx.out_fd = fileno(fp);
+    ctx.has_since = true;
+    ctx.since.gt.wn = 1617;
+    ctx.since.gt.tow.sn = 1;
+    ctx.since.gt.tow.tos = 0.0;
+    time_delta_encoder_init(&enc);
+    ctx.delta = &enc;
+
+    if (time_batch_feed(&ctx, text, sizeof(text) - 1, true) != sizeof(text) - 1 || time_batch_flush(&ctx) != 0
+        || time_write_all(ctx.out_fd, ctx.out, time_delta_finish(&enc, (uint8_t *)ctx.out)) != 0) {
+        printf("encode: failed\n");
+        mismatch++;
+    }
+    if (ctx.errors != 2 || ctx.pb->bad[0] != 3 || ctx.pb->bad[1] != 5) {
+        printf("encode: %zu errors, lines %zu %zu\n", ctx.errors, ctx.pb->bad[0], ctx.pb->bad[1]);
+        mismatch++;
+    }
+
+    rewind(fp);
+    len = fread(buf, 1, sizeof(buf), fp);
+    time_delta_decoder_init(&dec, buf, len);
+    if (time_delta_decode(&dec, gt, NULL, NULL, NULL, TEST_BATCH, &n) != 0 || n != 2
+        || gt[0].wn != 1617 || gt[0].tow.sn != 1 || gt[0].tow.tos != 0.5
+        || gt[1].wn != 1618 || gt[1].tow.sn != 302400 || gt[1].tow.tos != 0.0) {
+        printf("encode: decoded %zu epochs\n", n);
+        mismatch++;
+    }
+
+    fclose(fp);
+    free(ctx.pb);
+    free(ctx.out);
+
+    return mismatch;
+}
+
+int main(void)
+{
+    uint64_t state = 20110106ULL;
+    const time_ns_t edge[] = {
+        0, -1, 1, TIME_NS_SECONDS_MAX * TIME_NS_PER_SECOND, -TIME_NS_SECONDS_MAX * TIME_NS_PER_SECOND,
+        TIME_NS_SECONDS_MAX * TIME_NS_PER_SECOND + TIME_NS_PER_SECOND - 1,
+    };
+    size_t mismatch = 0;
+    size_t i;
+
+    for (i = 0; i < sizeof(edge) / sizeof(edge[0]); i++) {
+        mismatch += test_round_trip(edge[i]);
+    }
+    for (i = 0; i < TEST_INPUTS; i++) {
+        mismatch += test_round_trip(test_random_ns(&state));
+    }
+    mismatch += test_bounds();
+    mismatch += test_batch();
+    mismatch += test_encode();
+
+    printf("%zu mismatches\n", mismatch);
+    puts(mismatch ? "FAIL" : "PASS");
+
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * time_conver.c文本解析测试:
+ *     通用时、年积日的越界字段和多余的秒数字必须被拒绝, 有效的边界值(闰日、跳秒)必须被接受;
+ *     16-18位小数秒的解码结果与strtod逐位相同.
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_parse_test tests/time_parse_test.c && ./time_parse_test
+ */
+#define main time_conver_main       //只使用解析函数, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_FRAC_ROUNDS    (2000000)
+
+static const char *const g_ct_bad[] = {
+    "2011-01-06T19:38:455Z", "2011-13-45T25:61:00Z", "2011-00-06T19:38:45", "2011-02-29T00:00:00",
+    "2011-04-31T00:00:00", "2011-01-06T24:00:00", "2011-01-06T19:60:00", "2011-01-06T19:38:61",
+    "20110106246000", "20110106196000", "201101061938455", "20110100193845"
+};
+
+static const char *const g_ct_good[] = {
+    "2012-02-29T23:59:60.5Z", "2011-01-06 19:38:45", "20110106193845.26", "20161231235960"
+};
+
+static const char *const g_doy_bad[] = {
+    "2023:0:0", "2023:366:0", "2023:367:0", "70000:1:0", "-1:1:0", "2023:1:-1", "2023:1:-0.5", "2023:1:86401"
+};
+
+static const char *const g_doy_good[] = { "2024:366:0", "2023:365:86400", "11:006:70725.26" };
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+//随机的16-18位小数(一半为接近舍入中点的长串0), 经time_parse_frac和time_parse_commontime解码, 与strtod比较
+static int test_frac(void)
+{
+    uint64_t state = 20110106ULL;
+    common_time_t ct;
+    char digits[32], text[64];
+    long long num;
+    int i, k, nd, isec;
+
+    for (i = 0; i < TEST_FRAC_ROUNDS; i++) {
+        nd = 16 + (int)(test_rand(&state) % 3);
+        num = 0;
+        for (k = 0; k < nd; k++) {
+            digits[k] = (char)('0' + (i & 1 && k > 0 && k < nd - 3 ? 0 : (int)(test_rand(&state) >> 60) % 10));
+            num = num * 10 + (digits[k] - '0');
+        }
+        digits[nd] = '\0';
+
+        snprintf(text, sizeof(text), "0.%s", digits);
+        if (time_parse_frac(num, nd) != strtod(text, NULL)) {
+            printf("time_parse_frac: %s\n", text);
+            return -1;
+        }
+
+        isec = (int)(test_rand(&state) % 61);
+        snprintf(text, sizeof(text), "2011-01-06T19:38:%02d.%s", isec, digits);
+        if (time_parse_commontime(text, strlen(text), &ct) != 0 || ct.second != strtod(text + 17, NULL)) {
+            printf("time_parse_commontime: %s\n", text);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    common_time_t ct;
+    doy_t doy;
+    size_t i;
+    int fail = 0;
+
+    for (i = 0; i < sizeof(g_ct_bad) / sizeof(g_ct_bad[0]); i++) {
+        if (time_parse_commontime(g_ct_bad[i], strlen(g_ct_bad[i]), &ct) == 0) {
+            printf("accepted: %s\n", g_ct_bad[i]);
+            fail = 1;
+        }
+    }
+    for (i = 0; i < sizeof(g_ct_good) / sizeof(g_ct_good[0]); i++) {
+        if (time_parse_commontime(g_ct_good[i], strlen(g_ct_good[i]), &ct) != 0) {
+            printf("rejected: %s\n", g_ct_good[i]);
+            fail = 1;
+        }
+    }
+    for (i = 0; i < sizeof(g_doy_bad) / sizeof(g_doy_bad[0]); i++) {
+        if (time_parse_doy(g_doy_bad[i], strlen(g_doy_bad[i]), &doy) == 0) {
+            printf("accepted: %s\n", g_doy_bad[i]);
+            fail = 1;
+        }
+    }
+    for (i = 0; i < sizeof(g_doy_good) / sizeof(g_doy_good[0]); i++) {
+        if (time_parse_doy(g_doy_good[i], strlen(g_doy_good[i]), &doy) != 0) {
+            printf("rejected: %s\n", g_doy_good[i]);
+            fail = 1;
+        }
+    }
+    if (test_frac() != 0) {
+        fail = 1;
+    }
+
+    puts(fail ? "FAIL" : "PASS");
+
+    return fail;
+}
@@ -0,0 +1,112 @@
+/*
+ * RINEX历元索引测试: 随机时刻(秒为F11.7, 7位小数)的RINEX 3观测文件经time_rinex_scan输出,
+ *     GPS周内秒、年积日天内秒的小数部分必须与历元行上的小数逐位相同, 不能带入整数秒相加的舍入.
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_rinex_test tests/time_rinex_test.c && ./time_rinex_test
+ */
+#define main time_conver_main       //只使用RINEX扫描函数, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_EPOCHS         (20000)
+#define TEST_LINE_MAX       (64)
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+int main(void)
+{
+    static const char header[] =
+        "     3.04           OBSERVATION DATA    M                   RINEX VERSION / TYPE\n"
+        "                                                            END OF HEADER       \n";
+    uint64_t state = 20110106ULL;
+    time_batch_ctx_t ctx;
+    char *data, *p, *end, *field, *text;
+    char expect[16];
+    long *sn;
+    char (*frac)[8];
+    FILE *fp;
+    size_t i, size, mismatch = 0;
+    long tow, sod;
+    double tos, tow_tos, sod_tos;
+    int hour, minute, isec;
+
+    data = malloc(sizeof(header) + (size_t)TEST_EPOCHS * TEST_LINE_MAX);
+    text = malloc((size_t)TEST_EPOCHS * TEST_LINE_MAX * 2);
+    sn = malloc(sizeof(*sn) * TEST_EPOCHS);
+    frac = malloc(sizeof(*frac) * TEST_EPOCHS);
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.out = malloc((size_t)TIME_BATCH_RECORDS * TIME_MAX * (TIME_FMT_TIME_MAX + 1));
+    fp = tmpfile();
+    if (data == NULL || text == NULL || sn == NULL || frac == NULL || ctx.out == NULL || fp == NULL) {
+        puts("FAIL");
+        return 1;
+    }
+
+    //2011-01-06当天的随机时刻, 该日为GPS周第4天
+    p = data + sprintf(data, "%s", header);
+    for (i = 0; i < TEST_EPOCHS; i++) {
+        hour = (int)(test_rand(&state) % ONE_DAY_HOURS);
+        minute = (int)(test_rand(&state) % ONE_HOUR_MINUTES);
+        isec = (int)(test_rand(&state) % ONE_MINUTE_SECONDS);
+        snprintf(frac[i], sizeof(frac[i]), "%07u", (unsigned)(test_rand(&state) % 10000000));
+        sn[i] = 4L * ONE_DAY_SECONDS + hour * 3600L + minute * 60L + isec;
+        p += sprintf(p, "> 2011 01 06 %2d %2d %2d.%s  0  0\n", hour, minute, isec, frac[i]);
+    }
+
+    ctx.out_fd = fileno(fp);
+    time_stream_init(&ctx.stream);
+    if (time_rinex_scan(&ctx, data, (size_t)(p - data)) != 0) {
+        puts("FAIL");
+        return 1;
+    }
+    size = (size_t)lseek(ctx.out_fd, 0, SEEK_END);
+    lseek(ctx.out_fd, 0, SEEK_SET);
+    if (read(ctx.out_fd, text, size) != (ssize_t)size) {
+        puts("FAIL");
+        return 1;
+    }
+    text[size] = '\0';
+
+    //每行: 字节偏移,周数,周内秒,年,年积日,天内秒
+    p = text;
+    for (i = 0; i < TEST_EPOCHS && *p != '\0'; i++) {
+        end = strchr(p, '\n');
+        *end = '\0';
+        snprintf(expect, sizeof(expect), "0.%s", frac[i]);
+        tos = strtod(expect, NULL);
+        field = strchr(strchr(p, ',') + 1, ',') + 1;
+        tow = strtol(field, &field, 10);
+        tow_tos = (*field == '.') ? strtod(field, NULL) : 0.0;
+        field = strrchr(p, ',') + 1;
+        sod = strtol(field, &field, 10);
+        sod_tos = (*field == '.') ? strtod(field, NULL) : 0.0;
+        if (tow != sn[i] || tow_tos != tos || sod != sn[i] - 4L * ONE_DAY_SECONDS || sod_tos != tos) {
+            if (mismatch++ < 5) {
+                printf("%ld.%s -> %s\n", sn[i], frac[i], p);
+            }
+        }
+        p = end + 1;
+    }
+    if (i != TEST_EPOCHS) {
+        mismatch++;
+    }
+
+    fclose(fp);
+    free(ctx.out);
+    free(frac);
+    free(sn);
+    free(text);
+    free(data);
+
+    printf("%zu mismatches\n", mismatch);
+    puts(mismatch ? "FAIL" : "PASS");
+
+    return mismatch ? 1 : 0;
+}
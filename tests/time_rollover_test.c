@@ -0,0 +1,77 @@
+/*
+ * GPS周数翻转解算测试: 10位、13位截断周数的解算结果与截断前同余且落在[参考周 - 周期/2, 参考周 + 周期/2)内,
+ *     恰好相差半个周期时取参考周之前的一周; 滑动窗口下按时间顺序的截断周数连续跨越多次翻转后还原为原周数.
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_rollover_test tests/time_rollover_test.c && ./time_rollover_test
+ */
+#define main time_conver_main       //只使用解算函数, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_ROUNDS         (1000000)
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+int main(void)
+{
+    static const int bits[2] = { TIME_ROLLOVER_BITS_LEGACY, TIME_ROLLOVER_BITS_CNAV };
+    uint64_t state = 20110106ULL;
+    time_rollover_t ro;
+    gps_time_t gt[64];
+    size_t mismatch = 0;
+    int i, b, m, ref, wn, full, week;
+
+    for (b = 0; b < 2; b++) {
+        m = 1 << bits[b];
+
+        //恰好相差半个周期: 参考周之前的一周在区间内, 之后的一周不在
+        time_rollover_init(&ro, bits[b], 2 * m, false);
+        if (time_rollover_week(&ro, m / 2) != 2 * m - m / 2) {
+            printf("bits %d: half period\n", bits[b]);
+            mismatch++;
+        }
+
+        for (i = 0; i < TEST_ROUNDS; i++) {
+            ref = (int)(test_rand(&state) % 8192);
+            wn = (int)(test_rand(&state) % (2 * (unsigned)m));
+            time_rollover_init(&ro, bits[b], ref, false);
+            full = time_rollover_week(&ro, wn);
+            if ((full - wn) % m != 0 || full < ref - m / 2 || full >= ref + m / 2) {
+                if (mismatch++ < 5) {
+                    printf("bits %d: ref %d wn %d -> %d\n", bits[b], ref, wn, full);
+                }
+            }
+        }
+
+        //滑动窗口: 每批64个历元, 相邻历元最多前进一个周期的1/4
+        time_rollover_init(&ro, bits[b], 0, true);
+        week = 0;
+        for (i = 0; i < TEST_ROUNDS / 1000; i++) {
+            for (wn = 0; wn < 64; wn++) {
+                week += (int)(test_rand(&state) % (unsigned)(m / 4));
+                gt[wn].wn = week % m;
+                gt[wn].tow.sn = 0;
+                gt[wn].tow.tos = 0.0;
+            }
+            time_rollover_resolve_batch(&ro, gt, 64);
+            if (gt[63].wn != week) {
+                if (mismatch++ < 5) {
+                    printf("bits %d: sliding %d -> %d\n", bits[b], week, gt[63].wn);
+                }
+                break;
+            }
+        }
+    }
+
+    printf("%zu mismatches\n", mismatch);
+    puts(mismatch ? "FAIL" : "PASS");
+
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,249 @@
+/*
+ * 列存储(SoA)转换测试: 随机GPS时、儒略日、通用时(含两位年份, 天内秒、周内秒超出范围或为负)按列存放,
+ *     time_conver_*_soa(运行时分派)以及本机支持的每一级SIMD内核(AVX-512、AVX2)加标量尾部的结果,
+ *     必须与结构体数组的批量转换time_conver_*_batch逐位相同; 长度取0到40及不是8的倍数的大数组, 覆盖尾部处理.
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_soa_test tests/time_soa_test.c && ./time_soa_test
+ */
+#define main time_conver_main       //只使用转换函数, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_INPUTS         (100003)
+#define TEST_LEVELS         (3)         //0: 分派入口, 1: AVX2, 2: AVX-512
+
+static gps_time_t g_gt[TEST_INPUTS], g_gt_ref[TEST_INPUTS];
+static julianday_t g_jd[TEST_INPUTS], g_jd_ref[TEST_INPUTS];
+static common_time_t g_ct[TEST_INPUTS], g_ct_ref[TEST_INPUTS];
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+static void test_generate(void)
+{
+    static const int mdays[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    uint64_t state = 20110106ULL;
+    size_t i;
+
+    for (i = 0; i < TEST_INPUTS; i++) {
+        g_gt[i].wn = (int)(test_rand(&state) % 5000) - 500;
+        g_gt[i].tow.sn = (i % 4) ? (long)(test_rand(&state) % ONE_WEEK_SECONDS)
+            : (long)(test_rand(&state) % (3 * ONE_WEEK_SECONDS)) - ONE_WEEK_SECONDS;
+        g_gt[i].tow.tos = (double)(test_rand(&state) % 1000000) / 1e6;
+
+        g_jd[i].day = 2440000 + (long)(test_rand(&state) % 40000);
+        g_jd[i].tod.sn = (i % 4) ? (long)(test_rand(&state) % ONE_DAY_SECONDS)
+            : (long)(test_rand(&state) % (3 * ONE_DAY_SECONDS)) - ONE_DAY_SECONDS;
+        g_jd[i].tod.tos = (double)(test_rand(&state) % 1000000) / 1e6;
+
+        g_ct[i].year = (i % 5 == 0) ? (int)(test_rand(&state) % 100) : 1900 + (int)(test_rand(&state) % 300);
+        g_ct[i].month = 1 + (int)(test_rand(&state) % 12);
+        g_ct[i].day = 1 + (int)(test_rand(&state) % (unsigned)mdays[g_ct[i].month - 1]);
+        g_ct[i].hour = (int)(test_rand(&state) % ONE_DAY_HOURS);
+        g_ct[i].minute = (int)(test_rand(&state) % ONE_HOUR_MINUTES);
+        g_ct[i].second = (double)(test_rand(&state) % ONE_MINUTE_SECONDS) + (double)(test_rand(&state) % 1000000) / 1e6;
+    }
+}
+
+static bool test_level_supported(int level)
+{
+#if TIME_SIMD_X86
+    switch (level) {
+        case 1:
+            return time_simd_level() >= TIME_SIMD_AVX2;
+        case 2:
+            return time_simd_level() >= TIME_SIMD_AVX512;
+        default:
+            return true;
+    }
+#else
+    return level == 0;
+#endif
+}
+
+//按level转换n个元素: 0为分派入口, 其余为指定的SIMD内核加标量尾部
+static void test_jd_to_gps(int level, const julianday_soa_t *pjd, gps_time_soa_t *pgt)
+{
+    size_t done = 0;
+
+#if TIME_SIMD_X86
+    if (level == 1) {
+        done = time_soa_julianday_to_gpstime_avx2(pjd, pgt);
+    } else if (level == 2) {
+        done = time_soa_julianday_to_gpstime_avx512(pjd, pgt);
+    }
+#endif
+    if (level == 0) {
+        time_conver_julianday_to_gpstime_soa(pjd, pgt);
+    } else {
+        time_soa_julianday_to_gpstime_scalar(pjd, pgt, done);
+    }
+}
+
+static void test_gps_to_jd(int level, const gps_time_soa_t *pgt, julianday_soa_t *pjd)
+{
+    size_t done = 0;
+
+#if TIME_SIMD_X86
+    if (level == 1) {
+        done = time_soa_gpstime_to_julianday_avx2(pgt, pjd);
+    } else if (level == 2) {
+        done = time_soa_gpstime_to_julianday_avx512(pgt, pjd);
+    }
+#endif
+    if (level == 0) {
+        time_conver_gpstime_to_julianday_soa(pgt, pjd);
+    } else {
+        time_soa_gpstime_to_julianday_scalar(pgt, pjd, done);
+    }
+}
+
+static void test_gps_to_ct(int level, const gps_time_soa_t *pgt, common_time_soa_t *pct)
+{
+    size_t done = 0;
+
+#if TIME_SIMD_X86
+    if (level == 1) {
+        done = time_soa_gpstime_to_commontime_avx2(pgt, pct);
+    } else if (level == 2) {
+        done = time_soa_gpstime_to_commontime_avx512(pgt, pct);
+    }
+#endif
+    if (level == 0) {
+        time_conver_gpstime_to_commontime_soa(pgt, pct);
+    } else {
+        time_soa_gpstime_to_commontime_scalar(pgt, pct, done);
+    }
+}
+
+static void test_ct_to_gps(int level, const common_time_soa_t *pct, gps_time_soa_t *pgt)
+{
+    size_t done = 0;
+
+#if TIME_SIMD_X86
+    if (level == 1) {
+        done = time_soa_commontime_to_gpstime_avx2(pct, pgt);
+    } else if (level == 2) {
+        done = time_soa_commontime_to_gpstime_avx512(pct, pgt);
+    }
+#endif
+    if (level == 0) {
+        time_conver_commontime_to_gpstime_soa(pct, pgt);
+    } else {
+        time_soa_commontime_to_gpstime_scalar(pct, pgt, done);
+    }
+}
+
+//前n个元素与结构体数组的批量转换结果比较, 返回不同的个数
+static size_t test_run(int level, size_t n, gps_time_soa_t *pgt, julianday_soa_t *pjd, common_time_soa_t *pct)
+{
+    size_t i, mismatch = 0;
+
+    pgt->n = n;
+    pjd->n = n;
+    pct->n = n;
+
+    //JD -> GPS
+    for (i = 0; i < n; i++) {
+        pjd->day[i] = (int)g_jd[i].day;
+        pjd->tod_sn[i] = (int)g_jd[i].tod.sn;
+        pjd->tod_tos[i] = g_jd[i].tod.tos;
+    }
+    time_conver_julianday_to_gpstime_batch(g_jd, g_gt_ref, n);
+    test_jd_to_gps(level, pjd, pgt);
+    for (i = 0; i < n; i++) {
+        if (pgt->wn[i] != g_gt_ref[i].wn || pgt->tow_sn[i] != g_gt_ref[i].tow.sn
+            || pgt->tow_tos[i] != g_gt_ref[i].tow.tos) {
+            if (mismatch++ < 5) {
+                printf("level %d jd->gps: %ld %ld\n", level, g_jd[i].day, g_jd[i].tod.sn);
+            }
+        }
+    }
+
+    //GPS -> JD, GPS -> 通用时
+    for (i = 0; i < n; i++) {
+        pgt->wn[i] = g_gt[i].wn;
+        pgt->tow_sn[i] = (int)g_gt[i].tow.sn;
+        pgt->tow_tos[i] = g_gt[i].tow.tos;
+    }
+    time_conver_gpstime_to_julianday_batch(g_gt, g_jd_ref, n);
+    test_gps_to_jd(level, pgt, pjd);
+    time_conver_gpstime_to_commontime_batch(g_gt, g_ct_ref, n);
+    test_gps_to_ct(level, pgt, pct);
+    for (i = 0; i < n; i++) {
+        if (pjd->day[i] != g_jd_ref[i].day || pjd->tod_sn[i] != g_jd_ref[i].tod.sn
+            || pjd->tod_tos[i] != g_jd_ref[i].tod.tos
+            || pct->year[i] != g_ct_ref[i].year || pct->month[i] != g_ct_ref[i].month || pct->day[i] != g_ct_ref[i].day
+            || pct->hour[i] != g_ct_ref[i].hour || pct->minute[i] != g_ct_ref[i].minute
+            || pct->second[i] != g_ct_ref[i].second) {
+            if (mismatch++ < 5) {
+                printf("level %d gps->jd/ct: %d %ld\n", level, g_gt[i].wn, g_gt[i].tow.sn);
+            }
+        }
+    }
+
+    //通用时 -> GPS
+    for (i = 0; i < n; i++) {
+        pct->year[i] = g_ct[i].year;
+        pct->month[i] = g_ct[i].month;
+        pct->day[i] = g_ct[i].day;
+        pct->hour[i] = g_ct[i].hour;
+        pct->minute[i] = g_ct[i].minute;
+        pct->second[i] = g_ct[i].second;
+    }
+    time_conver_commontime_to_gpstime_batch(g_ct, g_gt_ref, n);
+    test_ct_to_gps(level, pct, pgt);
+    for (i = 0; i < n; i++) {
+        if (pgt->wn[i] != g_gt_ref[i].wn || pgt->tow_sn[i] != g_gt_ref[i].tow.sn
+            || pgt->tow_tos[i] != g_gt_ref[i].tow.tos) {
+            if (mismatch++ < 5) {
+                printf("level %d ct->gps: %d-%d-%d %d:%d:%.6f\n", level, g_ct[i].year, g_ct[i].month, g_ct[i].day,
+                    g_ct[i].hour, g_ct[i].minute, g_ct[i].second);
+            }
+        }
+    }
+
+    return mismatch;
+}
+
+int main(void)
+{
+    gps_time_soa_t gt;
+    julianday_soa_t jd;
+    common_time_soa_t ct;
+    size_t n, mismatch = 0;
+    int level;
+
+    test_generate();
+    if (time_soa_gps_alloc(&gt, TEST_INPUTS) != 0 || time_soa_jd_alloc(&jd, TEST_INPUTS) != 0
+        || time_soa_ct_alloc(&ct, TEST_INPUTS) != 0) {
+        puts("FAIL");
+        return 1;
+    }
+
+    for (level = 0; level < TEST_LEVELS; level++) {
+        if (!test_level_supported(level)) {
+            printf("level %d not supported, skipped\n", level);
+            continue;
+        }
+        for (n = 0; n <= 40; n++) {
+            mismatch += test_run(level, n, &gt, &jd, &ct);
+        }
+        mismatch += test_run(level, TEST_INPUTS, &gt, &jd, &ct);
+    }
+
+    time_soa_gps_free(&gt);
+    time_soa_jd_free(&jd);
+    time_soa_ct_free(&ct);
+
+    printf("%zu mismatches\n", mismatch);
+    puts(mismatch ? "FAIL" : "PASS");
+
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * time_stream_t测试: 随机通用时(含两位年份, 以及月份0、13、14和日期0、超出当月天数等无效日期)
+ *     经time_stream_commontime转换的GPS时、儒略日、年积日必须与单点转换time_conver_commontime_to_*相同,
+ *     无效日期不能越界读取月份表(用-fsanitize=address编译可检查).
+ * 编译运行:
+ *     gcc -O2 -pthread -o time_stream_test tests/time_stream_test.c && ./time_stream_test
+ */
+#define main time_conver_main       //只使用转换函数, 不运行命令行
+#include "../time_conver.c"
+#undef main
+
+#define TEST_ROUNDS         (2000000)
+
+static uint64_t test_rand(uint64_t *pstate)
+{
+    *pstate ^= *pstate >> 12;
+    *pstate ^= *pstate << 25;
+    *pstate ^= *pstate >> 27;
+
+    return *pstate * 2685821657736338717ULL;
+}
+
+int main(void)
+{
+    uint64_t state = 20110106ULL;
+    time_stream_t stream;
+    common_time_t ct;
+    gps_time_t gt, gt_ref;
+    julianday_t jd, jd_ref;
+    doy_t doy, doy_ref;
+    size_t mismatch = 0;
+    uint64_t r;
+    int i;
+
+    time_stream_init(&stream);
+    for (i = 0; i < TEST_ROUNDS; i++) {
+        r = test_rand(&state);
+        ct.year = (i % 5 == 0) ? (int)(r % 100) : 1990 + (int)(r % 40);
+        ct.month = (int)((r >> 8) % 15);
+        ct.day = (int)((r >> 16) % 33);
+        ct.hour = (int)((r >> 24) % ONE_DAY_HOURS);
+        ct.minute = (int)((r >> 32) % ONE_HOUR_MINUTES);
+        ct.second = (double)((r >> 40) % ONE_MINUTE_SECONDS) + 0.25;
+
+        time_stream_commontime(&stream, &ct, &gt, &jd, &doy);
+        time_conver_commontime_to_gpstime(&ct, &gt_ref);
+        time_conver_commontime_to_julianday(&ct, &jd_ref);
+        time_conver_commontime_to_doy(&ct, &doy_ref);
+        if (gt.wn != gt_ref.wn || gt.tow.sn != gt_ref.tow.sn || gt.tow.tos != gt_ref.tow.tos
+            || jd.day != jd_ref.day || jd.tod.sn != jd_ref.tod.sn || jd.tod.tos != jd_ref.tod.tos
+            || doy.year != doy_ref.year || doy.day != doy_ref.day || doy.tod.sn != doy_ref.tod.sn
+            || doy.tod.tos != doy_ref.tod.tos) {
+            if (mismatch++ < 5) {
+                printf("%d-%d-%d %d:%d:%g\n", ct.year, ct.month, ct.day, ct.hour, ct.minute, ct.second);
+            }
+        }
+    }
+
+    printf("%zu mismatches\n", mismatch);
+    puts(mismatch ? "FAIL" : "PASS");
+
+    return mismatch ? 1 : 0;
+}
@@ -1,36 +1,54 @@
 /*****************************************************************************
 Copyright (C), 
 File name    : time_conver.c
-Description  : óṩּʱʽ(ͨʱգGPSʱ)໥ת.
+Description  : 该程序提供了四种计时方式(通用时，儒略日，GPS时和年积日)的相互转化.
 Author       : ltp
 Version      : 1.0
 Date         : 2015-01-28
 Others       : 
 ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-1.  ʱ(ͨʱ)(commontime)
-    Ҳƹ, ֱ㷺.һ146097ɵ400Ϊ, 1ƽΪ365.2425.
-    ݸ1걻Ϊ12.ʾʱʱꡢ¡աʱ֡ķ.ּʱӳڱ仯,ճ,
-    ,ѧͿѧ.
-
-2.  (julianday)
-    һֲ漰ꡢµȸĳļշ.ѧռزǵλоʹ.
-    ַScaliger1583ΪĸԶΪ.
-    յ㶩ڹԪǰ4713(ѧϼΪ-4712)11ոʱƽ(ʱ12:00),
-    JD0ָΪ4713 B.C. 1112:00 UT4713 B.C. 1212:00 UT24Сʱÿһ츳һΨһ.
-    λ̫,ѧϻ1973ü(MJD),䶨Ϊ MJD = JD - 2400000.5.
-    MJDӦ18581117ʱ0ʱ 1979101ʱΪ2,444,147.5.
-
-3.  GPSʱ(gpstime)
-    GPSϵͳڲõʱϵͳGPSʱ, GPSʱ198016ҹΪ,(һ)ڵʾ.
-
-4.  (doy)
-    νվָǴÿ11ʼۼƵ1ʼ(ÿ11յΪ1),200451յΪ122.
-    ԷһʱT1T2ʱ
+1.  格里高利时(通用时)(commontime)
+    格里高利历也称公历, 现被世界各国广泛采用.格里高利历是一个由146097天所组成的400年周期为基础, 1年的平均长度为365.2425天.
+    根据格里高利历1年被划分为12个月.其标示时间时采用年、月、日、时、分、秒的方法.这种计时反映季节变化,与日常生活密切相关,
+    但非连续,不利于数学表达和科学计算.
+
+2.  儒略日(julianday)
+    儒略日是一种不涉及年、月等概念的长期连续的记日法.在天文学、空间大地测量和卫星导航定位中经常使用.
+    这种方法是有Scaliger与1583年提出的为纪念他的父亲儒略而命名为儒略日.
+    儒略日的起点订在公元前4713年(天文学上记为-4712年)1月1日格林威治时间平午(世界时12:00),
+    即JD0指定为4713 B.C. 1月1日12:00 UT到4713 B.C. 1月2日12:00 UT的24小时。每一天赋予了一个唯一的数字.
+    由于儒略日数字位数太多,国际天文学联合会于1973年采用简化儒略日(MJD),其定义为 MJD = JD - 2400000.5.
+    MJD相应的起点是1858年11月17日世界时0时。 例如1979年10月1日零时儒略日数为2,444,147.5.
+
+3.  GPS时(gpstime)
+    GPS系统内部所采用的时间系统是GPS时间, GPS时以1980年1月6日子夜为起点,用周数(一个星期七天)和周内的秒数来表示.
+
+4.  年积日(doy)
+    所谓年积日就是指的是从每年的1月1日起开始累计的天数计数从1开始(即每年1月1日的年积日为1),如2004年5月1日的年积日为122.
+    用他可以方便的求出一年内两个时刻T1和T2间的时间间隔。
 *****************************************************************************/
 
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TIME_SIMD_X86       (1)
+#include <immintrin.h>
+#else
+#define TIME_SIMD_X86       (0)
+#endif
 
 #define ONE_HOUR_MINUTES    (60)
 #define ONE_MINUTE_SECONDS  (60)
@@ -38,10 +56,18 @@ Others       :
 #define ONE_DAY_HOURS       (24)
 #define ONE_DAY_MINUTES     (ONE_DAY_HOURS * ONE_HOUR_MINUTES)
 #define ONE_DAY_SECONDS     (ONE_DAY_HOURS * ONE_HOUR_SECONDS)
+#define ONE_WEEK_SECONDS    (7 * ONE_DAY_SECONDS)
+
+#define TIME_GPS_EPOCH_JD   (2444244)   //GPS起点(1980-01-06 0时)所在儒略日的整数部分
+#define TIME_CIVIL_EPOCH_JD (2440587)   //公历引擎第0天(1970-01-01 0时)所在儒略日的整数部分
+#define TIME_GPS_EPOCH_DAYS (3657)      //GPS起点相对1970-01-01的天数
+#define TIME_MJD_EPOCH_JD   (2400000)   //简化儒略日第0天(1858-11-17 0时)所在儒略日的整数部分
+#define TIME_GPS_EPOCH_MJD  (44244)     //GPS起点的简化儒略日
+#define TIME_CIVIL_EPOCH_MJD (40587)    //1970-01-01的简化儒略日
 
 #define TIME_DBG_OPEN       (1) //(memcmp(argv[argc - 1], "dbg", strlen("dbg") == 0))
 
-//ͨʱ
+//通用时
 typedef struct common_time_s {
     int   year;
     int   month;
@@ -52,34 +78,34 @@ typedef struct common_time_s {
 } common_time_t;
 
 typedef struct tod_s {
-    long sn;        // 
-    double tos;     //С 
+    long sn;        //秒数的整数部分 
+    double tos;     //秒数的小数部分 
 } tod_t;
 
-//
+//儒略日
 typedef struct julianday_s{
-    long day;       // 
-    tod_t tod;      //һڵ 
+    long day;       //整数天数 
+    tod_t tod;      //一天内的秒数 
 } julianday_t;
 
-//()
+//新儒略日(简化儒略日)
 typedef struct new_julianday_s {
-    long day;
-    tod_t  tod;
+    long day;       //整数天数 
+    tod_t  tod;     //子夜起的天内秒数 
 } new_julianday_t;
 
 typedef struct tow_s {
-    long sn;        // 
-    double tos;     //С 
+    long sn;        //秒整数部分 
+    double tos;     //秒小数部分 
 } tow_t;
 
-//GPSʱ
+//GPS时
 typedef struct gps_time_s {
-    int wn;         // 
-    tow_t tow;      //һڵ 
+    int wn;         //周数 
+    tow_t tow;      //一周内的秒数 
 } gps_time_t;
 
-//
+//年积日
 typedef struct doy_s {
     unsigned short year;
     unsigned short day;
@@ -91,6 +117,7 @@ typedef enum time_type_e {
     TIME_JULIAN,
     TIME_GPS,
     TIME_doy_t,
+    TIME_MJD,
     TIME_MAX
 } time_type_t;
 
@@ -98,668 +125,7674 @@ typedef enum time_convert_state_e {
     TIME_COMMON_TO_JULIAN,
     TIME_COMMON_TO_GPS,
     TIME_COMMON_TO_doy_t,
+    TIME_COMMON_TO_MJD,
     TIME_COMMON_TO_ALL,
     TIME_JULIAN_TO_COMMON,
     TIME_JULIAN_TO_GPS,
     TIME_JULIAN_TO_doy_t,
+    TIME_JULIAN_TO_MJD,
     TIME_JULIAN_TO_ALL,
     TIME_GPS_TO_COMMON,
     TIME_GPS_TO_JULIAN,
     TIME_GPS_TO_doy_t,
+    TIME_GPS_TO_MJD,
     TIME_GPS_TO_ALL,
     TIME_doy_t_TO_COMMON,
     TIME_doy_t_TO_JULIAN,
     TIME_doy_t_TO_GPS,
-    TIME_doy_t_TO_ALL
+    TIME_doy_t_TO_MJD,
+    TIME_doy_t_TO_ALL,
+    TIME_MJD_TO_COMMON,
+    TIME_MJD_TO_JULIAN,
+    TIME_MJD_TO_GPS,
+    TIME_MJD_TO_doy_t,
+    TIME_MJD_TO_ALL
 } time_convert_state_t;
 
-static gps_time_t g_gt;
-static common_time_t g_ct;
-static julianday_t g_jd;
-static doy_t g_doy;
+/*
+ * 一组五种表示的时间, 由调用者持有. 转换函数只读写传入的上下文, 没有文件级的可变状态,
+ * 不同线程使用各自的上下文即可并发调用.
+ */
+typedef struct time_convert_ctx_s {
+    common_time_t ct;
+    julianday_t jd;
+    gps_time_t gt;
+    doy_t doy;
+    new_julianday_t mjd;
+} time_convert_ctx_t;
+
+// 向下取整的整数除法(b > 0), C语言的'/'向零取整, 负数时需修正
+static long long time_floor_div(long long a, long long b)
+{
+    long long q = a / b;
+
+    if ((a % b) < 0) {
+        q--;
+    }
+
+    return q;
+}
+
+/*
+ * GNSS时代(1980-2200年)日历查找表: 全部由常量表达式在编译期生成, 不占用运行时初始化.
+ * 年表给出每年1月1日的日数(1970-01-01为第0天)、该日0时所在儒略日的整数部分及所在GPS周,
+ * 相邻两项之差即该年天数, 可直接判断闰年; 末尾多一项作为上界.
+ * 日数到年的映射先按365天估算年序号, 至多回退一年, 月份再按31天估算, 至多前进一月, 均为O(1).
+ * 超出表范围时退回公历算法.
+ */
+#define TIME_TABLE_FIRST_YEAR   (1980)
+#define TIME_TABLE_LAST_YEAR    (2200)
+
+#define TIME_LEAPS_BEFORE(y)    (((y) - 1) / 4 - ((y) - 1) / 100 + ((y) - 1) / 400)
+#define TIME_YEAR_START(y)      (365L * ((y) - 1970) + TIME_LEAPS_BEFORE(y) - TIME_LEAPS_BEFORE(1970))
+#define TIME_YEAR_ENTRY(y)      { TIME_YEAR_START(y), TIME_CIVIL_EPOCH_JD + TIME_YEAR_START(y), \
+                                  (int)((TIME_YEAR_START(y) - TIME_GPS_EPOCH_DAYS + 7) / 7 - 1) }
+#define TIME_YEAR_ENTRY10(y)    TIME_YEAR_ENTRY(y), TIME_YEAR_ENTRY(y + 1), TIME_YEAR_ENTRY(y + 2), \
+                                TIME_YEAR_ENTRY(y + 3), TIME_YEAR_ENTRY(y + 4), TIME_YEAR_ENTRY(y + 5), \
+                                TIME_YEAR_ENTRY(y + 6), TIME_YEAR_ENTRY(y + 7), TIME_YEAR_ENTRY(y + 8), \
+                                TIME_YEAR_ENTRY(y + 9)
+
+typedef struct time_year_entry_s {
+    long days;      //1月1日的日数
+    long jd;        //1月1日0时所在儒略日的整数部分
+    int gps_week;   //1月1日所在的GPS周
+} time_year_entry_t;
+
+static const time_year_entry_t g_year_table[TIME_TABLE_LAST_YEAR - TIME_TABLE_FIRST_YEAR + 2] = {
+    TIME_YEAR_ENTRY10(1980), TIME_YEAR_ENTRY10(1990), TIME_YEAR_ENTRY10(2000), TIME_YEAR_ENTRY10(2010),
+    TIME_YEAR_ENTRY10(2020), TIME_YEAR_ENTRY10(2030), TIME_YEAR_ENTRY10(2040), TIME_YEAR_ENTRY10(2050),
+    TIME_YEAR_ENTRY10(2060), TIME_YEAR_ENTRY10(2070), TIME_YEAR_ENTRY10(2080), TIME_YEAR_ENTRY10(2090),
+    TIME_YEAR_ENTRY10(2100), TIME_YEAR_ENTRY10(2110), TIME_YEAR_ENTRY10(2120), TIME_YEAR_ENTRY10(2130),
+    TIME_YEAR_ENTRY10(2140), TIME_YEAR_ENTRY10(2150), TIME_YEAR_ENTRY10(2160), TIME_YEAR_ENTRY10(2170),
+    TIME_YEAR_ENTRY10(2180), TIME_YEAR_ENTRY10(2190), TIME_YEAR_ENTRY(2200), TIME_YEAR_ENTRY(2201)
+};
+
+//平年/闰年各月之前的累计天数, 第13项为全年天数
+static const unsigned short g_month_days_before[2][13] = {
+    { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365 },
+    { 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366 }
+};
 
-// ȡС 
-static double time_get_frac(double morigin)
+static int time_year_in_table(long long year)
 {
-    return (morigin - (long)(morigin));
+    return year >= TIME_TABLE_FIRST_YEAR && year <= TIME_TABLE_LAST_YEAR;
 }
 
-//ͨʱյת
-static void time_conver_commontime_to_julianday(common_time_t *pct, julianday_t *pjd)
+static int time_year_table_leap(const time_year_entry_t *pyt)
 {
-    common_time_t ct;
-    double ut;
+    return (int)(pyt[1].days - pyt[0].days - 365);
+}
 
-    memcpy(&ct, pct, sizeof(ct));
+//查表: 日数到年、年内天数(从0起)和闰年标志, 超出表范围返回0
+static int time_year_table_lookup(long long days, int *pyear, int *pdoy0, int *pleap)
+{
+    long i;
 
-    if (ct.year < 1900) {
-        if (ct.year < 80) {
-            ct.year += 2000;
-        } else {
-            ct.year += 1900;
-        }
+    if (days < g_year_table[0].days
+        || days >= g_year_table[TIME_TABLE_LAST_YEAR - TIME_TABLE_FIRST_YEAR + 1].days) {
+        return 0;
     }
 
-    ut = ct.hour + ct.minute / 60.0 + ct.second / 3600.0;
-
-    if (ct.month <= 2) {
-        ct.year -= 1;
-        ct.month += 12;
+    i = (long)(days - g_year_table[0].days) / 365;
+    if (days < g_year_table[i].days) {
+        i--;
     }
 
-    pjd->day = (int)(365.25 * ct.year) + (int)(30.6001 * (ct.month + 1)) + ct.day
-        + (int)(ut / 24 + 1720981.5);
-    pjd->tod.sn = ((ct.hour + 12) % 24) * 3600 + ct.minute * 60 + (int)ct.second;// 
-    pjd->tod.tos = ct.second - (int)ct.second;//С 
+    *pyear = (int)(TIME_TABLE_FIRST_YEAR + i);
+    *pdoy0 = (int)(days - g_year_table[i].days);
+    *pleap = time_year_table_leap(&g_year_table[i]);
+
+    return 1;
 }
 
-//յͨʱת 
-static void time_conver_julianday_to_commontime(julianday_t *pjd, common_time_t *pct)
+//年内天数(从0起)到月和日, doy0须在[0, 当年天数)内
+static void time_month_from_doy(int doy0, int leap, int *pmonth, int *pday)
 {
-    julianday_t jd;
-    double x;
-    int a, b, c, d, e;
-
-    memcpy(&jd, pjd, sizeof(jd));
+    int m;
 
-    x = jd.day + (jd.tod.sn + jd.tod.tos) / (60.0 * 60.0 * 24);
-    a = (int)(x + 0.5);
-    b = a + 1537;
-    c = (int)((b - 122.1) / 365.25);
-    d = (int)(365.25 * c);
-    e = (int)((b - d) / 30.6001);
+    m = doy0 / 31;
+    if (doy0 >= g_month_days_before[leap][m + 1]) {
+        m++;
+    }
 
-    pct->day = b - d - (int)(30.6001 * e);
-    pct->month = e - 1 - 12 * (int)(e / 14);
-    pct->year = c - 4715 - (int)((7 + pct->month) / 10);
-    pct->hour = (jd.tod.sn / 3600 + 12) % 24;
-    pct->minute = (jd.tod.sn % 3600) / 60;
-    pct->second = jd.tod.sn % 60 + jd.tod.tos;
+    *pmonth = m + 1;
+    *pday = doy0 - g_month_days_before[leap][m] + 1;
 }
 
-//յGPSʱת
-static void time_conver_julianday_to_gpstime(julianday_t *pjd, gps_time_t *pgt)
+/*
+ * 纯整数公历引擎: 以1970-01-01为第0天, 按400年纪元(146097天)划分后只做常数除法,
+ * 在整个前推格里高利历范围内精确, 不受365.25/30.6001浮点公式1900-2100年适用范围和舍入误差的限制.
+ */
+//公历年月日到日数的转换
+static long long time_days_from_civil(long long year, int month, int day)
 {
-    double x;
-    julianday_t jd;
+    long long era, carry;
+    long long yoe, doy, doe;
+    const time_year_entry_t *pyt;
+
+    //月份超出1-12时先进位到年
+    if (month < 1 || month > 12) {
+        carry = time_floor_div(month - 1, 12);
+        year += carry;
+        month = (int)(month - 1 - carry * 12) + 1;
+    }
 
-    memcpy(&jd, pjd, sizeof(jd));
+    if (time_year_in_table(year)) {
+        pyt = &g_year_table[year - TIME_TABLE_FIRST_YEAR];
+        return pyt->days + g_month_days_before[time_year_table_leap(pyt)][month - 1] + day - 1;
+    }
 
-    x = jd.day + (jd.tod.sn + jd.tod.tos) / 86400.0;
+    year -= (month <= 2);
+    era = time_floor_div(year, 400);
+    yoe = year - era * 400;                                         //[0, 399]
+    doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1; //[0, 365], 从3月1日起算
+    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                    //[0, 146096]
 
-    pgt->wn = (int)((x - 2444244.5) / 7);
-    pgt->tow.sn = (int)(((jd.day - 2444244) % 7 + (jd.tod.sn / (86400.0) - 0.5)) * 86400.0);
-    pgt->tow.tos = jd.tod.tos;
+    return era * 146097 + doe - 719468;
 }
 
-//GPSʱյת 
-static void time_conver_gpstime_to_julianday(gps_time_t *pgt, julianday_t *pjd)
+//日数到公历年月日的转换
+static void time_civil_from_days(long long days, int *pyear, int *pmonth, int *pday)
 {
-    gps_time_t gt;
+    long long z, era;
+    long long doe, yoe, doy, mp;
+    int doy0, leap;
+
+    if (time_year_table_lookup(days, pyear, &doy0, &leap)) {
+        time_month_from_doy(doy0, leap, pmonth, pday);
+        return;
+    }
 
-    memcpy(&gt, pgt, sizeof(gt));
-    
-    pjd->day = (int)(gt.wn * 7 + (double)(gt.tow.sn) / 86400.0 + 2444244.5);
-    pjd->tod.sn = (gt.tow.sn + 43200) % 86400;
-    pjd->tod.tos = gt.tow.tos;
+    z = days + 719468;
+    era = time_floor_div(z, 146097);
+    doe = z - era * 146097;
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mp = (5 * doy + 2) / 153;
+
+    *pday = (int)(doy - (153 * mp + 2) / 5 + 1);
+    *pmonth = (int)(mp < 10 ? mp + 3 : mp - 9);
+    *pyear = (int)(yoe + era * 400 + (*pmonth <= 2));
 }
 
-//ͨʱGPSʱת
-static void time_conver_commontime_to_gpstime(common_time_t *pct, gps_time_t *pgt)
+//闰年判断
+static int time_is_leap_year(long long year)
 {
-    julianday_t jd;
-
-    time_conver_commontime_to_julianday(pct, &jd);
-    time_conver_julianday_to_gpstime(&jd, pgt);
-} 
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
 
-//GPSʱͨʱת
-static void time_conver_gpstime_to_commontime(gps_time_t *pgt, common_time_t *pct)
+//年月日是否为有效日期, 有效时才能直接查各月之前的累计天数
+static int time_civil_valid(long long year, int month, int day)
 {
-    julianday_t jd;
+    int leap;
+
+    if (month < 1 || month > 12 || day < 1) {
+        return 0;
+    }
+    leap = time_is_leap_year(year);
 
-    time_conver_gpstime_to_julianday(pgt, &jd);
-    time_conver_julianday_to_commontime(&jd, pct);
+    return day <= g_month_days_before[leap][month] - g_month_days_before[leap][month - 1];
 }
 
-//ͨʱյת
-static void time_conver_commontime_to_doy(common_time_t *pct, doy_t *pdoy)
+//日数到年和年积日的转换, 不经过月日
+static void time_doy_from_days(long long days, int *pyear, int *pday)
 {
-    common_time_t cto;
-    julianday_t jdo;
-    julianday_t jd;
-    double JD, JDO;
+    long long z, era;
+    long long doe, yoe, doy;
+    int doy0, leap;
 
-    cto.year = pct->year;
-    cto.month = 1;
-    cto.day = 1;
-    cto.hour = 0;
-    cto.minute = 0;
-    cto.second = 0;
+    if (time_year_table_lookup(days, pyear, &doy0, &leap)) {
+        *pday = doy0 + 1;
+        return;
+    }
 
-    time_conver_commontime_to_julianday(&cto, &jdo);
-    JDO = jdo.day + (jdo.tod.sn + jdo.tod.tos) / 86400.0;
+    z = days + 719468;
+    era = time_floor_div(z, 146097);
+    doe = z - era * 146097;
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);  //从3月1日起算, [0, 365]
+    yoe += era * 400;
 
-    time_conver_commontime_to_julianday(pct, &jd);
+    if (doy >= 306) {                               //次年1月、2月
+        *pyear = (int)(yoe + 1);
+        *pday = (int)(doy - 306 + 1);
+    } else {
+        *pyear = (int)yoe;
+        *pday = (int)(doy + 59 + time_is_leap_year(yoe) + 1);
+    }
+}
 
-    JD = jd.day + (jd.tod.sn + jd.tod.tos) / 86400.0;
-    pdoy->day = (short)(JD - JDO + 1);
-    pdoy->year = pct->year;
-    pdoy->tod.sn = (long)(pct->hour * 3600 + pct->minute * 60 + pct->second);
-    pdoy->tod.tos = pct->second - (int)(pct->second); 
+//两位数年份补全: 00-79为20xx, 80-99为19xx, 其余年份原样返回
+static int time_civil_year(int year)
+{
+    if (year >= 0 && year < 100) {
+        year += (year < 80) ? 2000 : 1900;
+    }
+
+    return year;
 }
 
-//յͨʱת
-static void time_conver_doy_to_commontime(doy_t *pdoy, common_time_t *pct)
+//通用时到儒略日的转换
+static void time_conver_commontime_to_julianday(const common_time_t *pct, julianday_t *pjd)
 {
-    common_time_t cto;
-    julianday_t jdo;
-    double JD, JDO;
-    long a, b, c, d, e;
+    long long t;
+    int isec;
+
+    isec = (int)pct->second;
 
-    cto.year = pdoy->year;
-    cto.month = 1;
-    cto.day = 1;
-    cto.hour = 0;
-    cto.minute = 0;
-    cto.second = 0;
+    //自1970-01-01正午前半天(即儒略日整数部分TIME_CIVIL_EPOCH_JD的起点)起的整秒数
+    t = time_days_from_civil(time_civil_year(pct->year), pct->month, pct->day) * ONE_DAY_SECONDS
+        + pct->hour * ONE_HOUR_SECONDS + pct->minute * ONE_MINUTE_SECONDS + isec + ONE_DAY_SECONDS / 2;
+
+    pjd->day = (long)(TIME_CIVIL_EPOCH_JD + time_floor_div(t, ONE_DAY_SECONDS));
+    pjd->tod.sn = (long)(t - time_floor_div(t, ONE_DAY_SECONDS) * ONE_DAY_SECONDS);//秒的整数部分 
+    pjd->tod.tos = pct->second - isec;//秒的小数部分 
+}
 
-    time_conver_commontime_to_julianday(&cto, &jdo);
-    JDO = jdo.day + (jdo.tod.sn + jdo.tod.tos) / 86400;
-    JD = JDO + pdoy->day + (pdoy->tod.sn + pdoy->tod.tos) / 86400 - 1;
+//儒略日到通用时的转换 
+static void time_conver_julianday_to_commontime(const julianday_t *pjd, common_time_t *pct)
+{
+    long long t, days;
+    long sod;
 
-    a = (long)(JD + 0.5);
-    b = a + 1537;
-    c = (long)((b - 122.1) / 365.25);
-    d = (long)(365.25 * c);
-    e = (long)((b - d) / 30.6001);
+    t = (long long)(pjd->day - TIME_CIVIL_EPOCH_JD) * ONE_DAY_SECONDS + pjd->tod.sn - ONE_DAY_SECONDS / 2;
+    days = time_floor_div(t, ONE_DAY_SECONDS);
+    sod = (long)(t - days * ONE_DAY_SECONDS);
 
-    pct->day = (short)(b - d - (long)(30.6001 * e) + time_get_frac(JD + 0.5));
-    pct->month = (short)(e - 1 - 12 * (long)(e / 14));
-    pct->year = (short)(c - 4715 - (long)((7 + pct->month) / 10));
-    pct->hour = (short)((pdoy->tod.sn + pdoy->tod.tos) / 3600);
-    pct->minute = (short)((pdoy->tod.sn + pdoy->tod.tos - pct->hour * 3600) / 60);
-    pct->second = pdoy->tod.sn + pdoy->tod.tos - pct->hour * 3600 - pct->minute * 60;
+    time_civil_from_days(days, &pct->year, &pct->month, &pct->day);
+    pct->hour = sod / ONE_HOUR_SECONDS;
+    pct->minute = (sod % ONE_HOUR_SECONDS) / ONE_MINUTE_SECONDS;
+    pct->second = sod % ONE_MINUTE_SECONDS + pjd->tod.tos;
 }
 
-//gpsյת
-static void time_conver_gpstime_to_doy(gps_time_t *pgt, doy_t *pdoy)
+//儒略日到GPS时的转换
+static void time_conver_julianday_to_gpstime(const julianday_t *pjd, gps_time_t *pgt)
 {
-    julianday_t jd;
-    common_time_t ct;
+    long long t;
+    long long wn;
+
+    //自GPS起点起的整秒数, 儒略日从正午起算, 故减去半天
+    t = (long long)(pjd->day - TIME_GPS_EPOCH_JD) * ONE_DAY_SECONDS + pjd->tod.sn - ONE_DAY_SECONDS / 2;
+    wn = time_floor_div(t, ONE_WEEK_SECONDS);
 
-    time_conver_gpstime_to_julianday(pgt, &jd);
-    time_conver_julianday_to_commontime(&jd, &ct);
-    time_conver_commontime_to_doy(&ct, pdoy);
+    pgt->wn = (int)wn;
+    pgt->tow.sn = (long)(t - wn * ONE_WEEK_SECONDS);
+    pgt->tow.tos = pjd->tod.tos;
 }
 
-//յgpsת
-static void time_conver_doy_to_gpstime(doy_t *pdoy, gps_time_t *pgt)
+//GPS时到儒略日的转换 
+static void time_conver_gpstime_to_julianday(const gps_time_t *pgt, julianday_t *pjd)
 {
-    common_time_t ct;
+    long long t;
+    long long q;
+
+    //儒略日从正午起算, 周内秒加上半天后按天拆分
+    t = (long long)pgt->tow.sn + ONE_DAY_SECONDS / 2;
+    q = time_floor_div(t, ONE_DAY_SECONDS);
 
-    time_conver_doy_to_commontime(pdoy, &ct);
-    time_conver_commontime_to_gpstime(&ct, pgt);
+    pjd->day = (long)(TIME_GPS_EPOCH_JD + (long long)pgt->wn * 7 + q);
+    pjd->tod.sn = (long)(t - q * ONE_DAY_SECONDS);
+    pjd->tod.tos = pgt->tow.tos;
 }
 
-//յյת
-static void time_conver_julianday_to_doy(julianday_t *pjd, doy_t *pdoy)
+//通用时到GPS时的转换
+static void time_conver_commontime_to_gpstime(const common_time_t *pct, gps_time_t *pgt)
 {
-    common_time_t ct;
- 
-    time_conver_julianday_to_commontime(pjd, &ct);
-    time_conver_commontime_to_doy(&ct, pdoy);
+    long long t;
+    long long wn;
+    int isec;
+
+    isec = (int)pct->second;
+
+    //自GPS起点起的整秒数
+    t = (time_days_from_civil(time_civil_year(pct->year), pct->month, pct->day) - TIME_GPS_EPOCH_DAYS) * ONE_DAY_SECONDS
+        + pct->hour * ONE_HOUR_SECONDS + pct->minute * ONE_MINUTE_SECONDS + isec;
+    wn = time_floor_div(t, ONE_WEEK_SECONDS);
+
+    pgt->wn = (int)wn;
+    pgt->tow.sn = (long)(t - wn * ONE_WEEK_SECONDS);
+    pgt->tow.tos = pct->second - isec;
 } 
 
-//յյת
-static void time_conver_doy_to_julianday(doy_t *pdoy, julianday_t *pjd)
+//GPS时到通用时的转换
+static void time_conver_gpstime_to_commontime(const gps_time_t *pgt, common_time_t *pct)
 {
-    common_time_t ct;
+    long long t, days;
+    long sod;
 
-    time_conver_doy_to_commontime(pdoy, &ct);
-    time_conver_commontime_to_julianday(&ct, pjd);
+    t = (long long)pgt->wn * ONE_WEEK_SECONDS + pgt->tow.sn;
+    days = time_floor_div(t, ONE_DAY_SECONDS);
+    sod = (long)(t - days * ONE_DAY_SECONDS);
+
+    time_civil_from_days(days + TIME_GPS_EPOCH_DAYS, &pct->year, &pct->month, &pct->day);
+    pct->hour = sod / ONE_HOUR_SECONDS;
+    pct->minute = (sod % ONE_HOUR_SECONDS) / ONE_MINUTE_SECONDS;
+    pct->second = sod % ONE_MINUTE_SECONDS + pgt->tow.tos;
 }
 
-static void time_print(time_type_t type, void *pt)
+/*
+ * 通用时到年积日的转换: 日期有效且时分秒在一天之内时查各月之前的累计天数, 无需换算儒略日;
+ * 否则按日数换算, 超出本月、本年的部分进位, 与GPS时、儒略日的转换一致.
+ */
+static void time_conver_commontime_to_doy(const common_time_t *pct, doy_t *pdoy)
 {
-    switch (type) {
-        case TIME_COMMON:
-            printf("-->common time:\n");
-            printf("ct.year     : %d\n", ((common_time_t *)pt)->year);
-            printf("ct.month    : %d\n", ((common_time_t *)pt)->month);
-            printf("ct.day      : %d\n", ((common_time_t *)pt)->day);
-            printf("ct.hour     : %d\n", ((common_time_t *)pt)->hour);
-            printf("ct.minute   : %d\n", ((common_time_t *)pt)->minute);
-            printf("ct.seconds  : %lf\n\n", ((common_time_t *)pt)->second);
-            break;
-        case TIME_JULIAN:
-            printf("-->julianday time:\n");
-            printf("jd.day      : %d\n", ((julianday_t *)pt)->day);
-            printf("jd.tod.sn   : %d\n", ((julianday_t *)pt)->tod.sn);
-            printf("jd.tod.tos  : %lf\n\n", ((julianday_t *)pt)->tod.tos);
-            break;
-        case TIME_GPS:
-            printf("-->gps time:\n");
-            printf("gps.wn      : %d\n", ((gps_time_t *)pt)->wn);
-            printf("gps.tow.sn  : %d\n", ((gps_time_t *)pt)->tow.sn);
-            printf("gps.tow.tos : %lf\n\n", ((gps_time_t *)pt)->tow.tos);
-            break;
-        case TIME_doy_t:
-            printf("-->doy time:\n");
-            printf("doy.year    : %d\n", ((doy_t *)pt)->year);
-            printf("doy.day     : %d\n", ((doy_t *)pt)->day);
-            printf("doy.tod.sn  : %d\n", ((doy_t *)pt)->tod.sn);
-            printf("doy.tod.tos : %lf\n\n", ((doy_t *)pt)->tod.tos);
-            break;
-        default:
-            break;
+    long long t, days;
+    int year, day, isec;
+
+    pdoy->tod.sn = (long)(pct->hour * 3600 + pct->minute * 60 + pct->second);
+    if (time_civil_valid(pct->year, pct->month, pct->day) && pdoy->tod.sn >= 0 && pdoy->tod.sn < ONE_DAY_SECONDS) {
+        pdoy->day = (unsigned short)(g_month_days_before[time_is_leap_year(pct->year)][pct->month - 1] + pct->day);
+        pdoy->year = pct->year;
+        pdoy->tod.tos = pct->second - (int)(pct->second);
+        return;
     }
+
+    isec = (int)pct->second;
+    t = time_days_from_civil(pct->year, pct->month, pct->day) * ONE_DAY_SECONDS
+        + pct->hour * ONE_HOUR_SECONDS + pct->minute * ONE_MINUTE_SECONDS + isec;
+    days = time_floor_div(t, ONE_DAY_SECONDS);
+
+    time_doy_from_days(days, &year, &day);
+    pdoy->year = (unsigned short)year;
+    pdoy->day = (unsigned short)day;
+    pdoy->tod.sn = (long)(t - days * ONE_DAY_SECONDS);
+    pdoy->tod.tos = pct->second - isec;
 }
 
-static int time_get_type_from_name(char *name)
+//年积日到通用时的转换: 年积日和天内秒有效时直接拆出月和日, 否则按日数换算, 超出本年的部分进位到下一年
+static void time_conver_doy_to_commontime(const doy_t *pdoy, common_time_t *pct)
 {
-    int type = -1;
+    long long t, days;
+    long sod;
 
-    if (memcmp(name, "gps", strlen("gps")) == 0) {
-        type = TIME_GPS;
-    } else if (memcmp(name, "ct", strlen("ct")) == 0) {
-        type = TIME_COMMON;
-    } else if (memcmp(name, "doy", strlen("doy")) == 0) {
-        type = TIME_doy_t;
-    } else if (memcmp(name, "jd", strlen("jd")) == 0) {
-        type = TIME_JULIAN;
-    } else if (memcmp(name, "all", strlen("all")) == 0) {
-        type = TIME_MAX;
-    } else if (memcmp(name, "quit", strlen("quit")) == 0) {
-        type = -1;
-    } else if (memcmp(name, "exit", strlen("exit")) == 0) {
-        exit(0);
+    if (pdoy->day >= 1 && pdoy->day <= 365 + time_is_leap_year(pdoy->year)
+        && pdoy->tod.sn >= 0 && pdoy->tod.sn < ONE_DAY_SECONDS) {
+        pct->year = pdoy->year;
+        time_month_from_doy(pdoy->day - 1, time_is_leap_year(pdoy->year), &pct->month, &pct->day);
+        sod = pdoy->tod.sn;
     } else {
-        printf("ERROR: The type %s unknown, please input again.\n", name);
-        type = -2;
+        t = (time_days_from_civil(pdoy->year, 1, 1) + pdoy->day - 1) * ONE_DAY_SECONDS + pdoy->tod.sn;
+        days = time_floor_div(t, ONE_DAY_SECONDS);
+        sod = (long)(t - days * ONE_DAY_SECONDS);
+        time_civil_from_days(days, &pct->year, &pct->month, &pct->day);
     }
-
-    return type;
+    pct->hour = (int)(sod / ONE_HOUR_SECONDS);
+    pct->minute = (int)((sod % ONE_HOUR_SECONDS) / ONE_MINUTE_SECONDS);
+    pct->second = sod % ONE_MINUTE_SECONDS + pdoy->tod.tos;
 }
 
-static int time_convert(void *pt, time_convert_state_t state)
+//gps到年积日的转换
+static void time_conver_gpstime_to_doy(const gps_time_t *pgt, doy_t *pdoy)
 {
-    gps_time_t *pgt = &g_gt;
-    common_time_t *pct = &g_ct;
-    julianday_t *pjd = &g_jd;
-    doy_t *pdoy = &g_doy;
-    time_type_t type;
-    int i;
-    void *p;
+    long long t, days;
+    int year, day;
 
-    switch (state) {
-        case TIME_COMMON_TO_JULIAN:
-            time_conver_commontime_to_julianday((common_time_t *)pt, pjd);
-            type = TIME_JULIAN;
-            break;
-        case TIME_COMMON_TO_GPS:
-            time_conver_commontime_to_gpstime((common_time_t *)pt, pgt);
-            type = TIME_GPS;
-            break;
-        case TIME_COMMON_TO_doy_t:
-            time_conver_commontime_to_doy((common_time_t *)pt, pdoy);
-            type = TIME_doy_t;
-            break;
-        case TIME_COMMON_TO_ALL:
-            time_conver_commontime_to_julianday((common_time_t *)pt, pjd);
-            time_conver_commontime_to_gpstime((common_time_t *)pt, pgt);
-            time_conver_commontime_to_doy((common_time_t *)pt, pdoy);
-            memcpy(pct, pt, sizeof(common_time_t));
-            type = TIME_MAX;
-            break;
+    t = (long long)pgt->wn * ONE_WEEK_SECONDS + pgt->tow.sn;
+    days = time_floor_div(t, ONE_DAY_SECONDS);
 
-        case TIME_JULIAN_TO_COMMON:
-            time_conver_julianday_to_commontime((julianday_t *)pt, pct);
-            type = TIME_COMMON;
-            break;
-        case TIME_JULIAN_TO_GPS:
-            time_conver_julianday_to_gpstime((julianday_t *)pt, pgt);
-            type = TIME_GPS;
-            break;
-        case TIME_JULIAN_TO_doy_t:
-            time_conver_julianday_to_doy((julianday_t *)pt, pdoy);
-            type = TIME_doy_t;
-            break;
-        case TIME_JULIAN_TO_ALL:
-            time_conver_julianday_to_commontime((julianday_t *)pt, pct);
-            time_conver_julianday_to_gpstime((julianday_t *)pt, pgt);
-            time_conver_julianday_to_doy((julianday_t *)pt, pdoy);
-            memcpy(pjd, pt, sizeof(julianday_t));
-            type = TIME_MAX;
-            break;
+    time_doy_from_days(days + TIME_GPS_EPOCH_DAYS, &year, &day);
+    pdoy->year = (unsigned short)year;
+    pdoy->day = (unsigned short)day;
+    pdoy->tod.sn = (long)(t - days * ONE_DAY_SECONDS);
+    pdoy->tod.tos = pgt->tow.tos;
+}
 
-        case TIME_GPS_TO_COMMON:
-            time_conver_gpstime_to_commontime((gps_time_t *)pt, pct);
-            type = TIME_COMMON;
-            break;
-        case TIME_GPS_TO_JULIAN:
-            time_conver_gpstime_to_julianday((gps_time_t *)pt, pjd);
-            type = TIME_JULIAN;
-            break;
-        case TIME_GPS_TO_doy_t:
-            time_conver_gpstime_to_doy((gps_time_t *)pt, pdoy);
-            type = TIME_doy_t;
-            break;
-        case TIME_GPS_TO_ALL:
-            time_conver_gpstime_to_commontime((gps_time_t *)pt, pct);
-            time_conver_gpstime_to_julianday((gps_time_t *)pt, pjd);
-            time_conver_gpstime_to_doy((gps_time_t *)pt, pdoy);
-            memcpy(pgt, pt, sizeof(gps_time_t));
-            type = TIME_MAX;
-            break;
+//年积日到gps的转换
+static void time_conver_doy_to_gpstime(const doy_t *pdoy, gps_time_t *pgt)
+{
+    long long t;
+    long long wn;
+    const time_year_entry_t *pyt;
 
-        case TIME_doy_t_TO_COMMON:
-            time_conver_doy_to_commontime((doy_t *)pt, pct);
-            type = TIME_COMMON;
-            break;
-        case TIME_doy_t_TO_JULIAN:
-            time_conver_doy_to_julianday((doy_t *)pt, pjd);
-            type = TIME_JULIAN;
-            break;
-        case TIME_doy_t_TO_GPS:
-            time_conver_doy_to_gpstime((doy_t *)pt, pgt);
-            type = TIME_GPS;
-            break;
-        case TIME_doy_t_TO_ALL:
-            time_conver_doy_to_commontime((doy_t *)pt, pct);
-            time_conver_doy_to_julianday((doy_t *)pt, pjd);
-            time_conver_doy_to_gpstime((doy_t *)pt, pgt);
-            memcpy(pdoy, pt, sizeof(doy_t));
-            type = TIME_MAX;
-            break;
-        default:
-            return -1;
+    if (time_year_in_table(pdoy->year) && pdoy->day >= 1 && pdoy->tod.sn >= 0) {
+        //自元旦所在GPS周起点起的秒数, 非负, 直接整除
+        pyt = &g_year_table[pdoy->year - TIME_TABLE_FIRST_YEAR];
+        t = (pyt->days - TIME_GPS_EPOCH_DAYS - 7LL * pyt->gps_week + pdoy->day - 1) * ONE_DAY_SECONDS
+            + pdoy->tod.sn;
+        pgt->wn = (int)(pyt->gps_week + t / ONE_WEEK_SECONDS);
+        pgt->tow.sn = (long)(t % ONE_WEEK_SECONDS);
+        pgt->tow.tos = pdoy->tod.tos;
+        return;
     }
 
-    for (i = 0; i < TIME_MAX; i++) {
-        if (type != TIME_MAX && type != i) {
-            continue;
-        }
-
-        if (i == TIME_COMMON) {
-            p = pct;
-        } else if (i == TIME_JULIAN) {
-            p = pjd;
-        } else if (i == TIME_GPS) {
-            p = pgt;
-        } else {
-            p = pdoy;
-        }
-
-        time_print(i, p);
-    }
+    t = (time_days_from_civil(pdoy->year, 1, 1) + pdoy->day - 1 - TIME_GPS_EPOCH_DAYS) * ONE_DAY_SECONDS
+        + pdoy->tod.sn;
+    wn = time_floor_div(t, ONE_WEEK_SECONDS);
 
-    return 0;
+    pgt->wn = (int)wn;
+    pgt->tow.sn = (long)(t - wn * ONE_WEEK_SECONDS);
+    pgt->tow.tos = pdoy->tod.tos;
 }
 
-static int time_convert_gps(int argc, char *argv[])
+//儒略日到年积日的转换
+static void time_conver_julianday_to_doy(const julianday_t *pjd, doy_t *pdoy)
 {
-    int type;
-    gps_time_t *pgt = &g_gt;
-    time_convert_state_t state;
-    char typename[10];
-    int rv = 0;
-    char yesorno[10];
-    bool input_time = true;
+    long long t, days;
+    int year, day;
 
-    if (pgt->wn) {
-        printf("do you want to input gps time again[y/n]: ");
-        scanf("%s", yesorno);
-        if (memcmp(yesorno, "n", strlen("n")) == 0) {
-            input_time = false;
-        }
-    }
+    t = (long long)(pjd->day - TIME_CIVIL_EPOCH_JD) * ONE_DAY_SECONDS + pjd->tod.sn - ONE_DAY_SECONDS / 2;
+    days = time_floor_div(t, ONE_DAY_SECONDS);
 
-    if (input_time) {
-        printf("Please input gpstime: \n");
-        printf("week number: ");
-        scanf("%d", &pgt->wn);
-        printf("Time of week(s): ");
-        scanf("%d", &pgt->tow.sn);
-        printf("Fractional of seconds: ");
-        scanf("%lf", &pgt->tow.tos);
-    }
+    time_doy_from_days(days, &year, &day);
+    pdoy->year = (unsigned short)year;
+    pdoy->day = (unsigned short)day;
+    pdoy->tod.sn = (long)(t - days * ONE_DAY_SECONDS);
+    pdoy->tod.tos = pjd->tod.tos;
+} 
 
-    if (TIME_DBG_OPEN) {
-        printf("gps.wn      : %d\n", pgt->wn);
-        printf("gps.tow.sn  : %d\n", pgt->tow.sn);
-        printf("gps.tow.tos : %lf\n", pgt->tow.tos);
+//年积日到儒略日的转换
+static void time_conver_doy_to_julianday(const doy_t *pdoy, julianday_t *pjd)
+{
+    long long t;
+    const time_year_entry_t *pyt;
+
+    if (time_year_in_table(pdoy->year) && pdoy->day >= 1 && pdoy->tod.sn >= 0) {
+        //年积日和天内秒非负时t非负, 直接整除
+        pyt = &g_year_table[pdoy->year - TIME_TABLE_FIRST_YEAR];
+        t = (long long)(pdoy->day - 1) * ONE_DAY_SECONDS + pdoy->tod.sn + ONE_DAY_SECONDS / 2;
+        pjd->day = (long)(pyt->jd + t / ONE_DAY_SECONDS);
+        pjd->tod.sn = (long)(t % ONE_DAY_SECONDS);
+        pjd->tod.tos = pdoy->tod.tos;
+        return;
     }
 
-    while (1) {
-        printf("\ngps convert to [ct|jd|doy|all|quit|exit]: ");
-        scanf("%s", typename);
-        type = time_get_type_from_name(typename);
-        if (type == -2) {
-            continue;
-        }
+    t = (time_days_from_civil(pdoy->year, 1, 1) + pdoy->day - 1) * ONE_DAY_SECONDS
+        + pdoy->tod.sn + ONE_DAY_SECONDS / 2;
 
-        switch (type) {
-            case TIME_COMMON:
-                state = TIME_GPS_TO_COMMON;
-                break;
-            case TIME_JULIAN:
-                state = TIME_GPS_TO_JULIAN;
-                break;
-            case TIME_doy_t:
-                state = TIME_GPS_TO_doy_t;
-                break;
-            case TIME_MAX:
-                state = TIME_GPS_TO_ALL;
-                break;
-            default:
-                return -1;
-        }
+    pjd->day = (long)(TIME_CIVIL_EPOCH_JD + time_floor_div(t, ONE_DAY_SECONDS));
+    pjd->tod.sn = (long)(t - time_floor_div(t, ONE_DAY_SECONDS) * ONE_DAY_SECONDS);
+    pjd->tod.tos = pdoy->tod.tos;
+}
 
-        rv = time_convert(pgt, state);
-    }
+/*
+ * 简化儒略日(MJD = JD - 2400000.5)从子夜起算, 整数部分即日数, 天内秒与通用时一致,
+ * 与其他表示之间只差常数天数, 不需要儒略日的正午半天修正.
+ */
+//简化儒略日到儒略日的转换
+static void time_conver_mjd_to_julianday(const new_julianday_t *pmjd, julianday_t *pjd)
+{
+    long long t, q;
 
-    return rv;
+    t = (long long)pmjd->tod.sn + ONE_DAY_SECONDS / 2;
+    q = time_floor_div(t, ONE_DAY_SECONDS);
+
+    pjd->day = (long)(pmjd->day + TIME_MJD_EPOCH_JD + q);
+    pjd->tod.sn = (long)(t - q * ONE_DAY_SECONDS);
+    pjd->tod.tos = pmjd->tod.tos;
 }
 
-static int time_convert_ct(int argc, char *argv[])
+//儒略日到简化儒略日的转换
+static void time_conver_julianday_to_mjd(const julianday_t *pjd, new_julianday_t *pmjd)
 {
-    int type;
-    common_time_t *pct = &g_ct;
-    time_convert_state_t state;
-    char typename[10];
-    int rv = 0;
-    char commtime[64];
-    char yesorno[10];
-    bool input_time = true;
+    long long t, q;
 
-    if (pct->year) {
-        printf("do you want to input common time again[y/n]: ");
-        scanf("%s", yesorno);
-        if (memcmp(yesorno, "n", strlen("n")) == 0) {
-            input_time = false;
-        }
-    }
+    t = (long long)pjd->tod.sn - ONE_DAY_SECONDS / 2;
+    q = time_floor_div(t, ONE_DAY_SECONDS);
 
-    if (input_time) {
-        printf("Please input commontime[yyyymmddhhmmss.xx]: ");
-        memset(commtime, 0, sizeof(commtime));
-        scanf("%s", commtime);
-        sscanf(commtime, "%4d%2d%2d%2d%2d%lf", &pct->year, &pct->month, &pct->day, &pct->hour,
-            &pct->minute, &pct->second);
-    }
+    pmjd->day = (long)(pjd->day - TIME_MJD_EPOCH_JD + q);
+    pmjd->tod.sn = (long)(t - q * ONE_DAY_SECONDS);
+    pmjd->tod.tos = pjd->tod.tos;
+}
 
-    if (TIME_DBG_OPEN) {
-        printf("ct.year    : %d\n", pct->year);
-        printf("ct.month   : %d\n", pct->month);
-        printf("ct.day     : %d\n", pct->day);
-        printf("ct.hour    : %d\n", pct->hour);
-        printf("ct.minute  : %d\n", pct->minute);
-        printf("ct.seconds : %lf\n", pct->second);
-    }
+//简化儒略日到GPS时的转换
+static void time_conver_mjd_to_gpstime(const new_julianday_t *pmjd, gps_time_t *pgt)
+{
+    long long t, wn;
 
-    while (1) {
-        printf("\ncommontime convert to [gps|jd|doy|all|quit|exit]: ");
-        scanf("%s", typename);
-        type = time_get_type_from_name(typename);
-        if (type == -2) {
-            continue;
-        }
+    t = (long long)(pmjd->day - TIME_GPS_EPOCH_MJD) * ONE_DAY_SECONDS + pmjd->tod.sn;
+    wn = time_floor_div(t, ONE_WEEK_SECONDS);
 
-        switch (type) {
-            case TIME_GPS:
-                state = TIME_COMMON_TO_GPS;
-                break;
-            case TIME_JULIAN:
-                state = TIME_COMMON_TO_JULIAN;
-                break;
-            case TIME_doy_t:
-                state = TIME_COMMON_TO_doy_t;
-                break;
-            case TIME_MAX:
-                state = TIME_COMMON_TO_ALL;
-                break;
-            default:
-                return -1;
-        }
+    pgt->wn = (int)wn;
+    pgt->tow.sn = (long)(t - wn * ONE_WEEK_SECONDS);
+    pgt->tow.tos = pmjd->tod.tos;
+}
 
-        rv = time_convert(pct, state);
-    }
+//GPS时到简化儒略日的转换
+static void time_conver_gpstime_to_mjd(const gps_time_t *pgt, new_julianday_t *pmjd)
+{
+    long long q;
 
-    return rv;
+    q = time_floor_div(pgt->tow.sn, ONE_DAY_SECONDS);
+
+    pmjd->day = (long)(TIME_GPS_EPOCH_MJD + (long long)pgt->wn * 7 + q);
+    pmjd->tod.sn = (long)(pgt->tow.sn - q * ONE_DAY_SECONDS);
+    pmjd->tod.tos = pgt->tow.tos;
 }
 
-static int time_convert_jd(int argc, char *argv[])
+//简化儒略日到通用时的转换
+static void time_conver_mjd_to_commontime(const new_julianday_t *pmjd, common_time_t *pct)
+{
+    long long t, days;
+    long sod;
+
+    t = (long long)(pmjd->day - TIME_CIVIL_EPOCH_MJD) * ONE_DAY_SECONDS + pmjd->tod.sn;
+    days = time_floor_div(t, ONE_DAY_SECONDS);
+    sod = (long)(t - days * ONE_DAY_SECONDS);
+
+    time_civil_from_days(days, &pct->year, &pct->month, &pct->day);
+    pct->hour = sod / ONE_HOUR_SECONDS;
+    pct->minute = (sod % ONE_HOUR_SECONDS) / ONE_MINUTE_SECONDS;
+    pct->second = sod % ONE_MINUTE_SECONDS + pmjd->tod.tos;
+}
+
+//通用时到简化儒略日的转换
+static void time_conver_commontime_to_mjd(const common_time_t *pct, new_julianday_t *pmjd)
+{
+    long long t, days;
+    int isec;
+
+    isec = (int)pct->second;
+    t = time_days_from_civil(time_civil_year(pct->year), pct->month, pct->day) * ONE_DAY_SECONDS
+        + pct->hour * ONE_HOUR_SECONDS + pct->minute * ONE_MINUTE_SECONDS + isec;
+    days = time_floor_div(t, ONE_DAY_SECONDS);
+
+    pmjd->day = (long)(TIME_CIVIL_EPOCH_MJD + days);
+    pmjd->tod.sn = (long)(t - days * ONE_DAY_SECONDS);
+    pmjd->tod.tos = pct->second - isec;
+}
+
+//简化儒略日到年积日的转换
+static void time_conver_mjd_to_doy(const new_julianday_t *pmjd, doy_t *pdoy)
+{
+    long long t, days;
+    int year, day;
+
+    t = (long long)(pmjd->day - TIME_CIVIL_EPOCH_MJD) * ONE_DAY_SECONDS + pmjd->tod.sn;
+    days = time_floor_div(t, ONE_DAY_SECONDS);
+
+    time_doy_from_days(days, &year, &day);
+    pdoy->year = (unsigned short)year;
+    pdoy->day = (unsigned short)day;
+    pdoy->tod.sn = (long)(t - days * ONE_DAY_SECONDS);
+    pdoy->tod.tos = pmjd->tod.tos;
+}
+
+//年积日到简化儒略日的转换
+static void time_conver_doy_to_mjd(const doy_t *pdoy, new_julianday_t *pmjd)
+{
+    long long t, days;
+
+    t = (time_days_from_civil(pdoy->year, 1, 1) + pdoy->day - 1) * ONE_DAY_SECONDS + pdoy->tod.sn;
+    days = time_floor_div(t, ONE_DAY_SECONDS);
+
+    pmjd->day = (long)(TIME_CIVIL_EPOCH_MJD + days);
+    pmjd->tod.sn = (long)(t - days * ONE_DAY_SECONDS);
+    pmjd->tod.tos = pdoy->tod.tos;
+}
+
+/*
+ * 批量转换: 对连续数组中的n个时刻逐个转换.
+ * 输入输出数组不得重叠(restrict), 循环体内联单点转换函数, 无函数指针和中间拷贝, 便于编译器自动向量化.
+ */
+#define TIME_CONVER_BATCH_DEFINE(from, from_t, to, to_t) \
+static void time_conver_##from##_to_##to##_batch(const from_t *restrict pin, to_t *restrict pout, size_t n) \
+{ \
+    size_t i; \
+    \
+    for (i = 0; i < n; i++) { \
+        time_conver_##from##_to_##to(&pin[i], &pout[i]); \
+    } \
+}
+
+TIME_CONVER_BATCH_DEFINE(commontime, common_time_t, julianday, julianday_t)
+TIME_CONVER_BATCH_DEFINE(julianday, julianday_t, commontime, common_time_t)
+TIME_CONVER_BATCH_DEFINE(julianday, julianday_t, gpstime, gps_time_t)
+TIME_CONVER_BATCH_DEFINE(gpstime, gps_time_t, julianday, julianday_t)
+TIME_CONVER_BATCH_DEFINE(commontime, common_time_t, gpstime, gps_time_t)
+TIME_CONVER_BATCH_DEFINE(gpstime, gps_time_t, commontime, common_time_t)
+TIME_CONVER_BATCH_DEFINE(commontime, common_time_t, doy, doy_t)
+TIME_CONVER_BATCH_DEFINE(doy, doy_t, commontime, common_time_t)
+TIME_CONVER_BATCH_DEFINE(gpstime, gps_time_t, doy, doy_t)
+TIME_CONVER_BATCH_DEFINE(doy, doy_t, gpstime, gps_time_t)
+TIME_CONVER_BATCH_DEFINE(julianday, julianday_t, doy, doy_t)
+TIME_CONVER_BATCH_DEFINE(doy, doy_t, julianday, julianday_t)
+TIME_CONVER_BATCH_DEFINE(mjd, new_julianday_t, julianday, julianday_t)
+TIME_CONVER_BATCH_DEFINE(julianday, julianday_t, mjd, new_julianday_t)
+TIME_CONVER_BATCH_DEFINE(mjd, new_julianday_t, gpstime, gps_time_t)
+TIME_CONVER_BATCH_DEFINE(gpstime, gps_time_t, mjd, new_julianday_t)
+TIME_CONVER_BATCH_DEFINE(mjd, new_julianday_t, commontime, common_time_t)
+TIME_CONVER_BATCH_DEFINE(commontime, common_time_t, mjd, new_julianday_t)
+TIME_CONVER_BATCH_DEFINE(mjd, new_julianday_t, doy, doy_t)
+TIME_CONVER_BATCH_DEFINE(doy, doy_t, mjd, new_julianday_t)
+
+/*
+ * 列存储(SoA)时间容器: 每个字段单独成列, 列按64字节对齐, 无结构体填充, 可直接用SIMD整列装载.
+ * 整数列统一使用int(32位), 以便AVX2/AVX-512一次装载4/8个元素并转换为double运算.
+ */
+typedef struct gps_time_soa_s {
+    size_t n;
+    int *wn;        //周数
+    int *tow_sn;    //周内秒整数部分
+    double *tow_tos;//周内秒小数部分
+} gps_time_soa_t;
+
+typedef struct julianday_soa_s {
+    size_t n;
+    int *day;       //整数天数
+    int *tod_sn;    //天内秒整数部分
+    double *tod_tos;//天内秒小数部分
+} julianday_soa_t;
+
+typedef struct doy_soa_s {
+    size_t n;
+    int *year;
+    int *day;
+    int *tod_sn;
+    double *tod_tos;
+} doy_soa_t;
+
+typedef struct common_time_soa_s {
+    size_t n;
+    int *year;
+    int *month;
+    int *day;
+    int *hour;
+    int *minute;
+    double *second;
+} common_time_soa_t;
+
+#define TIME_SOA_ALIGN      (64)
+
+static void *time_soa_column_alloc(size_t n, size_t size)
+{
+    void *p = NULL;
+    size_t bytes = (n * size + TIME_SOA_ALIGN - 1) / TIME_SOA_ALIGN * TIME_SOA_ALIGN;
+
+    if (posix_memalign(&p, TIME_SOA_ALIGN, bytes ? bytes : TIME_SOA_ALIGN) != 0) {
+        return NULL;
+    }
+
+    return p;
+}
+
+static void time_soa_gps_free(gps_time_soa_t *pgt)
+{
+    free(pgt->wn);
+    free(pgt->tow_sn);
+    free(pgt->tow_tos);
+    memset(pgt, 0, sizeof(*pgt));
+}
+
+static int time_soa_gps_alloc(gps_time_soa_t *pgt, size_t n)
+{
+    pgt->n = n;
+    pgt->wn = time_soa_column_alloc(n, sizeof(int));
+    pgt->tow_sn = time_soa_column_alloc(n, sizeof(int));
+    pgt->tow_tos = time_soa_column_alloc(n, sizeof(double));
+    if (!pgt->wn || !pgt->tow_sn || !pgt->tow_tos) {
+        time_soa_gps_free(pgt);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void time_soa_jd_free(julianday_soa_t *pjd)
+{
+    free(pjd->day);
+    free(pjd->tod_sn);
+    free(pjd->tod_tos);
+    memset(pjd, 0, sizeof(*pjd));
+}
+
+static int time_soa_jd_alloc(julianday_soa_t *pjd, size_t n)
+{
+    pjd->n = n;
+    pjd->day = time_soa_column_alloc(n, sizeof(int));
+    pjd->tod_sn = time_soa_column_alloc(n, sizeof(int));
+    pjd->tod_tos = time_soa_column_alloc(n, sizeof(double));
+    if (!pjd->day || !pjd->tod_sn || !pjd->tod_tos) {
+        time_soa_jd_free(pjd);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void time_soa_doy_free(doy_soa_t *pdoy)
+{
+    free(pdoy->year);
+    free(pdoy->day);
+    free(pdoy->tod_sn);
+    free(pdoy->tod_tos);
+    memset(pdoy, 0, sizeof(*pdoy));
+}
+
+//年积日容器暂无向量化内核, 供已按列保存年积日的调用者使用
+__attribute__((unused))
+static int time_soa_doy_alloc(doy_soa_t *pdoy, size_t n)
+{
+    pdoy->n = n;
+    pdoy->year = time_soa_column_alloc(n, sizeof(int));
+    pdoy->day = time_soa_column_alloc(n, sizeof(int));
+    pdoy->tod_sn = time_soa_column_alloc(n, sizeof(int));
+    pdoy->tod_tos = time_soa_column_alloc(n, sizeof(double));
+    if (!pdoy->year || !pdoy->day || !pdoy->tod_sn || !pdoy->tod_tos) {
+        time_soa_doy_free(pdoy);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void time_soa_ct_free(common_time_soa_t *pct)
+{
+    free(pct->year);
+    free(pct->month);
+    free(pct->day);
+    free(pct->hour);
+    free(pct->minute);
+    free(pct->second);
+    memset(pct, 0, sizeof(*pct));
+}
+
+static int time_soa_ct_alloc(common_time_soa_t *pct, size_t n)
+{
+    pct->n = n;
+    pct->year = time_soa_column_alloc(n, sizeof(int));
+    pct->month = time_soa_column_alloc(n, sizeof(int));
+    pct->day = time_soa_column_alloc(n, sizeof(int));
+    pct->hour = time_soa_column_alloc(n, sizeof(int));
+    pct->minute = time_soa_column_alloc(n, sizeof(int));
+    pct->second = time_soa_column_alloc(n, sizeof(double));
+    if (!pct->year || !pct->month || !pct->day || !pct->hour || !pct->minute || !pct->second) {
+        time_soa_ct_free(pct);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * 列存储标量内核: 从下标from开始逐个转换, 既是不支持SIMD时的后备实现, 也用于处理SIMD整组之后的尾部元素.
+ */
+static void time_soa_julianday_to_gpstime_scalar(const julianday_soa_t *pjd, gps_time_soa_t *pgt, size_t from)
+{
+    julianday_t jd;
+    gps_time_t gt;
+    size_t i;
+
+    for (i = from; i < pjd->n; i++) {
+        jd.day = pjd->day[i];
+        jd.tod.sn = pjd->tod_sn[i];
+        jd.tod.tos = pjd->tod_tos[i];
+        time_conver_julianday_to_gpstime(&jd, &gt);
+        pgt->wn[i] = gt.wn;
+        pgt->tow_sn[i] = (int)gt.tow.sn;
+        pgt->tow_tos[i] = gt.tow.tos;
+    }
+}
+
+static void time_soa_gpstime_to_julianday_scalar(const gps_time_soa_t *pgt, julianday_soa_t *pjd, size_t from)
+{
+    gps_time_t gt;
+    julianday_t jd;
+    size_t i;
+
+    for (i = from; i < pgt->n; i++) {
+        gt.wn = pgt->wn[i];
+        gt.tow.sn = pgt->tow_sn[i];
+        gt.tow.tos = pgt->tow_tos[i];
+        time_conver_gpstime_to_julianday(&gt, &jd);
+        pjd->day[i] = (int)jd.day;
+        pjd->tod_sn[i] = (int)jd.tod.sn;
+        pjd->tod_tos[i] = jd.tod.tos;
+    }
+}
+
+static void time_soa_gpstime_to_commontime_scalar(const gps_time_soa_t *pgt, common_time_soa_t *pct, size_t from)
+{
+    gps_time_t gt;
+    common_time_t ct;
+    size_t i;
+
+    for (i = from; i < pgt->n; i++) {
+        gt.wn = pgt->wn[i];
+        gt.tow.sn = pgt->tow_sn[i];
+        gt.tow.tos = pgt->tow_tos[i];
+        time_conver_gpstime_to_commontime(&gt, &ct);
+        pct->year[i] = ct.year;
+        pct->month[i] = ct.month;
+        pct->day[i] = ct.day;
+        pct->hour[i] = ct.hour;
+        pct->minute[i] = ct.minute;
+        pct->second[i] = ct.second;
+    }
+}
+
+static void time_soa_commontime_to_gpstime_scalar(const common_time_soa_t *pct, gps_time_soa_t *pgt, size_t from)
+{
+    common_time_t ct;
+    gps_time_t gt;
+    size_t i;
+
+    for (i = from; i < pct->n; i++) {
+        ct.year = pct->year[i];
+        ct.month = pct->month[i];
+        ct.day = pct->day[i];
+        ct.hour = pct->hour[i];
+        ct.minute = pct->minute[i];
+        ct.second = pct->second[i];
+        time_conver_commontime_to_gpstime(&ct, &gt);
+        pgt->wn[i] = gt.wn;
+        pgt->tow_sn[i] = (int)gt.tow.sn;
+        pgt->tow_tos[i] = gt.tow.tos;
+    }
+}
+
+/*
+ * SIMD内核: 整数字段转换为double后运算, 所有除法均为"double除法+向下取整",
+ * 在本程序的数值范围(<2^40)内与整数向下取整除法结果完全一致.
+ * GPS时与通用时之间的日期换算采用按400年纪元(146097天)划分的公历算法, 以1970-01-01为第0天,
+ * GPS起点1980-01-06为第3657天.
+ */
+#define TIME_GPS_EPOCH_CIVIL    (723125)    //GPS起点相对公元0年3月1日的天数(3657 + 719468)
+
+#if TIME_SIMD_X86
+__attribute__((target("avx2")))
+static inline __m256d time_avx2_floordiv(__m256d a, double b)
+{
+    return _mm256_floor_pd(_mm256_div_pd(a, _mm256_set1_pd(b)));
+}
+
+__attribute__((target("avx2")))
+static size_t time_soa_julianday_to_gpstime_avx2(const julianday_soa_t *pjd, gps_time_soa_t *pgt)
+{
+    size_t i;
+    __m256d t, wn;
+
+    for (i = 0; i + 4 <= pjd->n; i += 4) {
+        t = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)&pjd->day[i]));
+        t = _mm256_sub_pd(t, _mm256_set1_pd(TIME_GPS_EPOCH_JD));
+        t = _mm256_mul_pd(t, _mm256_set1_pd(ONE_DAY_SECONDS));
+        t = _mm256_add_pd(t, _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)&pjd->tod_sn[i])));
+        t = _mm256_sub_pd(t, _mm256_set1_pd(ONE_DAY_SECONDS / 2));
+        wn = time_avx2_floordiv(t, ONE_WEEK_SECONDS);
+        t = _mm256_sub_pd(t, _mm256_mul_pd(wn, _mm256_set1_pd(ONE_WEEK_SECONDS)));
+        _mm_storeu_si128((__m128i *)&pgt->wn[i], _mm256_cvttpd_epi32(wn));
+        _mm_storeu_si128((__m128i *)&pgt->tow_sn[i], _mm256_cvttpd_epi32(t));
+        _mm256_storeu_pd(&pgt->tow_tos[i], _mm256_loadu_pd(&pjd->tod_tos[i]));
+    }
+
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t time_soa_gpstime_to_julianday_avx2(const gps_time_soa_t *pgt, julianday_soa_t *pjd)
+{
+    size_t i;
+    __m256d t, q, day;
+
+    for (i = 0; i + 4 <= pgt->n; i += 4) {
+        t = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)&pgt->tow_sn[i]));
+        t = _mm256_add_pd(t, _mm256_set1_pd(ONE_DAY_SECONDS / 2));
+        q = time_avx2_floordiv(t, ONE_DAY_SECONDS);
+        day = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)&pgt->wn[i]));
+        day = _mm256_add_pd(_mm256_mul_pd(day, _mm256_set1_pd(7)), q);
+        day = _mm256_add_pd(day, _mm256_set1_pd(TIME_GPS_EPOCH_JD));
+        t = _mm256_sub_pd(t, _mm256_mul_pd(q, _mm256_set1_pd(ONE_DAY_SECONDS)));
+        _mm_storeu_si128((__m128i *)&pjd->day[i], _mm256_cvttpd_epi32(day));
+        _mm_storeu_si128((__m128i *)&pjd->tod_sn[i], _mm256_cvttpd_epi32(t));
+        _mm256_storeu_pd(&pjd->tod_tos[i], _mm256_loadu_pd(&pgt->tow_tos[i]));
+    }
+
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t time_soa_gpstime_to_commontime_avx2(const gps_time_soa_t *pgt, common_time_soa_t *pct)
+{
+    size_t i;
+    __m256d t, z, sod, era, doe, yoe, y, doy, mp, d, m, hh, mm;
+
+    for (i = 0; i + 4 <= pgt->n; i += 4) {
+        t = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)&pgt->wn[i]));
+        t = _mm256_mul_pd(t, _mm256_set1_pd(ONE_WEEK_SECONDS));
+        t = _mm256_add_pd(t, _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)&pgt->tow_sn[i])));
+        z = time_avx2_floordiv(t, ONE_DAY_SECONDS);
+        sod = _mm256_sub_pd(t, _mm256_mul_pd(z, _mm256_set1_pd(ONE_DAY_SECONDS)));
+
+        z = _mm256_add_pd(z, _mm256_set1_pd(TIME_GPS_EPOCH_CIVIL));
+        era = time_avx2_floordiv(z, 146097);
+        doe = _mm256_sub_pd(z, _mm256_mul_pd(era, _mm256_set1_pd(146097)));
+        yoe = _mm256_sub_pd(doe, time_avx2_floordiv(doe, 1460));
+        yoe = _mm256_add_pd(yoe, time_avx2_floordiv(doe, 36524));
+        yoe = _mm256_sub_pd(yoe, time_avx2_floordiv(doe, 146096));
+        yoe = time_avx2_floordiv(yoe, 365);
+        y = _mm256_add_pd(yoe, _mm256_mul_pd(era, _mm256_set1_pd(400)));
+        doy = _mm256_add_pd(_mm256_mul_pd(yoe, _mm256_set1_pd(365)), time_avx2_floordiv(yoe, 4));
+        doy = _mm256_sub_pd(doe, _mm256_sub_pd(doy, time_avx2_floordiv(yoe, 100)));
+        mp = time_avx2_floordiv(_mm256_add_pd(_mm256_mul_pd(doy, _mm256_set1_pd(5)), _mm256_set1_pd(2)), 153);
+        d = time_avx2_floordiv(_mm256_add_pd(_mm256_mul_pd(mp, _mm256_set1_pd(153)), _mm256_set1_pd(2)), 5);
+        d = _mm256_add_pd(_mm256_sub_pd(doy, d), _mm256_set1_pd(1));
+        m = _mm256_blendv_pd(_mm256_add_pd(mp, _mm256_set1_pd(3)), _mm256_sub_pd(mp, _mm256_set1_pd(9)),
+            _mm256_cmp_pd(mp, _mm256_set1_pd(10), _CMP_GE_OQ));
+        y = _mm256_add_pd(y, _mm256_and_pd(_mm256_cmp_pd(m, _mm256_set1_pd(2), _CMP_LE_OQ), _mm256_set1_pd(1)));
+
+        hh = time_avx2_floordiv(sod, ONE_HOUR_SECONDS);
+        sod = _mm256_sub_pd(sod, _mm256_mul_pd(hh, _mm256_set1_pd(ONE_HOUR_SECONDS)));
+        mm = time_avx2_floordiv(sod, ONE_MINUTE_SECONDS);
+        sod = _mm256_sub_pd(sod, _mm256_mul_pd(mm, _mm256_set1_pd(ONE_MINUTE_SECONDS)));
+
+        _mm_storeu_si128((__m128i *)&pct->year[i], _mm256_cvttpd_epi32(y));
+        _mm_storeu_si128((__m128i *)&pct->month[i], _mm256_cvttpd_epi32(m));
+        _mm_storeu_si128((__m128i *)&pct->day[i], _mm256_cvttpd_epi32(d));
+        _mm_storeu_si128((__m128i *)&pct->hour[i], _mm256_cvttpd_epi32(hh));
+        _mm_storeu_si128((__m128i *)&pct->minute[i], _mm256_cvttpd_epi32(mm));
+        _mm256_storeu_pd(&pct->second[i], _mm256_add_pd(sod, _mm256_loadu_pd(&pgt->tow_tos[i])));
+    }
+
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t time_soa_commontime_to_gpstime_avx2(const common_time_soa_t *pct, gps_time_soa_t *pgt)
+{
+    size_t i;
+    __m256d y, m, jf, era, yoe, doy, doe, t, sec, isec, wn;
+
+    for (i = 0; i + 4 <= pct->n; i += 4) {
+        y = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)&pct->year[i]));
+        jf = _mm256_and_pd(_mm256_cmp_pd(y, _mm256_set1_pd(0), _CMP_GE_OQ), _mm256_cmp_pd(y, _mm256_set1_pd(100), _CMP_LT_OQ));
+        era = _mm256_and_pd(jf, _mm256_cmp_pd(y, _mm256_set1_pd(80), _CMP_LT_OQ));
+        y = _mm256_add_pd(y, _mm256_add_pd(_mm256_and_pd(jf, _mm256_set1_pd(1900)), _mm256_and_pd(era, _mm256_set1_pd(100))));
+        m = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)&pct->month[i]));
+        jf = _mm256_and_pd(_mm256_cmp_pd(m, _mm256_set1_pd(2), _CMP_LE_OQ), _mm256_set1_pd(1));
+        y = _mm256_sub_pd(y, jf);
+        era = time_avx2_floordiv(y, 400);
+        yoe = _mm256_sub_pd(y, _mm256_mul_pd(era, _mm256_set1_pd(400)));
+        m = _mm256_add_pd(_mm256_sub_pd(m, _mm256_set1_pd(3)), _mm256_mul_pd(jf, _mm256_set1_pd(12)));
+        doy = time_avx2_floordiv(_mm256_add_pd(_mm256_mul_pd(m, _mm256_set1_pd(153)), _mm256_set1_pd(2)), 5);
+        doy = _mm256_add_pd(doy, _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)&pct->day[i])));
+        doy = _mm256_sub_pd(doy, _mm256_set1_pd(1));
+        doe = _mm256_add_pd(_mm256_mul_pd(yoe, _mm256_set1_pd(365)), time_avx2_floordiv(yoe, 4));
+        doe = _mm256_add_pd(_mm256_sub_pd(doe, time_avx2_floordiv(yoe, 100)), doy);
+        t = _mm256_add_pd(_mm256_mul_pd(era, _mm256_set1_pd(146097)), doe);
+        t = _mm256_sub_pd(t, _mm256_set1_pd(TIME_GPS_EPOCH_CIVIL));
+
+        sec = _mm256_loadu_pd(&pct->second[i]);
+        isec = _mm256_round_pd(sec, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        t = _mm256_mul_pd(t, _mm256_set1_pd(ONE_DAY_SECONDS));
+        t = _mm256_add_pd(t, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)&pct->hour[i])),
+            _mm256_set1_pd(ONE_HOUR_SECONDS)));
+        t = _mm256_add_pd(t, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)&pct->minute[i])),
+            _mm256_set1_pd(ONE_MINUTE_SECONDS)));
+        t = _mm256_add_pd(t, isec);
+        wn = time_avx2_floordiv(t, ONE_WEEK_SECONDS);
+        t = _mm256_sub_pd(t, _mm256_mul_pd(wn, _mm256_set1_pd(ONE_WEEK_SECONDS)));
+
+        _mm_storeu_si128((__m128i *)&pgt->wn[i], _mm256_cvttpd_epi32(wn));
+        _mm_storeu_si128((__m128i *)&pgt->tow_sn[i], _mm256_cvttpd_epi32(t));
+        _mm256_storeu_pd(&pgt->tow_tos[i], _mm256_sub_pd(sec, isec));
+    }
+
+    return i;
+}
+
+__attribute__((target("avx512f")))
+static inline __m512d time_avx512_floordiv(__m512d a, double b)
+{
+    return _mm512_roundscale_pd(_mm512_div_pd(a, _mm512_set1_pd(b)), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+}
+
+__attribute__((target("avx512f")))
+static size_t time_soa_julianday_to_gpstime_avx512(const julianday_soa_t *pjd, gps_time_soa_t *pgt)
+{
+    size_t i;
+    __m512d t, wn;
+
+    for (i = 0; i + 8 <= pjd->n; i += 8) {
+        t = _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i *)&pjd->day[i]));
+        t = _mm512_sub_pd(t, _mm512_set1_pd(TIME_GPS_EPOCH_JD));
+        t = _mm512_mul_pd(t, _mm512_set1_pd(ONE_DAY_SECONDS));
+        t = _mm512_add_pd(t, _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i *)&pjd->tod_sn[i])));
+        t = _mm512_sub_pd(t, _mm512_set1_pd(ONE_DAY_SECONDS / 2));
+        wn = time_avx512_floordiv(t, ONE_WEEK_SECONDS);
+        t = _mm512_sub_pd(t, _mm512_mul_pd(wn, _mm512_set1_pd(ONE_WEEK_SECONDS)));
+        _mm256_storeu_si256((__m256i *)&pgt->wn[i], _mm512_cvttpd_epi32(wn));
+        _mm256_storeu_si256((__m256i *)&pgt->tow_sn[i], _mm512_cvttpd_epi32(t));
+        _mm512_storeu_pd(&pgt->tow_tos[i], _mm512_loadu_pd(&pjd->tod_tos[i]));
+    }
+
+    return i;
+}
+
+__attribute__((target("avx512f")))
+static size_t time_soa_gpstime_to_julianday_avx512(const gps_time_soa_t *pgt, julianday_soa_t *pjd)
+{
+    size_t i;
+    __m512d t, q, day;
+
+    for (i = 0; i + 8 <= pgt->n; i += 8) {
+        t = _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i *)&pgt->tow_sn[i]));
+        t = _mm512_add_pd(t, _mm512_set1_pd(ONE_DAY_SECONDS / 2));
+        q = time_avx512_floordiv(t, ONE_DAY_SECONDS);
+        day = _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i *)&pgt->wn[i]));
+        day = _mm512_add_pd(_mm512_mul_pd(day, _mm512_set1_pd(7)), q);
+        day = _mm512_add_pd(day, _mm512_set1_pd(TIME_GPS_EPOCH_JD));
+        t = _mm512_sub_pd(t, _mm512_mul_pd(q, _mm512_set1_pd(ONE_DAY_SECONDS)));
+        _mm256_storeu_si256((__m256i *)&pjd->day[i], _mm512_cvttpd_epi32(day));
+        _mm256_storeu_si256((__m256i *)&pjd->tod_sn[i], _mm512_cvttpd_epi32(t));
+        _mm512_storeu_pd(&pjd->tod_tos[i], _mm512_loadu_pd(&pgt->tow_tos[i]));
+    }
+
+    return i;
+}
+
+__attribute__((target("avx512f")))
+static size_t time_soa_gpstime_to_commontime_avx512(const gps_time_soa_t *pgt, common_time_soa_t *pct)
+{
+    size_t i;
+    __m512d t, z, sod, era, doe, yoe, y, doy, mp, d, m, hh, mm;
+    __mmask8 k;
+
+    for (i = 0; i + 8 <= pgt->n; i += 8) {
+        t = _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i *)&pgt->wn[i]));
+        t = _mm512_mul_pd(t, _mm512_set1_pd(ONE_WEEK_SECONDS));
+        t = _mm512_add_pd(t, _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i *)&pgt->tow_sn[i])));
+        z = time_avx512_floordiv(t, ONE_DAY_SECONDS);
+        sod = _mm512_sub_pd(t, _mm512_mul_pd(z, _mm512_set1_pd(ONE_DAY_SECONDS)));
+
+        z = _mm512_add_pd(z, _mm512_set1_pd(TIME_GPS_EPOCH_CIVIL));
+        era = time_avx512_floordiv(z, 146097);
+        doe = _mm512_sub_pd(z, _mm512_mul_pd(era, _mm512_set1_pd(146097)));
+        yoe = _mm512_sub_pd(doe, time_avx512_floordiv(doe, 1460));
+        yoe = _mm512_add_pd(yoe, time_avx512_floordiv(doe, 36524));
+        yoe = _mm512_sub_pd(yoe, time_avx512_floordiv(doe, 146096));
+        yoe = time_avx512_floordiv(yoe, 365);
+        y = _mm512_add_pd(yoe, _mm512_mul_pd(era, _mm512_set1_pd(400)));
+        doy = _mm512_add_pd(_mm512_mul_pd(yoe, _mm512_set1_pd(365)), time_avx512_floordiv(yoe, 4));
+        doy = _mm512_sub_pd(doe, _mm512_sub_pd(doy, time_avx512_floordiv(yoe, 100)));
+        mp = time_avx512_floordiv(_mm512_add_pd(_mm512_mul_pd(doy, _mm512_set1_pd(5)), _mm512_set1_pd(2)), 153);
+        d = time_avx512_floordiv(_mm512_add_pd(_mm512_mul_pd(mp, _mm512_set1_pd(153)), _mm512_set1_pd(2)), 5);
+        d = _mm512_add_pd(_mm512_sub_pd(doy, d), _mm512_set1_pd(1));
+        k = _mm512_cmp_pd_mask(mp, _mm512_set1_pd(10), _CMP_GE_OQ);
+        m = _mm512_mask_blend_pd(k, _mm512_add_pd(mp, _mm512_set1_pd(3)), _mm512_sub_pd(mp, _mm512_set1_pd(9)));
+        k = _mm512_cmp_pd_mask(m, _mm512_set1_pd(2), _CMP_LE_OQ);
+        y = _mm512_mask_add_pd(y, k, y, _mm512_set1_pd(1));
+
+        hh = time_avx512_floordiv(sod, ONE_HOUR_SECONDS);
+        sod = _mm512_sub_pd(sod, _mm512_mul_pd(hh, _mm512_set1_pd(ONE_HOUR_SECONDS)));
+        mm = time_avx512_floordiv(sod, ONE_MINUTE_SECONDS);
+        sod = _mm512_sub_pd(sod, _mm512_mul_pd(mm, _mm512_set1_pd(ONE_MINUTE_SECONDS)));
+
+        _mm256_storeu_si256((__m256i *)&pct->year[i], _mm512_cvttpd_epi32(y));
+        _mm256_storeu_si256((__m256i *)&pct->month[i], _mm512_cvttpd_epi32(m));
+        _mm256_storeu_si256((__m256i *)&pct->day[i], _mm512_cvttpd_epi32(d));
+        _mm256_storeu_si256((__m256i *)&pct->hour[i], _mm512_cvttpd_epi32(hh));
+        _mm256_storeu_si256((__m256i *)&pct->minute[i], _mm512_cvttpd_epi32(mm));
+        _mm512_storeu_pd(&pct->second[i], _mm512_add_pd(sod, _mm512_loadu_pd(&pgt->tow_tos[i])));
+    }
+
+    return i;
+}
+
+__attribute__((target("avx512f")))
+static size_t time_soa_commontime_to_gpstime_avx512(const common_time_soa_t *pct, gps_time_soa_t *pgt)
+{
+    size_t i;
+    __m512d y, m, era, yoe, doy, doe, t, sec, isec, wn;
+    __mmask8 k;
+
+    for (i = 0; i + 8 <= pct->n; i += 8) {
+        y = _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i *)&pct->year[i]));
+        k = _mm512_cmp_pd_mask(y, _mm512_set1_pd(0), _CMP_GE_OQ) & _mm512_cmp_pd_mask(y, _mm512_set1_pd(100), _CMP_LT_OQ);
+        y = _mm512_mask_add_pd(y, k & _mm512_cmp_pd_mask(y, _mm512_set1_pd(80), _CMP_LT_OQ), y, _mm512_set1_pd(100));
+        y = _mm512_mask_add_pd(y, k, y, _mm512_set1_pd(1900));
+        m = _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i *)&pct->month[i]));
+        k = _mm512_cmp_pd_mask(m, _mm512_set1_pd(2), _CMP_LE_OQ);
+        y = _mm512_mask_sub_pd(y, k, y, _mm512_set1_pd(1));
+        era = time_avx512_floordiv(y, 400);
+        yoe = _mm512_sub_pd(y, _mm512_mul_pd(era, _mm512_set1_pd(400)));
+        m = _mm512_sub_pd(m, _mm512_set1_pd(3));
+        m = _mm512_mask_add_pd(m, k, m, _mm512_set1_pd(12));
+        doy = time_avx512_floordiv(_mm512_add_pd(_mm512_mul_pd(m, _mm512_set1_pd(153)), _mm512_set1_pd(2)), 5);
+        doy = _mm512_add_pd(doy, _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i *)&pct->day[i])));
+        doy = _mm512_sub_pd(doy, _mm512_set1_pd(1));
+        doe = _mm512_add_pd(_mm512_mul_pd(yoe, _mm512_set1_pd(365)), time_avx512_floordiv(yoe, 4));
+        doe = _mm512_add_pd(_mm512_sub_pd(doe, time_avx512_floordiv(yoe, 100)), doy);
+        t = _mm512_add_pd(_mm512_mul_pd(era, _mm512_set1_pd(146097)), doe);
+        t = _mm512_sub_pd(t, _mm512_set1_pd(TIME_GPS_EPOCH_CIVIL));
+
+        sec = _mm512_loadu_pd(&pct->second[i]);
+        isec = _mm512_roundscale_pd(sec, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        t = _mm512_mul_pd(t, _mm512_set1_pd(ONE_DAY_SECONDS));
+        t = _mm512_add_pd(t, _mm512_mul_pd(_mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i *)&pct->hour[i])),
+            _mm512_set1_pd(ONE_HOUR_SECONDS)));
+        t = _mm512_add_pd(t, _mm512_mul_pd(_mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i *)&pct->minute[i])),
+            _mm512_set1_pd(ONE_MINUTE_SECONDS)));
+        t = _mm512_add_pd(t, isec);
+        wn = time_avx512_floordiv(t, ONE_WEEK_SECONDS);
+        t = _mm512_sub_pd(t, _mm512_mul_pd(wn, _mm512_set1_pd(ONE_WEEK_SECONDS)));
+
+        _mm256_storeu_si256((__m256i *)&pgt->wn[i], _mm512_cvttpd_epi32(wn));
+        _mm256_storeu_si256((__m256i *)&pgt->tow_sn[i], _mm512_cvttpd_epi32(t));
+        _mm512_storeu_pd(&pgt->tow_tos[i], _mm512_sub_pd(sec, isec));
+    }
+
+    return i;
+}
+#endif
+
+typedef enum time_simd_level_e {
+    TIME_SIMD_NONE,
+    TIME_SIMD_AVX2,
+    TIME_SIMD_AVX512
+} time_simd_level_t;
+
+//运行时检测CPU支持的指令集, 只读取CPU特性, 无需缓存状态
+static time_simd_level_t time_simd_level(void)
+{
+#if TIME_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return TIME_SIMD_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return TIME_SIMD_AVX2;
+    }
+#endif
+    return TIME_SIMD_NONE;
+}
+
+/*
+ * 列存储批量转换入口: 按CPU能力分派到AVX-512/AVX2内核, 剩余尾部元素及不支持SIMD时走标量内核.
+ * 输出容器的n须不小于输入容器的n.
+ */
+static void time_conver_julianday_to_gpstime_soa(const julianday_soa_t *pjd, gps_time_soa_t *pgt)
+{
+    size_t done = 0;
+
+#if TIME_SIMD_X86
+    switch (time_simd_level()) {
+        case TIME_SIMD_AVX512:
+            done = time_soa_julianday_to_gpstime_avx512(pjd, pgt);
+            break;
+        case TIME_SIMD_AVX2:
+            done = time_soa_julianday_to_gpstime_avx2(pjd, pgt);
+            break;
+        default:
+            break;
+    }
+#endif
+    time_soa_julianday_to_gpstime_scalar(pjd, pgt, done);
+}
+
+static void time_conver_gpstime_to_julianday_soa(const gps_time_soa_t *pgt, julianday_soa_t *pjd)
+{
+    size_t done = 0;
+
+#if TIME_SIMD_X86
+    switch (time_simd_level()) {
+        case TIME_SIMD_AVX512:
+            done = time_soa_gpstime_to_julianday_avx512(pgt, pjd);
+            break;
+        case TIME_SIMD_AVX2:
+            done = time_soa_gpstime_to_julianday_avx2(pgt, pjd);
+            break;
+        default:
+            break;
+    }
+#endif
+    time_soa_gpstime_to_julianday_scalar(pgt, pjd, done);
+}
+
+static void time_conver_gpstime_to_commontime_soa(const gps_time_soa_t *pgt, common_time_soa_t *pct)
+{
+    size_t done = 0;
+
+#if TIME_SIMD_X86
+    switch (time_simd_level()) {
+        case TIME_SIMD_AVX512:
+            done = time_soa_gpstime_to_commontime_avx512(pgt, pct);
+            break;
+        case TIME_SIMD_AVX2:
+            done = time_soa_gpstime_to_commontime_avx2(pgt, pct);
+            break;
+        default:
+            break;
+    }
+#endif
+    time_soa_gpstime_to_commontime_scalar(pgt, pct, done);
+}
+
+static void time_conver_commontime_to_gpstime_soa(const common_time_soa_t *pct, gps_time_soa_t *pgt)
+{
+    size_t done = 0;
+
+#if TIME_SIMD_X86
+    switch (time_simd_level()) {
+        case TIME_SIMD_AVX512:
+            done = time_soa_commontime_to_gpstime_avx512(pct, pgt);
+            break;
+        case TIME_SIMD_AVX2:
+            done = time_soa_commontime_to_gpstime_avx2(pct, pgt);
+            break;
+        default:
+            break;
+    }
+#endif
+    time_soa_commontime_to_gpstime_scalar(pct, pgt, done);
+}
+
+/*
+ * 时间间隔运算: 各种表示直接加减秒数、求差、比较和规格化, 不经过其他表示.
+ * GPS时、儒略日、简化儒略日都是"大单位 + 单位内秒数": 进位只在周内秒/天内秒与周数/天数之间,
+ * 由TIME_ARITH_DEFINE按字段和周期生成; 年积日跨年时按年长进位, 求差用年首天数公式;
+ * 通用时跨月时才换算日历. 通用时按不含跳秒的连续时标计算, 与其他转换一致.
+ * 规格化后秒小数在[0, 1)内, 周内秒、天内秒、时分秒在各自范围内.
+ * 求差返回 a - b 的秒数: 整数部分先按整数运算, 最后才与秒小数之差相加, 不受大数值的有效位限制.
+ */
+//*pv向下取整后返回整数部分, *pv留下[0, 1)内的小数
+static long time_frac_carry(double *pv)
+{
+    long q = (long)*pv;
+
+    if (*pv < q) {
+        q--;
+    }
+    *pv -= q;
+    if (*pv >= 1.0) {
+        *pv -= 1.0;
+        q++;
+    }
+
+    return q;
+}
+
+//*pv按range向下取整除, 返回商, *pv留下[0, range)内的余数
+static long time_carry(long *pv, long range)
+{
+    long q = *pv / range;
+    long r = *pv % range;
+
+    if (r < 0) {
+        r += range;
+        q--;
+    }
+    *pv = r;
+
+    return q;
+}
+
+#define TIME_ARITH_DEFINE(name, type, major, minor, period) \
+static void time_##name##_normalize(type *pt) \
+{ \
+    long sn = pt->minor.sn + time_frac_carry(&pt->minor.tos); \
+    \
+    pt->major += time_carry(&sn, (period)); \
+    pt->minor.sn = sn; \
+} \
+\
+static void time_##name##_add(type *pt, double sec) \
+{ \
+    pt->minor.sn += time_frac_carry(&sec); \
+    pt->minor.tos += sec; \
+    time_##name##_normalize(pt); \
+} \
+\
+static double time_##name##_diff(const type *pa, const type *pb) \
+{ \
+    return (double)(((long long)pa->major - pb->major) * (period) + (pa->minor.sn - pb->minor.sn)) \
+        + (pa->minor.tos - pb->minor.tos); \
+} \
+\
+static int time_##name##_cmp(const type *pa, const type *pb) \
+{ \
+    double d = time_##name##_diff(pa, pb); \
+    \
+    return (d > 0) - (d < 0); \
+}
+
+TIME_ARITH_DEFINE(gpstime, gps_time_t, wn, tow, ONE_WEEK_SECONDS)
+TIME_ARITH_DEFINE(julianday, julianday_t, day, tod, ONE_DAY_SECONDS)
+TIME_ARITH_DEFINE(mjd, new_julianday_t, day, tod, ONE_DAY_SECONDS)
+
+/*
+ * 年积日的年份为unsigned short, 两位年份与通用时一样补全为四位, 因此只能表示100年1月1日至65535年12月31日;
+ * 规格化、加秒的结果超出这一范围时返回-1, 原值不变.
+ */
+#define TIME_DOY_DAYS_MIN   (-683003LL)     //100年1月1日的日数
+#define TIME_DOY_DAYS_END   (23217004LL)    //65536年1月1日的日数
+
+//年积日所在日的日数, 两位年份补全
+static long long time_doy_days(const doy_t *pdoy)
+{
+    return time_days_from_civil(time_civil_year(pdoy->year), 1, 1) + pdoy->day - 1;
+}
+
+//年积日规格化, 天内秒进位到日数后一次换算出年和年积日
+static int time_doy_normalize(doy_t *pdoy)
+{
+    double tos = pdoy->tod.tos;
+    long sn = pdoy->tod.sn + time_frac_carry(&tos);
+    long long days = time_doy_days(pdoy) + time_carry(&sn, ONE_DAY_SECONDS);
+    int year, day;
+
+    if (days < TIME_DOY_DAYS_MIN || days >= TIME_DOY_DAYS_END) {
+        return -1;
+    }
+    time_doy_from_days(days, &year, &day);
+
+    pdoy->year = (unsigned short)year;
+    pdoy->day = (unsigned short)day;
+    pdoy->tod.sn = sn;
+    pdoy->tod.tos = tos;
+
+    return 0;
+}
+
+static int time_doy_add(doy_t *pdoy, double sec)
+{
+    doy_t t = *pdoy;
+
+    t.tod.sn += time_frac_carry(&sec);
+    t.tod.tos += sec;
+    if (time_doy_normalize(&t) != 0) {
+        return -1;
+    }
+    *pdoy = t;
+
+    return 0;
+}
+
+static double time_doy_diff(const doy_t *pa, const doy_t *pb)
+{
+    long long days = time_doy_days(pa) - time_doy_days(pb);
+
+    return (double)(days * ONE_DAY_SECONDS + (pa->tod.sn - pb->tod.sn)) + (pa->tod.tos - pb->tod.tos);
+}
+
+static int time_doy_cmp(const doy_t *pa, const doy_t *pb)
+{
+    double d = time_doy_diff(pa, pb);
+
+    return (d > 0) - (d < 0);
+}
+
+//通用时规格化, 秒、分、时依次进位, 日期超出本月时才换算日历; 两位年份总是补全为四位
+static void time_commontime_normalize(common_time_t *pct)
+{
+    long isec = time_frac_carry(&pct->second);
+    long sod = pct->hour * ONE_HOUR_SECONDS + pct->minute * ONE_MINUTE_SECONDS + isec;
+    long carry = time_carry(&sod, ONE_DAY_SECONDS);
+    long month = pct->month - 1;
+    int year = time_civil_year(pct->year) + (int)time_carry(&month, 12);
+    long day = pct->day + carry;
+
+    pct->hour = (int)(sod / ONE_HOUR_SECONDS);
+    pct->minute = (int)((sod % ONE_HOUR_SECONDS) / ONE_MINUTE_SECONDS);
+    pct->second += sod % ONE_MINUTE_SECONDS;
+    pct->month = (int)month + 1;
+    pct->year = year;
+
+    if (day < 1 || day > g_month_days_before[time_is_leap_year(year)][month + 1]
+        - g_month_days_before[time_is_leap_year(year)][month]) {
+        time_civil_from_days(time_days_from_civil(year, pct->month, 1) + day - 1,
+            &pct->year, &pct->month, &pct->day);
+    } else {
+        pct->day = (int)day;
+    }
+}
+
+static void time_commontime_add(common_time_t *pct, double sec)
+{
+    long isec = time_frac_carry(&sec);
+
+    pct->second += sec;
+    pct->minute += (int)(isec / ONE_MINUTE_SECONDS);
+    pct->second += isec % ONE_MINUTE_SECONDS;
+    time_commontime_normalize(pct);
+}
+
+static double time_commontime_diff(const common_time_t *pa, const common_time_t *pb)
+{
+    long long days = 0;
+
+    if (pa->day != pb->day || pa->month != pb->month || pa->year != pb->year) {
+        days = time_days_from_civil(time_civil_year(pa->year), pa->month, pa->day)
+            - time_days_from_civil(time_civil_year(pb->year), pb->month, pb->day);
+    }
+
+    return (double)(days * ONE_DAY_SECONDS + (pa->hour - pb->hour) * ONE_HOUR_SECONDS
+        + (pa->minute - pb->minute) * ONE_MINUTE_SECONDS) + (pa->second - pb->second);
+}
+
+static int time_commontime_cmp(const common_time_t *pa, const common_time_t *pb)
+{
+    double d = time_commontime_diff(pa, pb);
+
+    return (d > 0) - (d < 0);
+}
+
+/*
+ * 批量间隔运算: pt[i] += sec(就地), pdiff[i] = pa[i] - pb[i](pa、pb只读, 可以是同一数组错开一位),
+ * 就地保留[*plo, *phi)内的元素(plo、phi为NULL时该端不限)并返回保留的个数.
+ * 求差只读pa、pb, 下一条与上一条相减(--interval)时不需要临时数组; 筛选按原顺序前移保留的元素,
+ * ptag非NULL时其中的行号等标记随元素一同前移.
+ */
+#define TIME_ARITH_BATCH_DEFINE(name, type) \
+static void time_##name##_add_batch(type *pt, double sec, size_t n) \
+{ \
+    size_t i; \
+    \
+    for (i = 0; i < n; i++) { \
+        time_##name##_add(&pt[i], sec); \
+    } \
+} \
+\
+static void time_##name##_diff_batch(const type *restrict pa, const type *restrict pb, double *restrict pdiff, \
+    size_t n) \
+{ \
+    size_t i; \
+    \
+    for (i = 0; i < n; i++) { \
+        pdiff[i] = time_##name##_diff(&pa[i], &pb[i]); \
+    } \
+} \
+\
+static size_t time_##name##_select(type *pt, size_t n, const type *plo, const type *phi, size_t *ptag) \
+{ \
+    size_t i, m = 0; \
+    \
+    for (i = 0; i < n; i++) { \
+        if ((plo == NULL || time_##name##_cmp(&pt[i], plo) >= 0) \
+            && (phi == NULL || time_##name##_cmp(&pt[i], phi) < 0)) { \
+            if (ptag != NULL) { \
+                ptag[m] = ptag[i]; \
+            } \
+            pt[m++] = pt[i]; \
+        } \
+    } \
+    \
+    return m; \
+}
+
+TIME_ARITH_BATCH_DEFINE(gpstime, gps_time_t)
+TIME_ARITH_BATCH_DEFINE(julianday, julianday_t)
+TIME_ARITH_BATCH_DEFINE(mjd, new_julianday_t)
+TIME_ARITH_BATCH_DEFINE(doy, doy_t)
+TIME_ARITH_BATCH_DEFINE(commontime, common_time_t)
+
+/*
+ * 纳秒时间: 自GPS起点(1980-01-06 0时)起的纳秒数, int64可表示约±292年(约1688-2272年).
+ * 与四种表示之间只用整数乘除换算, 秒小数tos按最近的纳秒取整;
+ * 纳秒时间转出后再转回得到原值, 不受儒略日等大数值下双精度有效位的限制.
+ * 转换到纳秒时间时超出±TIME_NS_SECONDS_MAX秒或秒小数不在(-1, 1)内的时间返回-1, 不做计算.
+ */
+#define TIME_NS_PER_SECOND  (1000000000LL)
+#define TIME_NS_PER_DAY     (ONE_DAY_SECONDS * TIME_NS_PER_SECOND)
+#define TIME_NS_PER_WEEK    (ONE_WEEK_SECONDS * TIME_NS_PER_SECOND)
+#define TIME_NS_SECONDS_MAX (INT64_MAX / TIME_NS_PER_SECOND - 1)   //纳秒时间可表示的整秒数上限, 留出秒小数的余量
+#define TIME_NS_DAYS_MAX    (TIME_NS_SECONDS_MAX / ONE_DAY_SECONDS + 7)     //天数上限, 留出周数取整到周首的余量
+
+typedef int64_t time_ns_t;
+
+//秒小数到纳秒, 四舍五入
+static long long time_ns_from_tos(double tos)
+{
+    double v = tos * (double)TIME_NS_PER_SECOND;
+
+    return (long long)(v >= 0 ? v + 0.5 : v - 0.5);
+}
+
+//自GPS起点起的天数、秒数(可超出一天)和秒小数合成纳秒时间, 超出范围返回-1; 各部分先检查范围再相乘, 不会溢出
+static int time_ns_make(long long days, long long sec, double tos, time_ns_t *pns)
+{
+    long long t;
+
+    if (days < -TIME_NS_DAYS_MAX || days > TIME_NS_DAYS_MAX || sec < -TIME_NS_SECONDS_MAX || sec > TIME_NS_SECONDS_MAX
+        || !(tos > -1.0 && tos < 1.0)) {
+        return -1;
+    }
+    t = days * ONE_DAY_SECONDS + sec;
+    if (t < -TIME_NS_SECONDS_MAX || t > TIME_NS_SECONDS_MAX) {
+        return -1;
+    }
+    *pns = (time_ns_t)(t * TIME_NS_PER_SECOND + time_ns_from_tos(tos));
+
+    return 0;
+}
+
+//纳秒时间拆为自GPS起点起的整秒数和秒小数
+static long long time_ns_split(time_ns_t ns, double *ptos)
+{
+    long long t = time_floor_div(ns, TIME_NS_PER_SECOND);
+
+    *ptos = (double)(ns - t * TIME_NS_PER_SECOND) / (double)TIME_NS_PER_SECOND;
+
+    return t;
+}
+
+//GPS时到纳秒时间的转换, 成功返回0, 超出纳秒时间范围返回-1
+static int time_conver_gpstime_to_ns(const gps_time_t *pgt, time_ns_t *pns)
+{
+    return time_ns_make((long long)pgt->wn * 7, pgt->tow.sn, pgt->tow.tos, pns);
+}
+
+//纳秒时间到GPS时的转换
+static void time_conver_ns_to_gpstime(const time_ns_t *pns, gps_time_t *pgt)
+{
+    long long t, wn;
+
+    t = time_ns_split(*pns, &pgt->tow.tos);
+    wn = time_floor_div(t, ONE_WEEK_SECONDS);
+
+    pgt->wn = (int)wn;
+    pgt->tow.sn = (long)(t - wn * ONE_WEEK_SECONDS);
+}
+
+//通用时到纳秒时间的转换, 成功返回0, 超出纳秒时间范围返回-1
+static int time_conver_commontime_to_ns(const common_time_t *pct, time_ns_t *pns)
+{
+    long long isec;
+
+    if (!(pct->second > -TIME_NS_SECONDS_MAX && pct->second < TIME_NS_SECONDS_MAX)) {
+        return -1;
+    }
+    isec = (long long)pct->second;
+
+    return time_ns_make(time_days_from_civil(time_civil_year(pct->year), pct->month, pct->day) - TIME_GPS_EPOCH_DAYS,
+        (long long)pct->hour * ONE_HOUR_SECONDS + (long long)pct->minute * ONE_MINUTE_SECONDS + isec,
+        pct->second - isec, pns);
+}
+
+//纳秒时间到通用时的转换
+static void time_conver_ns_to_commontime(const time_ns_t *pns, common_time_t *pct)
+{
+    long long t, days;
+    double tos;
+    long sod;
+
+    t = time_ns_split(*pns, &tos);
+    days = time_floor_div(t, ONE_DAY_SECONDS);
+    sod = (long)(t - days * ONE_DAY_SECONDS);
+
+    time_civil_from_days(days + TIME_GPS_EPOCH_DAYS, &pct->year, &pct->month, &pct->day);
+    pct->hour = sod / ONE_HOUR_SECONDS;
+    pct->minute = (sod % ONE_HOUR_SECONDS) / ONE_MINUTE_SECONDS;
+    pct->second = sod % ONE_MINUTE_SECONDS + tos;
+}
+
+//儒略日到纳秒时间的转换, 儒略日从正午起算; 成功返回0, 超出纳秒时间范围返回-1
+static int time_conver_julianday_to_ns(const julianday_t *pjd, time_ns_t *pns)
+{
+    if (pjd->day < TIME_GPS_EPOCH_JD - TIME_NS_DAYS_MAX || pjd->day > TIME_GPS_EPOCH_JD + TIME_NS_DAYS_MAX
+        || pjd->tod.sn < -TIME_NS_SECONDS_MAX || pjd->tod.sn > TIME_NS_SECONDS_MAX) {
+        return -1;
+    }
+
+    return time_ns_make(pjd->day - TIME_GPS_EPOCH_JD, pjd->tod.sn - ONE_DAY_SECONDS / 2, pjd->tod.tos, pns);
+}
+
+//纳秒时间到儒略日的转换
+static void time_conver_ns_to_julianday(const time_ns_t *pns, julianday_t *pjd)
+{
+    long long t, q;
+
+    t = time_ns_split(*pns, &pjd->tod.tos) + ONE_DAY_SECONDS / 2;
+    q = time_floor_div(t, ONE_DAY_SECONDS);
+
+    pjd->day = (long)(TIME_GPS_EPOCH_JD + q);
+    pjd->tod.sn = (long)(t - q * ONE_DAY_SECONDS);
+}
+
+//年积日到纳秒时间的转换, 成功返回0, 超出纳秒时间范围返回-1
+static int time_conver_doy_to_ns(const doy_t *pdoy, time_ns_t *pns)
+{
+    return time_ns_make(time_days_from_civil(pdoy->year, 1, 1) + pdoy->day - 1 - TIME_GPS_EPOCH_DAYS, pdoy->tod.sn,
+        pdoy->tod.tos, pns);
+}
+
+//纳秒时间到年积日的转换
+static void time_conver_ns_to_doy(const time_ns_t *pns, doy_t *pdoy)
+{
+    long long t, days;
+    int year, day;
+
+    t = time_ns_split(*pns, &pdoy->tod.tos);
+    days = time_floor_div(t, ONE_DAY_SECONDS);
+
+    time_doy_from_days(days + TIME_GPS_EPOCH_DAYS, &year, &day);
+    pdoy->year = (unsigned short)year;
+    pdoy->day = (unsigned short)day;
+    pdoy->tod.sn = (long)(t - days * ONE_DAY_SECONDS);
+}
+
+/*
+ * 到纳秒时间的批量转换: 超出范围的时间不输出, 其余依次紧凑写入pout, 返回写入的个数;
+ * ptag非NULL时与输出一同压缩(如输入行号), 超出范围的时间的标记依次写入pbad(可为NULL).
+ */
+#define TIME_CONVER_NS_BATCH_DEFINE(from, from_t) \
+static size_t time_conver_##from##_to_ns_batch(const from_t *restrict pin, time_ns_t *restrict pout, size_t n, \
+    size_t *restrict ptag, size_t *restrict pbad) \
+{ \
+    size_t i, m = 0, k = 0; \
+    \
+    for (i = 0; i < n; i++) { \
+        if (time_conver_##from##_to_ns(&pin[i], &pout[m]) != 0) { \
+            if (pbad != NULL) { \
+                pbad[k++] = (ptag != NULL) ? ptag[i] : i; \
+            } \
+            continue; \
+        } \
+        if (ptag != NULL) { \
+            ptag[m] = ptag[i]; \
+        } \
+        m++; \
+    } \
+    \
+    return m; \
+}
+
+TIME_CONVER_NS_BATCH_DEFINE(gpstime, gps_time_t)
+TIME_CONVER_BATCH_DEFINE(ns, time_ns_t, gpstime, gps_time_t)
+TIME_CONVER_NS_BATCH_DEFINE(commontime, common_time_t)
+TIME_CONVER_BATCH_DEFINE(ns, time_ns_t, commontime, common_time_t)
+TIME_CONVER_NS_BATCH_DEFINE(julianday, julianday_t)
+TIME_CONVER_BATCH_DEFINE(ns, time_ns_t, julianday, julianday_t)
+TIME_CONVER_NS_BATCH_DEFINE(doy, doy_t)
+TIME_CONVER_BATCH_DEFINE(ns, time_ns_t, doy, doy_t)
+
+/*
+ * 流式转换: 接收机按时间顺序输出的历元绝大多数与上一历元在同一天.
+ * time_stream_t记住上一历元所在的GPS日及其日历(年月日、年积日、儒略日、GPS周),
+ * 同一天内只需由天内秒拆出时分秒, 跨天(包括跨月、跨年)时才重新计算日历.
+ * 历元不要求单调, 落在缓存日之外即重新计算; 结果与time_conver_*逐个转换完全相同.
+ * 每个数据流(线程)使用各自的time_stream_t.
+ */
+typedef struct time_stream_s {
+    bool valid;
+    long long day_start;    //缓存日零时自GPS起点起的秒数
+    int wn;                 //缓存日所在GPS周
+    long dow_sn;            //缓存日零时的周内秒
+    long jd;                //缓存日零时的儒略日整数部分
+    bool civil_valid;       //日历部分只在GPS时输入需要时计算
+    int year;               //缓存日的通用时日期
+    int month;
+    int day;
+    int doy_year;           //缓存日的年积日
+    int doy_day;
+    bool ct_valid;          //上次通用时输入的原始年月日(可为两位年份)及由其得到的年积日
+    int ct_year;
+    int ct_month;
+    int ct_day;
+    int ct_doy;
+} time_stream_t;
+
+static void time_stream_init(time_stream_t *ps)
+{
+    memset(ps, 0, sizeof(*ps));
+}
+
+//切换缓存日, days为自GPS起点起的天数
+static void time_stream_resolve(time_stream_t *ps, long long days)
+{
+    long long wn = time_floor_div(days, 7);
+
+    ps->day_start = days * ONE_DAY_SECONDS;
+    ps->wn = (int)wn;
+    ps->dow_sn = (long)((days - wn * 7) * ONE_DAY_SECONDS);
+    ps->jd = (long)(TIME_GPS_EPOCH_JD + days);
+    ps->valid = true;
+    ps->civil_valid = false;
+    ps->ct_valid = false;
+}
+
+//计算缓存日的年月日和年积日
+static void time_stream_resolve_civil(time_stream_t *ps)
+{
+    long long days = ps->day_start / ONE_DAY_SECONDS + TIME_GPS_EPOCH_DAYS;
+
+    time_civil_from_days(days, &ps->year, &ps->month, &ps->day);
+    time_doy_from_days(days, &ps->doy_year, &ps->doy_day);
+    ps->civil_valid = true;
+}
+
+//由缓存日和天内秒输出儒略日, 儒略日从正午起算
+static void time_stream_julianday(const time_stream_t *ps, long sod, double tos, julianday_t *pjd)
+{
+    if (sod < ONE_DAY_SECONDS / 2) {
+        pjd->day = ps->jd;
+        pjd->tod.sn = sod + ONE_DAY_SECONDS / 2;
+    } else {
+        pjd->day = ps->jd + 1;
+        pjd->tod.sn = sod - ONE_DAY_SECONDS / 2;
+    }
+    pjd->tod.tos = tos;
+}
+
+//GPS时输入, 输出通用时、儒略日、年积日, 不需要的传NULL
+static void time_stream_gpstime(time_stream_t *ps, const gps_time_t *pgt, common_time_t *pct, julianday_t *pjd,
+    doy_t *pdoy)
+{
+    long long t = (long long)pgt->wn * ONE_WEEK_SECONDS + pgt->tow.sn;
+    long long sod = t - ps->day_start;
+
+    if (!ps->valid || sod < 0 || sod >= ONE_DAY_SECONDS) {
+        time_stream_resolve(ps, time_floor_div(t, ONE_DAY_SECONDS));
+        sod = t - ps->day_start;
+    }
+    if (!ps->civil_valid && (pct != NULL || pdoy != NULL)) {
+        time_stream_resolve_civil(ps);
+    }
+
+    if (pct != NULL) {
+        pct->year = ps->year;
+        pct->month = ps->month;
+        pct->day = ps->day;
+        pct->hour = (int)(sod / ONE_HOUR_SECONDS);
+        pct->minute = (int)((sod % ONE_HOUR_SECONDS) / ONE_MINUTE_SECONDS);
+        pct->second = sod % ONE_MINUTE_SECONDS + pgt->tow.tos;
+    }
+    if (pjd != NULL) {
+        time_stream_julianday(ps, (long)sod, pgt->tow.tos, pjd);
+    }
+    if (pdoy != NULL) {
+        pdoy->year = (unsigned short)ps->doy_year;
+        pdoy->day = (unsigned short)ps->doy_day;
+        pdoy->tod.sn = (long)sod;
+        pdoy->tod.tos = pgt->tow.tos;
+    }
+}
+
+//通用时输入, 输出GPS时、儒略日、年积日, 不需要的传NULL
+static void time_stream_commontime(time_stream_t *ps, const common_time_t *pct, gps_time_t *pgt, julianday_t *pjd,
+    doy_t *pdoy)
+{
+    int isec = (int)pct->second;
+    long sod = pct->hour * ONE_HOUR_SECONDS + pct->minute * ONE_MINUTE_SECONDS + isec;
+    double tos = pct->second - isec;
+    bool same = ps->ct_valid && pct->day == ps->ct_day && pct->month == ps->ct_month && pct->year == ps->ct_year;
+
+    //时分秒超出一天或年月日无效(缓存日之外的日期才需检查)时按单点转换处理
+    if (sod < 0 || sod >= ONE_DAY_SECONDS || (!same && !time_civil_valid(pct->year, pct->month, pct->day))) {
+        if (pgt != NULL) {
+            time_conver_commontime_to_gpstime(pct, pgt);
+        }
+        if (pjd != NULL) {
+            time_conver_commontime_to_julianday(pct, pjd);
+        }
+        if (pdoy != NULL) {
+            time_conver_commontime_to_doy(pct, pdoy);
+        }
+        return;
+    }
+
+    if (!same) {
+        time_stream_resolve(ps, time_days_from_civil(time_civil_year(pct->year), pct->month, pct->day)
+            - TIME_GPS_EPOCH_DAYS);
+        ps->ct_valid = true;
+        ps->ct_year = pct->year;
+        ps->ct_month = pct->month;
+        ps->ct_day = pct->day;
+        ps->ct_doy = g_month_days_before[time_is_leap_year(pct->year)][pct->month - 1] + pct->day;
+    }
+
+    if (pgt != NULL) {
+        pgt->wn = ps->wn;
+        pgt->tow.sn = ps->dow_sn + sod;
+        pgt->tow.tos = tos;
+    }
+    if (pjd != NULL) {
+        time_stream_julianday(ps, sod, tos, pjd);
+    }
+    if (pdoy != NULL) {
+        pdoy->year = (unsigned short)pct->year;
+        pdoy->day = (unsigned short)ps->ct_doy;
+        pdoy->tod.sn = sod;
+        pdoy->tod.tos = tos;
+    }
+}
+
+/*
+ * 跳秒表: UTC与GPS时(GPST)、国际原子时(TAI)之间的换算.
+ * TAI - GPST 恒为19秒; GPST - UTC = (TAI - UTC) - 19, 随跳秒增加(2017年起为18秒).
+ * 表项按生效时刻升序排列, 同时记录生效时刻在UTC和GPST两种时标下相对GPS起点的秒数,
+ * 查找时先检查上次命中的区间及其后一个区间(顺序数据流几乎总是命中), 否则二分查找.
+ * 表内含缓存下标, 多线程使用时每个线程应持有各自的表副本.
+ */
+#define TIME_TAI_MINUS_GPS  (19)
+#define TIME_LEAP_MAX       (64)
+#define TIME_NTP_EPOCH_DAYS (25567)     //1900-01-01相对1970-01-01的天数
+
+typedef struct time_leap_entry_s {
+    long long utc_start;    //生效时刻, UTC时标下自GPS起点起的秒数
+    long long gps_start;    //生效时刻, GPST时标下自GPS起点起的秒数
+    int tai_utc;            //TAI - UTC(秒)
+} time_leap_entry_t;
+
+typedef struct time_leap_table_s {
+    time_leap_entry_t entry[TIME_LEAP_MAX];
+    int count;
+    int last;               //上次命中的区间下标
+} time_leap_table_t;
+
+//内置跳秒表(IERS公报C), 生效日期均为当日0时UTC
+static const struct {
+    short year;
+    char month;
+    char tai_utc;
+} g_leap_builtin[] = {
+    {1972, 1, 10}, {1972, 7, 11}, {1973, 1, 12}, {1974, 1, 13}, {1975, 1, 14}, {1976, 1, 15},
+    {1977, 1, 16}, {1978, 1, 17}, {1979, 1, 18}, {1980, 1, 19}, {1981, 7, 20}, {1982, 7, 21},
+    {1983, 7, 22}, {1985, 7, 23}, {1988, 1, 24}, {1990, 1, 25}, {1991, 1, 26}, {1992, 7, 27},
+    {1993, 7, 28}, {1994, 7, 29}, {1996, 1, 30}, {1997, 7, 31}, {1999, 1, 32}, {2006, 1, 33},
+    {2009, 1, 34}, {2012, 7, 35}, {2015, 7, 36}, {2017, 1, 37}
+};
+
+//追加一个表项, days为生效日相对1970-01-01的天数
+static int time_leap_table_add(time_leap_table_t *ptbl, long long days, int tai_utc)
+{
+    time_leap_entry_t *pe;
+
+    if (ptbl->count >= TIME_LEAP_MAX) {
+        return -1;
+    }
+
+    pe = &ptbl->entry[ptbl->count];
+    pe->utc_start = (days - TIME_GPS_EPOCH_DAYS) * ONE_DAY_SECONDS;
+    pe->gps_start = pe->utc_start + tai_utc - TIME_TAI_MINUS_GPS;
+    pe->tai_utc = tai_utc;
+    if (ptbl->count > 0 && pe->utc_start <= pe[-1].utc_start) {
+        return -1;
+    }
+    ptbl->count++;
+
+    return 0;
+}
+
+static void time_leap_table_init(time_leap_table_t *ptbl)
+{
+    size_t i;
+
+    memset(ptbl, 0, sizeof(*ptbl));
+    for (i = 0; i < sizeof(g_leap_builtin) / sizeof(g_leap_builtin[0]); i++) {
+        time_leap_table_add(ptbl, time_days_from_civil(g_leap_builtin[i].year, g_leap_builtin[i].month, 1),
+            g_leap_builtin[i].tai_utc);
+    }
+}
+
+/*
+ * 从本地跳秒文件加载, 格式同IERS/IETF发布的leap-seconds.list:
+ * '#'开头为注释, 数据行为"NTP秒数(自1900-01-01起) TAI-UTC", 其后内容忽略.
+ * 成功返回0, 文件不存在或格式错误返回-1, 此时表内容不变.
+ */
+static int time_leap_table_load(time_leap_table_t *ptbl, const char *path)
+{
+    time_leap_table_t tbl;
+    char line[256];
+    long long ntp;
+    int tai_utc;
+    FILE *fp;
+    int rv = 0;
+
+    fp = fopen(path, "r");
+    if (fp == NULL) {
+        return -1;
+    }
+
+    memset(&tbl, 0, sizeof(tbl));
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+            continue;
+        }
+        if (sscanf(line, "%lld %d", &ntp, &tai_utc) != 2
+            || time_leap_table_add(&tbl, ntp / ONE_DAY_SECONDS - TIME_NTP_EPOCH_DAYS, tai_utc) != 0) {
+            rv = -1;
+            break;
+        }
+    }
+    fclose(fp);
+
+    if (rv != 0 || tbl.count == 0) {
+        return -1;
+    }
+    memcpy(ptbl, &tbl, sizeof(tbl));
+
+    return 0;
+}
+
+//查找t所在区间: 生效时刻不大于t的最后一项, 早于首项时返回0; gps非0时t为GPST时标, 否则为UTC时标
+static int time_leap_find(time_leap_table_t *ptbl, long long t, int gps)
+{
+    const time_leap_entry_t *pe = ptbl->entry;
+    int i = ptbl->last;
+    int lo, hi, mid;
+
+#define TIME_LEAP_START(k)  (gps ? pe[k].gps_start : pe[k].utc_start)
+#define TIME_LEAP_IN(k)     (TIME_LEAP_START(k) <= t && ((k) + 1 >= ptbl->count || t < TIME_LEAP_START((k) + 1)))
+
+    if (i < ptbl->count && TIME_LEAP_IN(i)) {
+        return i;
+    }
+    if (i + 1 < ptbl->count && TIME_LEAP_IN(i + 1)) {
+        ptbl->last = i + 1;
+        return i + 1;
+    }
+
+    lo = 0;
+    hi = ptbl->count - 1;
+    while (lo < hi) {
+        mid = (lo + hi + 1) / 2;
+        if (TIME_LEAP_START(mid) <= t) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+#undef TIME_LEAP_IN
+#undef TIME_LEAP_START
+
+    ptbl->last = lo;
+
+    return lo;
+}
+
+//GPS时到UTC(通用时)的转换, 跳秒当秒表示为23:59:60
+static void time_conver_gpstime_to_utc(time_leap_table_t *ptbl, const gps_time_t *pgt, common_time_t *putc)
+{
+    const time_leap_entry_t *pe;
+    gps_time_t gt;
+    long long t;
+    int i, leap = 0;
+
+    t = (long long)pgt->wn * ONE_WEEK_SECONDS + pgt->tow.sn;
+    i = time_leap_find(ptbl, t, 1);
+    pe = &ptbl->entry[i];
+
+    //位于下一次正跳秒插入的那一秒内
+    if (i + 1 < ptbl->count && pe[1].tai_utc > pe[0].tai_utc
+        && t >= pe[1].gps_start - (pe[1].tai_utc - pe[0].tai_utc)) {
+        leap = (int)(t - (pe[1].gps_start - (pe[1].tai_utc - pe[0].tai_utc))) + 1;
+    }
+
+    t -= pe->tai_utc - TIME_TAI_MINUS_GPS + leap;
+    gt.wn = (int)time_floor_div(t, ONE_WEEK_SECONDS);
+    gt.tow.sn = (long)(t - (long long)gt.wn * ONE_WEEK_SECONDS);
+    gt.tow.tos = pgt->tow.tos;
+    time_conver_gpstime_to_commontime(&gt, putc);
+    putc->second += leap;
+}
+
+//UTC(通用时)到GPS时的转换, 可接受23:59:60形式的跳秒
+static void time_conver_utc_to_gpstime(time_leap_table_t *ptbl, const common_time_t *putc, gps_time_t *pgt)
+{
+    long long t;
+    int i;
+
+    time_conver_commontime_to_gpstime(putc, pgt);
+    t = (long long)pgt->wn * ONE_WEEK_SECONDS + pgt->tow.sn;
+
+    //跳秒当秒与次日0时的日历值相同, 按跳秒前的区间取偏差
+    i = time_leap_find(ptbl, putc->second >= ONE_MINUTE_SECONDS ? t - 1 : t, 0);
+    t += ptbl->entry[i].tai_utc - TIME_TAI_MINUS_GPS;
+
+    pgt->wn = (int)time_floor_div(t, ONE_WEEK_SECONDS);
+    pgt->tow.sn = (long)(t - (long long)pgt->wn * ONE_WEEK_SECONDS);
+}
+
+//GPS时到TAI(通用时形式)的转换, 两者相差固定的19秒
+static void time_conver_gpstime_to_tai(const gps_time_t *pgt, common_time_t *ptai)
+{
+    gps_time_t gt;
+    long long t;
+
+    t = (long long)pgt->wn * ONE_WEEK_SECONDS + pgt->tow.sn + TIME_TAI_MINUS_GPS;
+    gt.wn = (int)time_floor_div(t, ONE_WEEK_SECONDS);
+    gt.tow.sn = (long)(t - (long long)gt.wn * ONE_WEEK_SECONDS);
+    gt.tow.tos = pgt->tow.tos;
+    time_conver_gpstime_to_commontime(&gt, ptai);
+}
+
+//TAI(通用时形式)到GPS时的转换
+static void time_conver_tai_to_gpstime(const common_time_t *ptai, gps_time_t *pgt)
+{
+    long long t;
+
+    time_conver_commontime_to_gpstime(ptai, pgt);
+    t = (long long)pgt->wn * ONE_WEEK_SECONDS + pgt->tow.sn - TIME_TAI_MINUS_GPS;
+    pgt->wn = (int)time_floor_div(t, ONE_WEEK_SECONDS);
+    pgt->tow.sn = (long)(t - (long long)pgt->wn * ONE_WEEK_SECONDS);
+}
+
+//批量GPS时到UTC的转换, 顺序数据流每个元素都命中缓存区间
+static void time_conver_gpstime_to_utc_batch(time_leap_table_t *ptbl, const gps_time_t *restrict pgt,
+    common_time_t *restrict putc, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        time_conver_gpstime_to_utc(ptbl, &pgt[i], &putc[i]);
+    }
+}
+
+//批量UTC到GPS时的转换
+static void time_conver_utc_to_gpstime_batch(time_leap_table_t *ptbl, const common_time_t *restrict putc,
+    gps_time_t *restrict pgt, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        time_conver_utc_to_gpstime(ptbl, &putc[i], &pgt[i]);
+    }
+}
+
+/*
+ * 多GNSS系统时: 北斗时(BDT)、伽利略系统时(GST)、准天顶系统时(QZSST)与GPS时一样以周数和周内秒计时,
+ * 都是不含跳秒的连续时标, 只是第0周的起点不同(以GPS起点起的GPST秒数计):
+ *     GPST : 1980-01-06 0时
+ *     GST  : 1999-08-22 0时(GPST), 即GPS第1024周起点, 与GPST同步
+ *     BDT  : 2006-01-01 0时(UTC), BDT比GPST落后14秒, 起点为GPS第1356周起点之后14秒
+ *     QZSST: 与GPST相同
+ * TIME_GNSS_DEFINE为每个系统生成与gps_time_t同布局的独立类型, 不同系统的时间在编译期就不能混用;
+ * TIME_GNSS_CONVER_DEFINE生成两个系统之间的转换及批量版本, 起点差为编译期常量:
+ * 整周的起点差(GST、QZSST与GPST之间)只调整周数, 否则只多一次周内秒进位比较.
+ * 输入的周内秒须在[0, 604800)内.
+ * 格洛纳斯时(GLONASST)为UTC(SU)+3小时, 含跳秒且没有周计数, 以莫斯科时间的通用时表示, 经跳秒表换算.
+ */
+#define TIME_GPST_ORIGIN        (0LL)
+#define TIME_GST_ORIGIN         (1024LL * ONE_WEEK_SECONDS)
+#define TIME_BDT_ORIGIN         (1356LL * ONE_WEEK_SECONDS + 14)
+#define TIME_QZSST_ORIGIN       (0LL)
+#define TIME_GLONASST_UTC_HOURS (3)         //GLONASST - UTC
+
+#define TIME_GNSS_DEFINE(sys) \
+typedef struct sys##_time_s { \
+    int wn;         /* 本系统的周数 */ \
+    tow_t tow;      /* 一周内的秒数 */ \
+} sys##_time_t;
+
+TIME_GNSS_DEFINE(bdt)
+TIME_GNSS_DEFINE(gst)
+TIME_GNSS_DEFINE(qzsst)
+
+//周数和周内秒平移shift秒, shift为常量时整周部分和进位方向都在编译期确定
+static inline void time_gnss_shift(int wn, const tow_t *ptow, long long shift, int *pwn, tow_t *pout)
+{
+    long dw = (long)(shift / ONE_WEEK_SECONDS);
+    long ds = (long)(shift % ONE_WEEK_SECONDS);
+    long sn = ptow->sn + ds;
+
+    wn += (int)dw;
+    if (ds > 0 && sn >= ONE_WEEK_SECONDS) {
+        sn -= ONE_WEEK_SECONDS;
+        wn++;
+    } else if (ds < 0 && sn < 0) {
+        sn += ONE_WEEK_SECONDS;
+        wn--;
+    }
+
+    *pwn = wn;
+    pout->sn = sn;
+    pout->tos = ptow->tos;
+}
+
+#define TIME_GNSS_CONVER_DEFINE(from, from_t, from_origin, to, to_t, to_origin) \
+static void time_conver_##from##_to_##to(const from_t *pin, to_t *pout) \
+{ \
+    time_gnss_shift(pin->wn, &pin->tow, (from_origin) - (to_origin), &pout->wn, &pout->tow); \
+} \
+TIME_CONVER_BATCH_DEFINE(from, from_t, to, to_t)
+
+TIME_GNSS_CONVER_DEFINE(gpstime, gps_time_t, TIME_GPST_ORIGIN, bdt, bdt_time_t, TIME_BDT_ORIGIN)
+TIME_GNSS_CONVER_DEFINE(bdt, bdt_time_t, TIME_BDT_ORIGIN, gpstime, gps_time_t, TIME_GPST_ORIGIN)
+TIME_GNSS_CONVER_DEFINE(gpstime, gps_time_t, TIME_GPST_ORIGIN, gst, gst_time_t, TIME_GST_ORIGIN)
+TIME_GNSS_CONVER_DEFINE(gst, gst_time_t, TIME_GST_ORIGIN, gpstime, gps_time_t, TIME_GPST_ORIGIN)
+TIME_GNSS_CONVER_DEFINE(gpstime, gps_time_t, TIME_GPST_ORIGIN, qzsst, qzsst_time_t, TIME_QZSST_ORIGIN)
+TIME_GNSS_CONVER_DEFINE(qzsst, qzsst_time_t, TIME_QZSST_ORIGIN, gpstime, gps_time_t, TIME_GPST_ORIGIN)
+TIME_GNSS_CONVER_DEFINE(bdt, bdt_time_t, TIME_BDT_ORIGIN, gst, gst_time_t, TIME_GST_ORIGIN)
+TIME_GNSS_CONVER_DEFINE(gst, gst_time_t, TIME_GST_ORIGIN, bdt, bdt_time_t, TIME_BDT_ORIGIN)
+TIME_GNSS_CONVER_DEFINE(bdt, bdt_time_t, TIME_BDT_ORIGIN, qzsst, qzsst_time_t, TIME_QZSST_ORIGIN)
+TIME_GNSS_CONVER_DEFINE(qzsst, qzsst_time_t, TIME_QZSST_ORIGIN, bdt, bdt_time_t, TIME_BDT_ORIGIN)
+TIME_GNSS_CONVER_DEFINE(gst, gst_time_t, TIME_GST_ORIGIN, qzsst, qzsst_time_t, TIME_QZSST_ORIGIN)
+TIME_GNSS_CONVER_DEFINE(qzsst, qzsst_time_t, TIME_QZSST_ORIGIN, gst, gst_time_t, TIME_GST_ORIGIN)
+
+/*
+ * 本系统时与其日历时间之间的批量换算: 日历时间以GPS起点起的周数和周内秒(gps_time_t)表示,
+ * 与本系统的周数只差第0周起点所在的GPS周数, 周内秒相同(BDT起点为该时标的2006-01-01 0时).
+ */
+#define TIME_GNSS_CALENDAR_DEFINE(sys, sys_t, origin) \
+static void time_gnss_##sys##_from_calendar(const gps_time_t *restrict pgt, sys_t *restrict pout, size_t n) \
+{ \
+    size_t i; \
+    \
+    for (i = 0; i < n; i++) { \
+        pout[i].wn = pgt[i].wn - (int)((origin) / ONE_WEEK_SECONDS); \
+        pout[i].tow = pgt[i].tow; \
+    } \
+} \
+static void time_gnss_##sys##_to_calendar(const sys_t *restrict pin, gps_time_t *restrict pgt, size_t n) \
+{ \
+    size_t i; \
+    \
+    for (i = 0; i < n; i++) { \
+        pgt[i].wn = pin[i].wn + (int)((origin) / ONE_WEEK_SECONDS); \
+        pgt[i].tow = pin[i].tow; \
+    } \
+}
+
+TIME_GNSS_CALENDAR_DEFINE(bdt, bdt_time_t, TIME_BDT_ORIGIN)
+TIME_GNSS_CALENDAR_DEFINE(gst, gst_time_t, TIME_GST_ORIGIN)
+TIME_GNSS_CALENDAR_DEFINE(qzsst, qzsst_time_t, TIME_QZSST_ORIGIN)
+
+//通用时平移整小时, 跳秒(秒为60)保持不变
+static void time_gnss_shift_hours(const common_time_t *pin, int hours, common_time_t *pout)
+{
+    long long days;
+    int hour = pin->hour + hours;
+    int carry = (int)time_floor_div(hour, ONE_DAY_HOURS);
+
+    *pout = *pin;
+    pout->hour = hour - carry * ONE_DAY_HOURS;
+    if (carry != 0) {
+        days = time_days_from_civil(time_civil_year(pin->year), pin->month, pin->day) + carry;
+        time_civil_from_days(days, &pout->year, &pout->month, &pout->day);
+    }
+}
+
+//GPS时到GLONASST(莫斯科时间的通用时)的转换, 跳秒表示为02:59:60
+static void time_conver_gpstime_to_glonasst(time_leap_table_t *ptbl, const gps_time_t *pgt, common_time_t *pglo)
+{
+    common_time_t utc;
+
+    time_conver_gpstime_to_utc(ptbl, pgt, &utc);
+    time_gnss_shift_hours(&utc, TIME_GLONASST_UTC_HOURS, pglo);
+}
+
+//GLONASST到GPS时的转换, 可接受02:59:60形式的跳秒
+static void time_conver_glonasst_to_gpstime(time_leap_table_t *ptbl, const common_time_t *pglo, gps_time_t *pgt)
+{
+    common_time_t utc;
+
+    time_gnss_shift_hours(pglo, -TIME_GLONASST_UTC_HOURS, &utc);
+    time_conver_utc_to_gpstime(ptbl, &utc, pgt);
+}
+
+//北斗时到GLONASST的转换
+static void time_conver_bdt_to_glonasst(time_leap_table_t *ptbl, const bdt_time_t *pbdt, common_time_t *pglo)
+{
+    gps_time_t gt;
+
+    time_conver_bdt_to_gpstime(pbdt, &gt);
+    time_conver_gpstime_to_glonasst(ptbl, &gt, pglo);
+}
+
+//GLONASST到北斗时的转换
+static void time_conver_glonasst_to_bdt(time_leap_table_t *ptbl, const common_time_t *pglo, bdt_time_t *pbdt)
+{
+    gps_time_t gt;
+
+    time_conver_glonasst_to_gpstime(ptbl, pglo, &gt);
+    time_conver_gpstime_to_bdt(&gt, pbdt);
+}
+
+//伽利略系统时到GLONASST的转换
+static void time_conver_gst_to_glonasst(time_leap_table_t *ptbl, const gst_time_t *pgst, common_time_t *pglo)
+{
+    gps_time_t gt;
+
+    time_conver_gst_to_gpstime(pgst, &gt);
+    time_conver_gpstime_to_glonasst(ptbl, &gt, pglo);
+}
+
+//GLONASST到伽利略系统时的转换
+static void time_conver_glonasst_to_gst(time_leap_table_t *ptbl, const common_time_t *pglo, gst_time_t *pgst)
+{
+    gps_time_t gt;
+
+    time_conver_glonasst_to_gpstime(ptbl, pglo, &gt);
+    time_conver_gpstime_to_gst(&gt, pgst);
+}
+
+//准天顶系统时到GLONASST的转换
+static void time_conver_qzsst_to_glonasst(time_leap_table_t *ptbl, const qzsst_time_t *pqzs, common_time_t *pglo)
+{
+    gps_time_t gt;
+
+    time_conver_qzsst_to_gpstime(pqzs, &gt);
+    time_conver_gpstime_to_glonasst(ptbl, &gt, pglo);
+}
+
+//GLONASST到准天顶系统时的转换
+static void time_conver_glonasst_to_qzsst(time_leap_table_t *ptbl, const common_time_t *pglo, qzsst_time_t *pqzs)
+{
+    gps_time_t gt;
+
+    time_conver_glonasst_to_gpstime(ptbl, pglo, &gt);
+    time_conver_gpstime_to_qzsst(&gt, pqzs);
+}
+
+/*
+ * 含跳秒表参数的批量转换, 与time_conver_gpstime_to_utc_batch相同, 跳秒表的缓存区间在批内连续命中.
+ */
+#define TIME_GLONASST_BATCH_DEFINE(from, from_t, to, to_t) \
+static void time_conver_##from##_to_##to##_batch(time_leap_table_t *ptbl, const from_t *restrict pin, \
+    to_t *restrict pout, size_t n) \
+{ \
+    size_t i; \
+    \
+    for (i = 0; i < n; i++) { \
+        time_conver_##from##_to_##to(ptbl, &pin[i], &pout[i]); \
+    } \
+}
+
+TIME_GLONASST_BATCH_DEFINE(gpstime, gps_time_t, glonasst, common_time_t)
+TIME_GLONASST_BATCH_DEFINE(glonasst, common_time_t, gpstime, gps_time_t)
+TIME_GLONASST_BATCH_DEFINE(bdt, bdt_time_t, glonasst, common_time_t)
+TIME_GLONASST_BATCH_DEFINE(glonasst, common_time_t, bdt, bdt_time_t)
+TIME_GLONASST_BATCH_DEFINE(gst, gst_time_t, glonasst, common_time_t)
+TIME_GLONASST_BATCH_DEFINE(glonasst, common_time_t, gst, gst_time_t)
+TIME_GLONASST_BATCH_DEFINE(qzsst, qzsst_time_t, glonasst, common_time_t)
+TIME_GLONASST_BATCH_DEFINE(glonasst, common_time_t, qzsst, qzsst_time_t)
+
+/*
+ * GPS周数翻转: 导航电文和较老的接收机只给出周数的低10位(模1024)或低13位(模8192).
+ * 完整周数取与参考周数相差不超过半个周期的那一个, 即落在[参考周 - 周期/2, 参考周 + 周期/2)内:
+ *     固定参考: 参考周数取给定历元(如数据的采集日期、接收机固件日期)所在周
+ *     滑动窗口: 每次解算后参考周数更新为解算结果, 按时间顺序的数据流可以连续跨越多次翻转
+ * 输入周数不要求已经小于周期, 完整周数同样会被归到参考周附近.
+ * 同一个截断周数连续出现时直接沿用上次结果; 每个数据流(线程)使用各自的time_rollover_t.
+ */
+#define TIME_ROLLOVER_BITS_LEGACY   (10)    //GPS导航电文(LNAV)的周数位数
+#define TIME_ROLLOVER_BITS_CNAV     (13)    //现代化电文(CNAV)的周数位数
+
+typedef struct time_rollover_s {
+    int modulus;            //周数周期, 0表示不解算
+    int ref;                //参考完整周数
+    bool sliding;           //滑动窗口
+    bool cached;
+    int last_wn;            //上次输入的截断周数及其解算结果
+    int last_full;
+} time_rollover_t;
+
+//bits为截断周数的位数, ref_week为参考完整周数
+static int time_rollover_init(time_rollover_t *pr, int bits, int ref_week, bool sliding)
+{
+    if (bits != TIME_ROLLOVER_BITS_LEGACY && bits != TIME_ROLLOVER_BITS_CNAV) {
+        return -1;
+    }
+
+    memset(pr, 0, sizeof(*pr));
+    pr->modulus = 1 << bits;
+    pr->ref = ref_week;
+    pr->sliding = sliding;
+
+    return 0;
+}
+
+//截断周数到完整周数
+static inline int time_rollover_week(time_rollover_t *pr, int wn)
+{
+    int full;
+
+    if (pr->cached && wn == pr->last_wn) {
+        return pr->last_full;
+    }
+
+    full = wn + pr->modulus * (int)time_floor_div((long long)pr->ref - wn + pr->modulus / 2 - 1, pr->modulus);
+    if (pr->sliding) {
+        pr->ref = full;
+    }
+    pr->cached = true;
+    pr->last_wn = wn;
+    pr->last_full = full;
+
+    return full;
+}
+
+//就地把n个GPS时的周数解算为完整周数
+static void time_rollover_resolve_batch(time_rollover_t *pr, gps_time_t *pgt, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        pgt[i].wn = time_rollover_week(pr, pgt[i].wn);
+    }
+}
+
+/*
+ * 时间文本解析: 按长度解析(不要求以'\0'结尾), 不依赖locale和格式串, 成功返回0, 失败返回-1.
+ * 定长数字字段用SWAR一次处理8字节: 先校验8个字节均为'0'-'9', 再两两合并为4个两位数.
+ * 小数秒按"整数分子/10的幂"解码: 分子与10的幂都能由double精确表示时, 一次除法即得到
+ * 最接近的double, 结果与strtod一致, 不会像逐位累加那样积累舍入误差;
+ * 分子超过2^53时由128位整数长除法得到54位商, 按末位和余数舍入, 同样精确.
+ * 小数部分保留小数点后的前导0和其后至多18位有效数字, 共不超过TIME_PARSE_FRAC_MAX位, 其余数字舍去.
+ */
+#define TIME_PARSE_FRAC_DIGITS  (18)
+#define TIME_PARSE_FRAC_MAX     (31)        //小数的最大位数, 5^31 < 2^72, 精确解码的被除数不超过128位
+
+#if defined(__SIZEOF_INT128__)
+#define TIME_INT128         (1)
+#else
+#define TIME_INT128         (0)
+#endif
+
+static const double g_pow10[TIME_PARSE_FRAC_DIGITS + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+};
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define TIME_PARSE_SWAR     (1)
+#else
+#define TIME_PARSE_SWAR     (0)
+#endif
+
+//8个ASCII字符转换为4个两位数, 任一字符不是数字时返回-1; mask_len为需校验的前若干字节
+static int time_parse_pairs8(const char *s, int mask_len, int pair[4])
+{
+#if TIME_PARSE_SWAR
+    uint64_t v, keep;
+
+    memcpy(&v, s, sizeof(v));
+    keep = (mask_len >= 8) ? ~0ULL : ((1ULL << (mask_len * 8)) - 1);
+    v = (v & keep) | (0x3030303030303030ULL & ~keep);
+
+    if (((v & 0xF0F0F0F0F0F0F0F0ULL) | (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))
+        != 0x3333333333333333ULL) {
+        return -1;
+    }
+
+    v -= 0x3030303030303030ULL;
+    v = v * 10 + (v >> 8);          //字节0/2/4/6为相邻两位组成的两位数
+
+    pair[0] = (int)(v & 0xFF);
+    pair[1] = (int)((v >> 16) & 0xFF);
+    pair[2] = (int)((v >> 32) & 0xFF);
+    pair[3] = (int)((v >> 48) & 0xFF);
+#else
+    int i;
+
+    for (i = 0; i < mask_len; i++) {
+        if (s[i] < '0' || s[i] > '9') {
+            return -1;
+        }
+    }
+    for (i = 0; i < mask_len / 2; i++) {
+        pair[i] = (s[2 * i] - '0') * 10 + (s[2 * i + 1] - '0');
+    }
+#endif
+
+    return 0;
+}
+
+//两位数字字段
+static int time_parse_2digits(const char *s, int *pv)
+{
+    if (s[0] < '0' || s[0] > '9' || s[1] < '0' || s[1] > '9') {
+        return -1;
+    }
+    *pv = (s[0] - '0') * 10 + (s[1] - '0');
+
+    return 0;
+}
+
+static const char *time_parse_skip_space(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        p++;
+    }
+
+    return p;
+}
+
+//十进制数: [+-]整数部分[.小数部分], 整数部分写入*pint, 小数部分为*pnum/10^*pnfrac(与整数部分同号)
+static const char *time_parse_decimal(const char *p, const char *end, long long *pint, long long *pnum, int *pnfrac)
+{
+    const char *start;
+    long long v = 0;
+    long long frac = 0;
+    int nfrac = 0;
+    bool neg = false;
+
+    if (p < end && (*p == '-' || *p == '+')) {
+        neg = (*p == '-');
+        p++;
+    }
+
+    start = p;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (p - start >= TIME_PARSE_FRAC_DIGITS) {
+            return NULL;            //整数部分超过18位会溢出
+        }
+        v = v * 10 + (*p++ - '0');
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (nfrac < TIME_PARSE_FRAC_MAX && frac < (long long)g_pow10[TIME_PARSE_FRAC_DIGITS - 1]) {
+                frac = frac * 10 + (*p - '0');
+                nfrac++;
+            }
+            p++;
+        }
+    }
+    if (p == start || (p == start + 1 && *start == '.')) {
+        return NULL;
+    }
+
+    *pint = neg ? -v : v;
+    *pnum = neg ? -frac : frac;
+    *pnfrac = nfrac;
+
+    return p;
+}
+
+#if TIME_INT128
+/*
+ * 十进制数ipart.frac(frac共k位, k <= TIME_PARSE_FRAC_MAX, ipart为秒数, 不超过60)舍入到最近的double(偶数优先):
+ * ipart.frac = n / 5^k * 2^-k, n = ipart * 10^k + frac左移s位使商n / 5^k落在[2^53, 2^54),
+ * 多出的一位和余数决定舍入
+ */
+static double time_parse_exact(unsigned long long ipart, unsigned long long frac, int k)
+{
+    unsigned __int128 d = 1;
+    unsigned __int128 n, q, r;
+    unsigned long long m;
+    double v;
+    int s = 0;
+    int e, i;
+
+    for (i = 0; i < k; i++) {
+        d *= 5;
+    }
+    n = ((ipart * d) << k) + frac;
+    if (n == 0) {
+        return 0.0;
+    }
+    while ((n << s) < (d << 45)) {
+        s += 8;
+    }
+    while ((n << s) < (d << 53)) {
+        s++;
+    }
+
+    q = (n << s) / d;
+    r = (n << s) - q * d;
+    m = (unsigned long long)(q >> 1);
+    if ((q & 1) != 0 && (r != 0 || (m & 1) != 0)) {
+        m++;
+    }
+
+    //乘2^-(s + k - 1), 每次除以2的幂都是精确的
+    v = (double)m;
+    for (e = s + k - 1; e >= 64; e -= 64) {
+        v /= 18446744073709551616.0;
+    }
+
+    return v / (double)(1ULL << e);
+}
+#else
+//没有128位整数时交给strtod正确舍入
+static double time_parse_exact(unsigned long long ipart, unsigned long long frac, int k)
+{
+    char tmp[64];
+
+    snprintf(tmp, sizeof(tmp), "%llu.%0*llu", ipart, k, frac);
+
+    return strtod(tmp, NULL);
+}
+#endif
+
+//小数部分只做一次除法, 结果为最接近的double; 超过15位时分子可能超过2^53, 按整数精确舍入
+static double time_parse_frac(long long num, int nfrac)
+{
+    double v;
+
+    if (nfrac <= 15) {
+        return (double)num / g_pow10[nfrac];
+    }
+    v = time_parse_exact(0, (unsigned long long)((num < 0) ? -num : num), nfrac);
+
+    return (num < 0) ? -v : v;
+}
+
+//行尾只允许空白
+static int time_parse_end(const char *p, const char *end)
+{
+    return (time_parse_skip_space(p, end) == end) ? 0 : -1;
+}
+
+/*
+ * 通用时: yyyymmddhhmmss[.xx] 或 ISO-8601的YYYY-MM-DDThh:mm:ss[.sss][Z](T也可为空格)
+ * 秒的整数部分固定两位; 月、日须为有效日期, 时0-23, 分0-59, 秒0-60(含跳秒)
+ */
+static int time_parse_commontime(const char *s, size_t len, common_time_t *pct)
+{
+    const char *end = s + len;
+    const char *p;
+    long long isec, num;
+    int nfrac;
+    int pair[4];
+
+    s = time_parse_skip_space(s, end);
+    len = (size_t)(end - s);
+
+    if (len >= 19 && s[4] == '-') {
+        if (s[7] != '-' || (s[10] != 'T' && s[10] != ' ') || s[13] != ':' || s[16] != ':'
+            || time_parse_pairs8(s, 4, pair) != 0
+            || time_parse_2digits(s + 5, &pct->month) != 0 || time_parse_2digits(s + 8, &pct->day) != 0
+            || time_parse_2digits(s + 11, &pct->hour) != 0 || time_parse_2digits(s + 14, &pct->minute) != 0) {
+            return -1;
+        }
+        pct->year = pair[0] * 100 + pair[1];
+        p = s + 17;
+    } else if (len >= 14) {
+        if (time_parse_pairs8(s, 8, pair) != 0) {
+            return -1;
+        }
+        pct->year = pair[0] * 100 + pair[1];
+        pct->month = pair[2];
+        pct->day = pair[3];
+        if (len >= 16) {
+            if (time_parse_pairs8(s + 8, 6, pair) != 0) {
+                return -1;
+            }
+            pct->hour = pair[0];
+            pct->minute = pair[1];
+        } else if (time_parse_2digits(s + 8, &pct->hour) != 0 || time_parse_2digits(s + 10, &pct->minute) != 0) {
+            return -1;
+        }
+        p = s + 12;
+    } else {
+        return -1;
+    }
+
+    if (p + 2 > end || p[0] < '0' || p[0] > '9' || p[1] < '0' || p[1] > '9'
+        || (p + 2 < end && p[2] >= '0' && p[2] <= '9')) {
+        return -1;
+    }
+    p = time_parse_decimal(p, end, &isec, &num, &nfrac);
+    if (p == NULL || !time_civil_valid(pct->year, pct->month, pct->day) || pct->hour >= ONE_DAY_HOURS
+        || pct->minute >= ONE_HOUR_MINUTES || isec > ONE_MINUTE_SECONDS) {
+        return -1;
+    }
+    if (p < end && *p == 'Z') {
+        p++;
+    }
+    //秒数整体作为一个十进制数解码(与strtod相同), 尾数可能超过2^53时按整数精确舍入
+    if (nfrac <= 13) {
+        pct->second = (double)(isec * (long long)g_pow10[nfrac] + num) / g_pow10[nfrac];
+    } else {
+        pct->second = time_parse_exact((unsigned long long)isec, (unsigned long long)num, nfrac);
+    }
+
+    return time_parse_end(p, end);
+}
+
+//GPS时: 周数 周内秒[.小数]
+static int time_parse_gpstime(const char *s, size_t len, gps_time_t *pgt)
+{
+    const char *end = s + len;
+    const char *p;
+    long long wn, sn, num;
+    int nfrac;
+
+    p = time_parse_decimal(time_parse_skip_space(s, end), end, &wn, &num, &nfrac);
+    if (p == NULL || nfrac != 0 || p == end || (*p != ' ' && *p != '\t')) {
+        return -1;
+    }
+    p = time_parse_decimal(time_parse_skip_space(p, end), end, &sn, &num, &nfrac);
+    if (p == NULL) {
+        return -1;
+    }
+
+    pgt->wn = (int)wn;
+    pgt->tow.sn = (long)sn;
+    pgt->tow.tos = time_parse_frac(num, nfrac);
+
+    return time_parse_end(p, end);
+}
+
+//儒略日: 整数天数 天内秒整数部分 秒小数部分(如0.26)
+static int time_parse_julianday(const char *s, size_t len, julianday_t *pjd)
+{
+    const char *end = s + len;
+    const char *p;
+    long long day, sn, zero, num;
+    int nfrac;
+
+    p = time_parse_decimal(time_parse_skip_space(s, end), end, &day, &num, &nfrac);
+    if (p == NULL || nfrac != 0) {
+        return -1;
+    }
+    p = time_parse_decimal(time_parse_skip_space(p, end), end, &sn, &num, &nfrac);
+    if (p == NULL || nfrac != 0) {
+        return -1;
+    }
+    p = time_parse_decimal(time_parse_skip_space(p, end), end, &zero, &num, &nfrac);
+    if (p == NULL || zero != 0) {
+        return -1;
+    }
+
+    pjd->day = (long)day;
+    pjd->tod.sn = (long)sn;
+    pjd->tod.tos = time_parse_frac(num, nfrac);
+
+    return time_parse_end(p, end);
+}
+
+//简化儒略日: 整数天数 天内秒[.小数]
+static int time_parse_mjd(const char *s, size_t len, new_julianday_t *pmjd)
+{
+    const char *end = s + len;
+    const char *p;
+    long long day, sn, num;
+    int nfrac;
+
+    p = time_parse_decimal(time_parse_skip_space(s, end), end, &day, &num, &nfrac);
+    if (p == NULL || nfrac != 0 || p == end || (*p != ' ' && *p != '\t')) {
+        return -1;
+    }
+    p = time_parse_decimal(time_parse_skip_space(p, end), end, &sn, &num, &nfrac);
+    if (p == NULL) {
+        return -1;
+    }
+
+    pmjd->day = (long)day;
+    pmjd->tod.sn = (long)sn;
+    pmjd->tod.tos = time_parse_frac(num, nfrac);
+
+    return time_parse_end(p, end);
+}
+
+//年积日: yyyy:ddd:sssss[.小数], 年积日须在1到当年天数之间, 天内秒在[0, 86400]内(86400为跳秒)
+static int time_parse_doy(const char *s, size_t len, doy_t *pdoy)
+{
+    const char *end = s + len;
+    const char *p;
+    long long year, day, sn, num;
+    int nfrac;
+
+    p = time_parse_decimal(time_parse_skip_space(s, end), end, &year, &num, &nfrac);
+    if (p == NULL || nfrac != 0 || p == end || *p != ':') {
+        return -1;
+    }
+    p = time_parse_decimal(p + 1, end, &day, &num, &nfrac);
+    if (p == NULL || nfrac != 0 || p == end || *p != ':') {
+        return -1;
+    }
+    p = time_parse_decimal(p + 1, end, &sn, &num, &nfrac);
+    if (p == NULL || year < 0 || year > UINT16_MAX || day < 1
+        || day > 365 + time_is_leap_year(time_civil_year((int)year)) || sn < 0 || sn > ONE_DAY_SECONDS
+        || num < 0) {
+        return -1;
+    }
+
+    pdoy->year = (unsigned short)year;
+    pdoy->day = (unsigned short)day;
+    pdoy->tod.sn = (long)sn;
+    pdoy->tod.tos = time_parse_frac(num, nfrac);
+
+    return time_parse_end(p, end);
+}
+
+/*
+ * 时间文本输出: 写入调用者提供的缓冲区并返回写入结束位置, 不经过printf.
+ * 浮点数按最短往返格式输出, 即能被strtod(以及time_parse_*)读回原值的最少小数位;
+ * 需要16位以上有效数字的值输出17位有效数字, 由128位整数精确舍入, 编译器不支持时退回到snprintf.
+ */
+#define TIME_FMT_NUM_MAX        (48)        //单个数值格式化后的最大长度
+#define TIME_FMT_TIME_MAX       (256)       //单个时间格式化后的最大长度
+#define TIME_FMT_FIXED_MAX      (1e17)      //此值以上的浮点数用指数形式
+#define TIME_FMT_EXACT_MAX      (9007199254740992.0)    //2^53, 以下的整数都能由double精确表示
+
+typedef enum time_fmt_template_e {
+    TIME_FMT_CSV,       //各字段以逗号分隔
+    TIME_FMT_ISO,       //ct为YYYY-MM-DDThh:mm:ss.s, doy为ISO-8601序数日期YYYY-DDDThh:mm:ss.s
+    TIME_FMT_RINEX,     //ct为RINEX历元yyyy mm dd hh mm ss.sssssss
+    TIME_FMT_WNTOW,     //与输入格式相同, gps为"周数 周内秒"
+    TIME_FMT_MAX
+} time_fmt_template_t;
+
+static const char g_digits2[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const unsigned long long g_pow10_int[18] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL
+};
+
+//无符号整数输出, width为最小宽度(不足补0); 每次除以100, 两位一起查表
+static char *time_fmt_uint(char *p, unsigned long long v, int width)
+{
+    char tmp[24];
+    char *t = tmp + sizeof(tmp);
+    int n;
+
+    while (v >= 100) {
+        t -= 2;
+        memcpy(t, &g_digits2[(v % 100) * 2], 2);
+        v /= 100;
+    }
+    if (v >= 10) {
+        t -= 2;
+        memcpy(t, &g_digits2[v * 2], 2);
+    } else {
+        *--t = (char)('0' + v);
+    }
+
+    n = (int)(tmp + sizeof(tmp) - t);
+    while (n < width) {
+        *p++ = '0';
+        width--;
+    }
+    memcpy(p, t, (size_t)n);
+
+    return p + n;
+}
+
+static char *time_fmt_int(char *p, long long v, int width)
+{
+    if (v < 0) {
+        *p++ = '-';
+        return time_fmt_uint(p, 0ULL - (unsigned long long)v, width);
+    }
+
+    return time_fmt_uint(p, (unsigned long long)v, width);
+}
+
+static char *time_fmt_str(char *p, const char *s)
+{
+    size_t n = strlen(s);
+
+    memcpy(p, s, n);
+
+    return p + n;
+}
+
+#if TIME_INT128
+/*
+ * round(a * 10^k)的精确值, 0 <= a < 2^53, 0 <= k <= TIME_PARSE_FRAC_MAX, 结果须小于2^64:
+ * a * 10^k = 尾数 * 5^k * 2^(k - shift), 53位尾数乘5^k不超过126位, 用128位整数计算
+ */
+static unsigned long long time_fmt_scale_exact(double a, int k)
+{
+    unsigned __int128 prod = 1;
+    uint64_t bits, mant;
+    int shift, i;
+
+    memcpy(&bits, &a, sizeof(bits));
+    mant = bits & 0xFFFFFFFFFFFFFULL;
+    if ((bits >> 52) & 0x7FF) {
+        mant |= 1ULL << 52;
+        shift = 1075 - (int)((bits >> 52) & 0x7FF);
+    } else {
+        shift = 1074;
+    }
+
+    for (i = 0; i < k; i++) {
+        prod *= 5;
+    }
+    prod *= mant;
+    shift -= k;
+    if (shift <= 0) {
+        return (unsigned long long)(prod << -shift);
+    }
+    if (shift >= 128) {
+        return 0;
+    }
+
+    return (unsigned long long)((prod + ((unsigned __int128)1 << (shift - 1))) >> shift);
+}
+
+//0 <= a < 2^53输出17位有效数字所需的小数位数: 整数部分有d位时为18 - d, 小于1时为17加小数点后前导0的个数
+static int time_fmt_places17(double a)
+{
+    unsigned long long m;
+    int k = 17;
+
+    for (m = (unsigned long long)a; m >= 10; m /= 10) {
+        k--;
+    }
+    while (a < 1.0 && k < TIME_PARSE_FRAC_MAX && time_fmt_scale_exact(a, k) < g_pow10_int[16]) {
+        k++;
+    }
+
+    return k;
+}
+#endif
+
+//写出m * 10^-k, 整数部分补0到width, 去掉小数末尾的0; k超过17时m < 10^k, 整数部分为0
+static char *time_fmt_decimal(char *p, unsigned long long m, int k, int width)
+{
+    unsigned long long f = (k <= 17) ? m % g_pow10_int[k] : m;
+
+    p = time_fmt_uint(p, (k <= 17) ? m / g_pow10_int[k] : 0, width);
+    while (k > 0 && f % 10 == 0) {
+        f /= 10;
+        k--;
+    }
+    if (k > 0) {
+        *p++ = '.';
+        p = time_fmt_uint(p, f, k);
+    }
+
+    return p;
+}
+
+/*
+ * 最短往返浮点数, width为整数部分最小宽度(不足补0)
+ * 逐个尝试k位小数: m = round(|v| * 10^k), m与10^k都是精确的double时m/10^k只舍入一次,
+ * 等于|v|即说明十进制数m*10^-k被strtod读回时得到的就是v.
+ */
+static char *time_fmt_double(char *p, double v, int width)
+{
+    unsigned long long m;
+    double a = (v < 0) ? -v : v;
+    double scaled;
+    int k;
+
+    if (a < TIME_FMT_EXACT_MAX) {
+        for (k = 0; k < 16; k++) {
+            scaled = a * g_pow10[k] + 0.5;
+            if (scaled >= TIME_FMT_EXACT_MAX) {
+                break;
+            }
+            m = (unsigned long long)scaled;
+            if ((double)m / g_pow10[k] == a) {
+                if (v < 0) {
+                    *p++ = '-';
+                }
+                p = time_fmt_uint(p, m / g_pow10_int[k], width);
+                if (k > 0) {
+                    *p++ = '.';
+                    p = time_fmt_uint(p, m % g_pow10_int[k], k);
+                }
+                return p;
+            }
+        }
+    }
+
+    //17位有效数字总能往返; 尽量不用指数形式, 以便time_parse_*读回; 小于1的数按前导0增加小数位
+#if TIME_INT128
+    if (a < TIME_FMT_EXACT_MAX) {
+        k = time_fmt_places17(a);
+        if (v < 0) {
+            *p++ = '-';
+        }
+        return time_fmt_decimal(p, time_fmt_scale_exact(a, k), k, width);
+    }
+#endif
+    if (!(a < TIME_FMT_FIXED_MAX)) {
+        return p + snprintf(p, TIME_FMT_NUM_MAX, "%.17g", v);
+    }
+    k = 17;
+    for (scaled = a; scaled >= 10.0 && k > 1; scaled /= 10.0) {
+        k--;
+    }
+    for (scaled = a; scaled < 0.1 && scaled > 0 && k < TIME_PARSE_FRAC_MAX; scaled *= 10.0) {
+        k++;
+    }
+
+    return p + snprintf(p, TIME_FMT_NUM_MAX, "%0*.*f", width + (v < 0) + 1 + k, k, v);
+}
+
+//定点小数, 共ndec位小数, 整体右对齐到width(前补空格), 用于RINEX的F11.7等字段
+static char *time_fmt_fixed(char *p, double v, int ndec, int width)
+{
+    char tmp[TIME_FMT_NUM_MAX];
+    char *t = tmp;
+    unsigned long long m;
+    double a = (v < 0) ? -v : v;
+    int n;
+
+    if (ndec > 15 || !(a * g_pow10[ndec] + 0.5 < TIME_FMT_EXACT_MAX)) {
+        return p + snprintf(p, TIME_FMT_NUM_MAX, "%*.17g", width, v);
+    }
+
+    m = (unsigned long long)(a * g_pow10[ndec] + 0.5);
+    if (v < 0 && m > 0) {
+        *t++ = '-';
+    }
+    t = time_fmt_uint(t, m / g_pow10_int[ndec], 0);
+    if (ndec > 0) {
+        *t++ = '.';
+        t = time_fmt_uint(t, m % g_pow10_int[ndec], ndec);
+    }
+
+    n = (int)(t - tmp);
+    while (n < width) {
+        *p++ = ' ';
+        width--;
+    }
+    memcpy(p, tmp, (size_t)n);
+
+    return p + n;
+}
+
+/*
+ * 整数秒加秒小数: 小数在[0,1)内时按time_parse_*的解码方式(小数部分单独做一次除法)
+ * 取最短小数位, 使输出读回后sn与tos都不变; 否则按两者之和输出.
+ */
+static char *time_fmt_seconds(char *p, long sn, double tos, int width)
+{
+#if !TIME_INT128
+    char tmp[TIME_FMT_NUM_MAX];
+#endif
+    unsigned long long m;
+    double scaled;
+    int k;
+
+    if (tos < 0 || tos >= 1.0 || (sn < 0 && tos > 0)) {
+        return time_fmt_double(p, (double)sn + tos, width);
+    }
+
+    p = time_fmt_int(p, sn, width);
+    if (tos == 0) {
+        return p;
+    }
+
+    for (k = 1; k < 16; k++) {
+        scaled = tos * g_pow10[k] + 0.5;
+        m = (unsigned long long)scaled;
+        if ((double)m / g_pow10[k] == tos) {
+            *p++ = '.';
+            return time_fmt_uint(p, m, k);
+        }
+    }
+
+    //小数部分需要16位以上时保留17位有效数字, 去掉末尾的0
+#if TIME_INT128
+    k = time_fmt_places17(tos);
+    m = time_fmt_scale_exact(tos, k);
+    if (m == 0) {
+        return p;
+    }
+    for (; m % 10 == 0; k--) {
+        m /= 10;
+    }
+    *p++ = '.';
+
+    return time_fmt_uint(p, m, k);
+#else
+    for (k = 17, scaled = tos; scaled < 0.1 && k < TIME_PARSE_FRAC_MAX; scaled *= 10.0) {
+        k++;
+    }
+    k = snprintf(tmp, sizeof(tmp), "%.*f", k, tos);
+    while (k > 2 && tmp[k - 1] == '0') {
+        k--;
+    }
+    memcpy(p, tmp + 1, (size_t)(k - 1));
+
+    return p + k - 1;
+#endif
+}
+
+//输入格式(time_parse_*可读回): ct为yyyymmddhhmmss.s, gps为"周数 周内秒", jd为"天数 天内秒 秒小数", doy为yyyy:ddd:sssss.s
+static char *time_fmt_native(char *p, time_type_t type, const void *pt)
+{
+    const common_time_t *pct;
+    const julianday_t *pjd;
+    const gps_time_t *pgt;
+    const doy_t *pdoy;
+    const new_julianday_t *pmjd;
+
+    switch (type) {
+        case TIME_COMMON:
+            pct = (const common_time_t *)pt;
+            p = time_fmt_int(p, pct->year, 4);
+            p = time_fmt_int(p, pct->month, 2);
+            p = time_fmt_int(p, pct->day, 2);
+            p = time_fmt_int(p, pct->hour, 2);
+            p = time_fmt_int(p, pct->minute, 2);
+            p = time_fmt_double(p, pct->second, 2);
+            break;
+        case TIME_JULIAN:
+            pjd = (const julianday_t *)pt;
+            p = time_fmt_int(p, pjd->day, 0);
+            *p++ = ' ';
+            p = time_fmt_int(p, pjd->tod.sn, 0);
+            *p++ = ' ';
+            p = time_fmt_double(p, pjd->tod.tos, 0);
+            break;
+        case TIME_GPS:
+            pgt = (const gps_time_t *)pt;
+            p = time_fmt_int(p, pgt->wn, 0);
+            *p++ = ' ';
+            p = time_fmt_seconds(p, pgt->tow.sn, pgt->tow.tos, 0);
+            break;
+        case TIME_doy_t:
+            pdoy = (const doy_t *)pt;
+            p = time_fmt_int(p, pdoy->year, 4);
+            *p++ = ':';
+            p = time_fmt_int(p, pdoy->day, 3);
+            *p++ = ':';
+            p = time_fmt_seconds(p, pdoy->tod.sn, pdoy->tod.tos, 5);
+            break;
+        case TIME_MJD:
+            pmjd = (const new_julianday_t *)pt;
+            p = time_fmt_int(p, pmjd->day, 0);
+            *p++ = ' ';
+            p = time_fmt_seconds(p, pmjd->tod.sn, pmjd->tod.tos, 0);
+            break;
+        default:
+            break;
+    }
+
+    return p;
+}
+
+//各字段以逗号分隔
+static char *time_fmt_csv(char *p, time_type_t type, const void *pt)
+{
+    const common_time_t *pct;
+    const julianday_t *pjd;
+    const gps_time_t *pgt;
+    const doy_t *pdoy;
+    const new_julianday_t *pmjd;
+
+    switch (type) {
+        case TIME_COMMON:
+            pct = (const common_time_t *)pt;
+            p = time_fmt_int(p, pct->year, 0);
+            *p++ = ',';
+            p = time_fmt_int(p, pct->month, 0);
+            *p++ = ',';
+            p = time_fmt_int(p, pct->day, 0);
+            *p++ = ',';
+            p = time_fmt_int(p, pct->hour, 0);
+            *p++ = ',';
+            p = time_fmt_int(p, pct->minute, 0);
+            *p++ = ',';
+            p = time_fmt_double(p, pct->second, 0);
+            break;
+        case TIME_JULIAN:
+            pjd = (const julianday_t *)pt;
+            p = time_fmt_int(p, pjd->day, 0);
+            *p++ = ',';
+            p = time_fmt_seconds(p, pjd->tod.sn, pjd->tod.tos, 0);
+            break;
+        case TIME_GPS:
+            pgt = (const gps_time_t *)pt;
+            p = time_fmt_int(p, pgt->wn, 0);
+            *p++ = ',';
+            p = time_fmt_seconds(p, pgt->tow.sn, pgt->tow.tos, 0);
+            break;
+        case TIME_doy_t:
+            pdoy = (const doy_t *)pt;
+            p = time_fmt_int(p, pdoy->year, 0);
+            *p++ = ',';
+            p = time_fmt_int(p, pdoy->day, 0);
+            *p++ = ',';
+            p = time_fmt_seconds(p, pdoy->tod.sn, pdoy->tod.tos, 0);
+            break;
+        case TIME_MJD:
+            pmjd = (const new_julianday_t *)pt;
+            p = time_fmt_int(p, pmjd->day, 0);
+            *p++ = ',';
+            p = time_fmt_seconds(p, pmjd->tod.sn, pmjd->tod.tos, 0);
+            break;
+        default:
+            break;
+    }
+
+    return p;
+}
+
+//hh:mm:ss.s, tod为天内秒
+static char *time_fmt_iso_tod(char *p, long sn, double tos)
+{
+    p = time_fmt_uint(p, (unsigned long long)(sn / ONE_HOUR_SECONDS), 2);
+    *p++ = ':';
+    p = time_fmt_uint(p, (unsigned long long)(sn % ONE_HOUR_SECONDS / ONE_MINUTE_SECONDS), 2);
+    *p++ = ':';
+
+    return time_fmt_seconds(p, sn % ONE_MINUTE_SECONDS, tos, 2);
+}
+
+/*
+ * 按模板格式化一个时间, 返回写入结束位置, 最多写入TIME_FMT_TIME_MAX字节
+ * 模板没有专门格式的时间类型按输入格式输出.
+ */
+static char *time_fmt_time(char *p, time_fmt_template_t fmt, time_type_t type, const void *pt)
+{
+    const common_time_t *pct = (const common_time_t *)pt;
+    const doy_t *pdoy = (const doy_t *)pt;
+
+    switch (fmt) {
+        case TIME_FMT_CSV:
+            return time_fmt_csv(p, type, pt);
+        case TIME_FMT_ISO:
+            if (type == TIME_COMMON) {
+                p = time_fmt_int(p, pct->year, 4);
+                *p++ = '-';
+                p = time_fmt_int(p, pct->month, 2);
+                *p++ = '-';
+                p = time_fmt_int(p, pct->day, 2);
+                *p++ = 'T';
+                p = time_fmt_int(p, pct->hour, 2);
+                *p++ = ':';
+                p = time_fmt_int(p, pct->minute, 2);
+                *p++ = ':';
+                return time_fmt_double(p, pct->second, 2);
+            }
+            if (type == TIME_doy_t && pdoy->tod.sn >= 0 && pdoy->tod.sn < ONE_DAY_SECONDS) {
+                p = time_fmt_int(p, pdoy->year, 4);
+                *p++ = '-';
+                p = time_fmt_int(p, pdoy->day, 3);
+                *p++ = 'T';
+                return time_fmt_iso_tod(p, pdoy->tod.sn, pdoy->tod.tos);
+            }
+            break;
+        case TIME_FMT_RINEX:
+            if (type == TIME_COMMON) {
+                p = time_fmt_int(p, pct->year, 4);
+                *p++ = ' ';
+                p = time_fmt_int(p, pct->month, 2);
+                *p++ = ' ';
+                p = time_fmt_int(p, pct->day, 2);
+                *p++ = ' ';
+                p = time_fmt_int(p, pct->hour, 2);
+                *p++ = ' ';
+                p = time_fmt_int(p, pct->minute, 2);
+                return time_fmt_fixed(p, pct->second, 7, 11);
+            }
+            break;
+        default:
+            break;
+    }
+
+    return time_fmt_native(p, type, pt);
+}
+
+static void time_print(time_type_t type, void *pt)
+{
+    char buf[512];
+    char *p = buf;
+
+    switch (type) {
+        case TIME_COMMON:
+            p = time_fmt_str(p, "-->common time:\nct.year     : ");
+            p = time_fmt_int(p, ((common_time_t *)pt)->year, 0);
+            p = time_fmt_str(p, "\nct.month    : ");
+            p = time_fmt_int(p, ((common_time_t *)pt)->month, 0);
+            p = time_fmt_str(p, "\nct.day      : ");
+            p = time_fmt_int(p, ((common_time_t *)pt)->day, 0);
+            p = time_fmt_str(p, "\nct.hour     : ");
+            p = time_fmt_int(p, ((common_time_t *)pt)->hour, 0);
+            p = time_fmt_str(p, "\nct.minute   : ");
+            p = time_fmt_int(p, ((common_time_t *)pt)->minute, 0);
+            p = time_fmt_str(p, "\nct.seconds  : ");
+            p = time_fmt_double(p, ((common_time_t *)pt)->second, 0);
+            break;
+        case TIME_JULIAN:
+            p = time_fmt_str(p, "-->julianday time:\njd.day      : ");
+            p = time_fmt_int(p, ((julianday_t *)pt)->day, 0);
+            p = time_fmt_str(p, "\njd.tod.sn   : ");
+            p = time_fmt_int(p, ((julianday_t *)pt)->tod.sn, 0);
+            p = time_fmt_str(p, "\njd.tod.tos  : ");
+            p = time_fmt_double(p, ((julianday_t *)pt)->tod.tos, 0);
+            break;
+        case TIME_GPS:
+            p = time_fmt_str(p, "-->gps time:\ngps.wn      : ");
+            p = time_fmt_int(p, ((gps_time_t *)pt)->wn, 0);
+            p = time_fmt_str(p, "\ngps.tow.sn  : ");
+            p = time_fmt_int(p, ((gps_time_t *)pt)->tow.sn, 0);
+            p = time_fmt_str(p, "\ngps.tow.tos : ");
+            p = time_fmt_double(p, ((gps_time_t *)pt)->tow.tos, 0);
+            break;
+        case TIME_doy_t:
+            p = time_fmt_str(p, "-->doy time:\ndoy.year    : ");
+            p = time_fmt_int(p, ((doy_t *)pt)->year, 0);
+            p = time_fmt_str(p, "\ndoy.day     : ");
+            p = time_fmt_int(p, ((doy_t *)pt)->day, 0);
+            p = time_fmt_str(p, "\ndoy.tod.sn  : ");
+            p = time_fmt_int(p, ((doy_t *)pt)->tod.sn, 0);
+            p = time_fmt_str(p, "\ndoy.tod.tos : ");
+            p = time_fmt_double(p, ((doy_t *)pt)->tod.tos, 0);
+            break;
+        case TIME_MJD:
+            p = time_fmt_str(p, "-->mjd time:\nmjd.day     : ");
+            p = time_fmt_int(p, ((new_julianday_t *)pt)->day, 0);
+            p = time_fmt_str(p, "\nmjd.tod.sn  : ");
+            p = time_fmt_int(p, ((new_julianday_t *)pt)->tod.sn, 0);
+            p = time_fmt_str(p, "\nmjd.tod.tos : ");
+            p = time_fmt_double(p, ((new_julianday_t *)pt)->tod.tos, 0);
+            break;
+        default:
+            return;
+    }
+    p = time_fmt_str(p, "\n\n");
+
+    //与交互提示共用stdout的缓冲, 一次写入
+    fwrite(buf, 1, (size_t)(p - buf), stdout);
+}
+
+static int time_get_type_from_name(char *name)
+{
+    int type = -1;
+
+    if (memcmp(name, "gps", strlen("gps")) == 0) {
+        type = TIME_GPS;
+    } else if (memcmp(name, "ct", strlen("ct")) == 0) {
+        type = TIME_COMMON;
+    } else if (memcmp(name, "doy", strlen("doy")) == 0) {
+        type = TIME_doy_t;
+    } else if (memcmp(name, "jd", strlen("jd")) == 0) {
+        type = TIME_JULIAN;
+    } else if (memcmp(name, "mjd", strlen("mjd")) == 0) {
+        type = TIME_MJD;
+    } else if (memcmp(name, "all", strlen("all")) == 0) {
+        type = TIME_MAX;
+    } else if (memcmp(name, "quit", strlen("quit")) == 0) {
+        type = -1;
+    } else if (memcmp(name, "exit", strlen("exit")) == 0) {
+        exit(0);
+    } else {
+        printf("ERROR: The type %s unknown, please input again.\n", name);
+        type = -2;
+    }
+
+    return type;
+}
+
+/*
+ * 转换规划: 五种表示和公共中间量time_day_t(日数与天内秒)为图的结点, 每个直接转换核心为一条有向边,
+ * 边权为核心的相对耗时. 对源类型和目标集合(单个目标或全部), 在图上找出覆盖全部目标、总耗时最小的转换树,
+ * 共享的中间结果只算一次, 再由它分发到各个目标. 规划只依赖类型, 首次转换时为25种state各算一次, 之后按表执行.
+ * 通用时作为结果时秒已合并为浮点数, 年积日的年份已截断为16位, 两者只在作为源时才引出边, 保证结果与直接转换逐位相同.
+ */
+#define TIME_PLAN_DAY       (TIME_MAX)          //公共中间量结点
+#define TIME_PLAN_NODES     (TIME_MAX + 1)
+
+//日数与天内秒, 1970-01-01为第0天
+typedef struct time_day_s {
+    long long days;
+    long sod;
+    double tos;
+} time_day_t;
+
+typedef void (*time_plan_kernel_t)(const void *pin, void *pout);
+
+//转换树按执行顺序排列的边, 每条边的源结点都已先算出
+typedef struct time_plan_s {
+    int nsteps;
+    unsigned char from[TIME_PLAN_NODES];
+    unsigned char to[TIME_PLAN_NODES];
+} time_plan_t;
+
+static void time_day_normalize(long long t, double tos, time_day_t *pday)
+{
+    pday->days = time_floor_div(t, ONE_DAY_SECONDS);
+    pday->sod = (long)(t - pday->days * ONE_DAY_SECONDS);
+    pday->tos = tos;
+}
+
+static void time_conver_commontime_to_day(const common_time_t *pct, time_day_t *pday)
+{
+    int isec;
+
+    isec = (int)pct->second;
+    time_day_normalize(time_days_from_civil(time_civil_year(pct->year), pct->month, pct->day) * ONE_DAY_SECONDS
+        + pct->hour * ONE_HOUR_SECONDS + pct->minute * ONE_MINUTE_SECONDS + isec, pct->second - isec, pday);
+}
+
+static void time_conver_day_to_commontime(const time_day_t *pday, common_time_t *pct)
+{
+    time_civil_from_days(pday->days, &pct->year, &pct->month, &pct->day);
+    pct->hour = pday->sod / ONE_HOUR_SECONDS;
+    pct->minute = (pday->sod % ONE_HOUR_SECONDS) / ONE_MINUTE_SECONDS;
+    pct->second = pday->sod % ONE_MINUTE_SECONDS + pday->tos;
+}
+
+static void time_conver_julianday_to_day(const julianday_t *pjd, time_day_t *pday)
+{
+    time_day_normalize((long long)(pjd->day - TIME_CIVIL_EPOCH_JD) * ONE_DAY_SECONDS + pjd->tod.sn - ONE_DAY_SECONDS / 2,
+        pjd->tod.tos, pday);
+}
+
+static void time_conver_day_to_julianday(const time_day_t *pday, julianday_t *pjd)
+{
+    long t;
+
+    //儒略日从正午起算, 天内秒加上半天后至多进一天
+    t = pday->sod + ONE_DAY_SECONDS / 2;
+    pjd->day = (long)(TIME_CIVIL_EPOCH_JD + pday->days + (t >= ONE_DAY_SECONDS));
+    pjd->tod.sn = (t >= ONE_DAY_SECONDS) ? t - ONE_DAY_SECONDS : t;
+    pjd->tod.tos = pday->tos;
+}
+
+static void time_conver_gpstime_to_day(const gps_time_t *pgt, time_day_t *pday)
+{
+    time_day_normalize((long long)pgt->wn * ONE_WEEK_SECONDS + pgt->tow.sn + TIME_GPS_EPOCH_DAYS * (long long)ONE_DAY_SECONDS,
+        pgt->tow.tos, pday);
+}
+
+static void time_conver_day_to_gpstime(const time_day_t *pday, gps_time_t *pgt)
+{
+    long long t, wn;
+
+    t = (pday->days - TIME_GPS_EPOCH_DAYS) * ONE_DAY_SECONDS + pday->sod;
+    wn = time_floor_div(t, ONE_WEEK_SECONDS);
+
+    pgt->wn = (int)wn;
+    pgt->tow.sn = (long)(t - wn * ONE_WEEK_SECONDS);
+    pgt->tow.tos = pday->tos;
+}
+
+static void time_conver_doy_to_day(const doy_t *pdoy, time_day_t *pday)
+{
+    long long days;
+
+    if (time_year_in_table(pdoy->year)) {
+        days = g_year_table[pdoy->year - TIME_TABLE_FIRST_YEAR].days;
+    } else {
+        days = time_days_from_civil(pdoy->year, 1, 1);
+    }
+    time_day_normalize((days + pdoy->day - 1) * ONE_DAY_SECONDS + pdoy->tod.sn, pdoy->tod.tos, pday);
+}
+
+static void time_conver_day_to_doy(const time_day_t *pday, doy_t *pdoy)
+{
+    int year, day;
+
+    time_doy_from_days(pday->days, &year, &day);
+    pdoy->year = (unsigned short)year;
+    pdoy->day = (unsigned short)day;
+    pdoy->tod.sn = pday->sod;
+    pdoy->tod.tos = pday->tos;
+}
+
+static void time_conver_mjd_to_day(const new_julianday_t *pmjd, time_day_t *pday)
+{
+    time_day_normalize((long long)(pmjd->day - TIME_CIVIL_EPOCH_MJD) * ONE_DAY_SECONDS + pmjd->tod.sn,
+        pmjd->tod.tos, pday);
+}
+
+static void time_conver_day_to_mjd(const time_day_t *pday, new_julianday_t *pmjd)
+{
+    pmjd->day = (long)(TIME_CIVIL_EPOCH_MJD + pday->days);
+    pmjd->tod.sn = pday->sod;
+    pmjd->tod.tos = pday->tos;
+}
+
+//按图的边统一签名包装各转换核心
+#define TIME_PLAN_KERNEL_DEFINE(from, from_t, to, to_t) \
+static void time_plan_##from##_to_##to(const void *pin, void *pout) \
+{ \
+    time_conver_##from##_to_##to((const from_t *)pin, (to_t *)pout); \
+}
+
+TIME_PLAN_KERNEL_DEFINE(commontime, common_time_t, julianday, julianday_t)
+TIME_PLAN_KERNEL_DEFINE(commontime, common_time_t, gpstime, gps_time_t)
+TIME_PLAN_KERNEL_DEFINE(commontime, common_time_t, doy, doy_t)
+TIME_PLAN_KERNEL_DEFINE(commontime, common_time_t, mjd, new_julianday_t)
+TIME_PLAN_KERNEL_DEFINE(commontime, common_time_t, day, time_day_t)
+TIME_PLAN_KERNEL_DEFINE(julianday, julianday_t, commontime, common_time_t)
+TIME_PLAN_KERNEL_DEFINE(julianday, julianday_t, gpstime, gps_time_t)
+TIME_PLAN_KERNEL_DEFINE(julianday, julianday_t, doy, doy_t)
+TIME_PLAN_KERNEL_DEFINE(julianday, julianday_t, mjd, new_julianday_t)
+TIME_PLAN_KERNEL_DEFINE(julianday, julianday_t, day, time_day_t)
+TIME_PLAN_KERNEL_DEFINE(gpstime, gps_time_t, commontime, common_time_t)
+TIME_PLAN_KERNEL_DEFINE(gpstime, gps_time_t, julianday, julianday_t)
+TIME_PLAN_KERNEL_DEFINE(gpstime, gps_time_t, doy, doy_t)
+TIME_PLAN_KERNEL_DEFINE(gpstime, gps_time_t, mjd, new_julianday_t)
+TIME_PLAN_KERNEL_DEFINE(gpstime, gps_time_t, day, time_day_t)
+TIME_PLAN_KERNEL_DEFINE(doy, doy_t, commontime, common_time_t)
+TIME_PLAN_KERNEL_DEFINE(doy, doy_t, julianday, julianday_t)
+TIME_PLAN_KERNEL_DEFINE(doy, doy_t, gpstime, gps_time_t)
+TIME_PLAN_KERNEL_DEFINE(doy, doy_t, mjd, new_julianday_t)
+TIME_PLAN_KERNEL_DEFINE(doy, doy_t, day, time_day_t)
+TIME_PLAN_KERNEL_DEFINE(mjd, new_julianday_t, commontime, common_time_t)
+TIME_PLAN_KERNEL_DEFINE(mjd, new_julianday_t, julianday, julianday_t)
+TIME_PLAN_KERNEL_DEFINE(mjd, new_julianday_t, gpstime, gps_time_t)
+TIME_PLAN_KERNEL_DEFINE(mjd, new_julianday_t, doy, doy_t)
+TIME_PLAN_KERNEL_DEFINE(mjd, new_julianday_t, day, time_day_t)
+TIME_PLAN_KERNEL_DEFINE(day, time_day_t, commontime, common_time_t)
+TIME_PLAN_KERNEL_DEFINE(day, time_day_t, julianday, julianday_t)
+TIME_PLAN_KERNEL_DEFINE(day, time_day_t, gpstime, gps_time_t)
+TIME_PLAN_KERNEL_DEFINE(day, time_day_t, doy, doy_t)
+TIME_PLAN_KERNEL_DEFINE(day, time_day_t, mjd, new_julianday_t)
+
+//图的边: [源][目标]
+static const time_plan_kernel_t g_time_plan_kernel[TIME_PLAN_NODES][TIME_PLAN_NODES] = {
+    [TIME_COMMON] = {
+        [TIME_JULIAN] = time_plan_commontime_to_julianday, [TIME_GPS] = time_plan_commontime_to_gpstime,
+        [TIME_doy_t] = time_plan_commontime_to_doy, [TIME_MJD] = time_plan_commontime_to_mjd,
+        [TIME_PLAN_DAY] = time_plan_commontime_to_day },
+    [TIME_JULIAN] = {
+        [TIME_COMMON] = time_plan_julianday_to_commontime, [TIME_GPS] = time_plan_julianday_to_gpstime,
+        [TIME_doy_t] = time_plan_julianday_to_doy, [TIME_MJD] = time_plan_julianday_to_mjd,
+        [TIME_PLAN_DAY] = time_plan_julianday_to_day },
+    [TIME_GPS] = {
+        [TIME_COMMON] = time_plan_gpstime_to_commontime, [TIME_JULIAN] = time_plan_gpstime_to_julianday,
+        [TIME_doy_t] = time_plan_gpstime_to_doy, [TIME_MJD] = time_plan_gpstime_to_mjd,
+        [TIME_PLAN_DAY] = time_plan_gpstime_to_day },
+    [TIME_doy_t] = {
+        [TIME_COMMON] = time_plan_doy_to_commontime, [TIME_JULIAN] = time_plan_doy_to_julianday,
+        [TIME_GPS] = time_plan_doy_to_gpstime, [TIME_MJD] = time_plan_doy_to_mjd,
+        [TIME_PLAN_DAY] = time_plan_doy_to_day },
+    [TIME_MJD] = {
+        [TIME_COMMON] = time_plan_mjd_to_commontime, [TIME_JULIAN] = time_plan_mjd_to_julianday,
+        [TIME_GPS] = time_plan_mjd_to_gpstime, [TIME_doy_t] = time_plan_mjd_to_doy,
+        [TIME_PLAN_DAY] = time_plan_mjd_to_day },
+    [TIME_PLAN_DAY] = {
+        [TIME_COMMON] = time_plan_day_to_commontime, [TIME_JULIAN] = time_plan_day_to_julianday,
+        [TIME_GPS] = time_plan_day_to_gpstime, [TIME_doy_t] = time_plan_day_to_doy,
+        [TIME_MJD] = time_plan_day_to_mjd }
+};
+
+//边权: 经统一签名调用各核心的单次耗时, 单位0.1ns(x86-64, gcc -O2, 1980-2037年随机历元实测), 只用于比较路径
+static const unsigned char g_time_plan_cost[TIME_PLAN_NODES][TIME_PLAN_NODES] = {
+    /*            ct   jd  gps  doy  mjd  day */
+    /* ct  */ {    0,  54,  54,  39,  54,  52 },
+    /* jd  */ {  112,   0,  22,  47,  21,  21 },
+    /* gps */ {  110,  22,   0,  48,  21,  22 },
+    /* doy */ {   80,  25,  28,   0,  37,  26 },
+    /* mjd */ {  115,  22,  22,  48,   0,  22 },
+    /* day */ {   84,  25,  22,  37,  19,   0 }
+};
+
+static const size_t g_time_plan_size[TIME_MAX] = {
+    sizeof(common_time_t), sizeof(julianday_t), sizeof(gps_time_t), sizeof(doy_t), sizeof(new_julianday_t)
+};
+
+static time_plan_t g_time_plan[TIME_MJD_TO_ALL + 1];
+static pthread_once_t g_time_plan_once = PTHREAD_ONCE_INIT;
+
+//state的源类型和目标类型(TO_ALL时为TIME_MAX)
+static void time_plan_state(int state, int *pfrom, int *pto)
+{
+    int i = state % TIME_MAX;
+
+    *pfrom = state / TIME_MAX;
+    *pto = (i == TIME_MAX - 1) ? TIME_MAX : i + (i >= *pfrom);
+}
+
+//结点能否作为边的源: 通用时、年积日只有作为转换源时才可以
+static int time_plan_can_expand(int node, int src)
+{
+    return node == src || (node != TIME_COMMON && node != TIME_doy_t);
+}
+
+/*
+ * 在结点集合nodes(位掩码, 不含src)上求以src为根、总边权最小的转换树, 结果写入parent, 返回总边权, 无解时返回-1.
+ * 结点至多5个, 直接枚举每个结点的父结点.
+ */
+static int time_plan_tree(int src, unsigned nodes, int *parent)
+{
+    int list[TIME_PLAN_NODES], par[TIME_PLAN_NODES] = { 0 };
+    int n = 0, i, v, p, depth, cost, best = -1;
+    long k, combos = 1;
+
+    for (v = 0; v < TIME_PLAN_NODES; v++) {
+        if (nodes & (1u << v)) {
+            list[n++] = v;
+            combos *= TIME_PLAN_NODES;
+        }
+    }
+
+    for (k = 0; k < combos; k++) {
+        long c = k;
+
+        cost = 0;
+        for (i = 0; i < n; i++) {
+            p = (int)(c % TIME_PLAN_NODES);
+            c /= TIME_PLAN_NODES;
+            v = list[i];
+            if (p == v || (p != src && !(nodes & (1u << p))) || g_time_plan_kernel[p][v] == NULL
+                || !time_plan_can_expand(p, src)) {
+                break;
+            }
+            par[v] = p;
+            cost += g_time_plan_cost[p][v];
+        }
+        if (i < n || (best >= 0 && cost >= best)) {
+            continue;
+        }
+
+        //每个结点沿父结点都要回到src, 否则有环
+        for (i = 0; i < n; i++) {
+            for (v = list[i], depth = 0; v != src && depth <= n; depth++) {
+                v = par[v];
+            }
+            if (v != src) {
+                break;
+            }
+        }
+        if (i == n) {
+            best = cost;
+            memcpy(parent, par, sizeof(par));
+        }
+    }
+
+    return best;
+}
+
+//为源src和目标集合targets规划转换树, 共享中间量只在使总边权更小时加入
+static void time_plan_build(int src, unsigned targets, time_plan_t *pplan)
+{
+    int parent[TIME_PLAN_NODES] = { 0 }, par[TIME_PLAN_NODES] = { 0 };
+    unsigned done, nodes;
+    int cost, best, v;
+
+    best = time_plan_tree(src, targets, parent);
+    nodes = targets;
+    cost = time_plan_tree(src, targets | (1u << TIME_PLAN_DAY), par);
+    if (cost >= 0 && (best < 0 || cost < best)) {
+        memcpy(parent, par, sizeof(par));
+        nodes |= 1u << TIME_PLAN_DAY;
+    }
+
+    //按拓扑序排列: 父结点已算出的结点依次加入
+    pplan->nsteps = 0;
+    done = 1u << src;
+    while (nodes & ~done) {
+        for (v = 0; v < TIME_PLAN_NODES; v++) {
+            if ((nodes & ~done & (1u << v)) && (done & (1u << parent[v]))) {
+                pplan->from[pplan->nsteps] = (unsigned char)parent[v];
+                pplan->to[pplan->nsteps] = (unsigned char)v;
+                pplan->nsteps++;
+                done |= 1u << v;
+            }
+        }
+    }
+}
+
+static void time_plan_init(void)
+{
+    int state, from, to;
+
+    for (state = 0; state <= TIME_MJD_TO_ALL; state++) {
+        time_plan_state(state, &from, &to);
+        time_plan_build(from, (to == TIME_MAX) ? ((1u << TIME_MAX) - 1) & ~(1u << from) : 1u << to,
+            &g_time_plan[state]);
+    }
+}
+
+/*
+ * 按state把pt转换为目标时间, 结果写入pctx中对应的成员, 可重入.
+ * 返回结果的时间类型(TO_ALL时为TIME_MAX, 五种时间都有效), state无效时返回-1.
+ * pt可以指向pctx中的成员. 转换按g_time_plan中预先规划的转换树执行.
+ */
+static int time_convert(time_convert_ctx_t *pctx, const void *pt, time_convert_state_t state)
+{
+    void *pnode[TIME_PLAN_NODES];
+    const time_plan_t *pplan;
+    time_day_t day;
+    int from, to, i;
+
+    if ((unsigned)state > TIME_MJD_TO_ALL) {
+        return -1;
+    }
+    pthread_once(&g_time_plan_once, time_plan_init);
+
+    pnode[TIME_COMMON] = &pctx->ct;
+    pnode[TIME_JULIAN] = &pctx->jd;
+    pnode[TIME_GPS] = &pctx->gt;
+    pnode[TIME_doy_t] = &pctx->doy;
+    pnode[TIME_MJD] = &pctx->mjd;
+    pnode[TIME_PLAN_DAY] = &day;
+
+    time_plan_state(state, &from, &to);
+    pplan = &g_time_plan[state];
+    for (i = 0; i < pplan->nsteps; i++) {
+        g_time_plan_kernel[pplan->from[i]][pplan->to[i]]((pplan->from[i] == from) ? pt : pnode[pplan->from[i]],
+            pnode[pplan->to[i]]);
+    }
+    if (to == TIME_MAX) {
+        memmove(pnode[from], pt, g_time_plan_size[from]);
+    }
+
+    return to;
+}
+
+//转换并打印结果, 供交互菜单使用
+static int time_convert_show(time_convert_ctx_t *pctx, const void *pt, time_convert_state_t state)
+{
+    int type;
+    int i;
+    void *p;
+
+    type = time_convert(pctx, pt, state);
+    if (type < 0) {
+        return -1;
+    }
+
+    for (i = 0; i < TIME_MAX; i++) {
+        if (type != TIME_MAX && type != i) {
+            continue;
+        }
+
+        if (i == TIME_COMMON) {
+            p = &pctx->ct;
+        } else if (i == TIME_JULIAN) {
+            p = &pctx->jd;
+        } else if (i == TIME_GPS) {
+            p = &pctx->gt;
+        } else if (i == TIME_doy_t) {
+            p = &pctx->doy;
+        } else {
+            p = &pctx->mjd;
+        }
+
+        time_print(i, p);
+    }
+
+    return 0;
+}
+
+static int time_convert_gps(time_convert_ctx_t *pctx, int argc, char *argv[])
+{
+    int type;
+    gps_time_t *pgt = &pctx->gt;
+    time_convert_state_t state;
+    char typename[10];
+    int rv = 0;
+    char yesorno[10];
+    bool input_time = true;
+
+    if (pgt->wn) {
+        printf("do you want to input gps time again[y/n]: ");
+        scanf("%s", yesorno);
+        if (memcmp(yesorno, "n", strlen("n")) == 0) {
+            input_time = false;
+        }
+    }
+
+    if (input_time) {
+        printf("Please input gpstime: \n");
+        printf("week number: ");
+        scanf("%d", &pgt->wn);
+        printf("Time of week(s): ");
+        scanf("%d", &pgt->tow.sn);
+        printf("Fractional of seconds: ");
+        scanf("%lf", &pgt->tow.tos);
+    }
+
+    if (TIME_DBG_OPEN) {
+        printf("gps.wn      : %d\n", pgt->wn);
+        printf("gps.tow.sn  : %d\n", pgt->tow.sn);
+        printf("gps.tow.tos : %lf\n", pgt->tow.tos);
+    }
+
+    while (1) {
+        printf("\ngps convert to [ct|jd|doy|mjd|all|quit|exit]: ");
+        scanf("%s", typename);
+        type = time_get_type_from_name(typename);
+        if (type == -2) {
+            continue;
+        }
+
+        switch (type) {
+            case TIME_COMMON:
+                state = TIME_GPS_TO_COMMON;
+                break;
+            case TIME_JULIAN:
+                state = TIME_GPS_TO_JULIAN;
+                break;
+            case TIME_doy_t:
+                state = TIME_GPS_TO_doy_t;
+                break;
+            case TIME_MJD:
+                state = TIME_GPS_TO_MJD;
+                break;
+            case TIME_MAX:
+                state = TIME_GPS_TO_ALL;
+                break;
+            default:
+                return -1;
+        }
+
+        rv = time_convert_show(pctx, pgt, state);
+    }
+
+    return rv;
+}
+
+static int time_convert_ct(time_convert_ctx_t *pctx, int argc, char *argv[])
+{
+    int type;
+    common_time_t *pct = &pctx->ct;
+    time_convert_state_t state;
+    char typename[10];
+    int rv = 0;
+    char commtime[64];
+    char yesorno[10];
+    bool input_time = true;
+
+    if (pct->year) {
+        printf("do you want to input common time again[y/n]: ");
+        scanf("%s", yesorno);
+        if (memcmp(yesorno, "n", strlen("n")) == 0) {
+            input_time = false;
+        }
+    }
+
+    if (input_time) {
+        printf("Please input commontime[yyyymmddhhmmss.xx]: ");
+        memset(commtime, 0, sizeof(commtime));
+        scanf("%63s", commtime);
+        if (time_parse_commontime(commtime, strlen(commtime), pct) != 0) {
+            printf("invalid commontime: %s\n", commtime);
+            memset(pct, 0, sizeof(*pct));
+            return -1;
+        }
+    }
+
+    if (TIME_DBG_OPEN) {
+        printf("ct.year    : %d\n", pct->year);
+        printf("ct.month   : %d\n", pct->month);
+        printf("ct.day     : %d\n", pct->day);
+        printf("ct.hour    : %d\n", pct->hour);
+        printf("ct.minute  : %d\n", pct->minute);
+        printf("ct.seconds : %lf\n", pct->second);
+    }
+
+    while (1) {
+        printf("\ncommontime convert to [gps|jd|doy|mjd|all|quit|exit]: ");
+        scanf("%s", typename);
+        type = time_get_type_from_name(typename);
+        if (type == -2) {
+            continue;
+        }
+
+        switch (type) {
+            case TIME_GPS:
+                state = TIME_COMMON_TO_GPS;
+                break;
+            case TIME_JULIAN:
+                state = TIME_COMMON_TO_JULIAN;
+                break;
+            case TIME_doy_t:
+                state = TIME_COMMON_TO_doy_t;
+                break;
+            case TIME_MJD:
+                state = TIME_COMMON_TO_MJD;
+                break;
+            case TIME_MAX:
+                state = TIME_COMMON_TO_ALL;
+                break;
+            default:
+                return -1;
+        }
+
+        rv = time_convert_show(pctx, pct, state);
+    }
+
+    return rv;
+}
+
+static int time_convert_jd(time_convert_ctx_t *pctx, int argc, char *argv[])
+{
+    int type;
+    julianday_t *pjd = &pctx->jd;
+    time_convert_state_t state;
+    char typename[10];
+    int rv = 0;
+    char yesorno[10];
+    bool input_time = true;
+
+    if (pjd->tod.sn) {
+        printf("do you want to input julianday time again[y/n]: ");
+        scanf("%s", yesorno);
+        if (memcmp(yesorno, "n", strlen("n")) == 0) {
+            input_time = false;
+        }
+    }
+
+    if (input_time) {
+        printf("Please input julianday: \n");
+        printf("day: ");
+        scanf("%ld", &pjd->day);
+        printf("seconds: ");
+        scanf("%d", &pjd->tod.sn);
+        printf("Fractional of seconds: ");
+        scanf("%lf", &pjd->tod.tos);
+    }
+
+    if (TIME_DBG_OPEN) {
+        printf("jd.day      : %d\n", pjd->day);
+        printf("jd.tod.sn   : %d\n", pjd->tod.sn);
+        printf("jd.tod.tos  : %lf\n", pjd->tod.tos);
+    }
+
+    while (1) {
+        printf("\njulianday convert to [ct|gps|doy|mjd|all|quit|exit]: ");
+        scanf("%s", typename);
+        type = time_get_type_from_name(typename);
+        if (type == -2) {
+            continue;
+        }
+
+        switch (type) {
+            case TIME_GPS:
+                state = TIME_JULIAN_TO_GPS;
+                break;
+            case TIME_COMMON:
+                state = TIME_JULIAN_TO_COMMON;
+                break;
+            case TIME_doy_t:
+                state = TIME_JULIAN_TO_doy_t;
+                break;
+            case TIME_MJD:
+                state = TIME_JULIAN_TO_MJD;
+                break;
+            case TIME_MAX:
+                state = TIME_JULIAN_TO_ALL;
+                break;
+            default:
+                return -1;
+        }
+
+        rv = time_convert_show(pctx, pjd, state);
+    }
+
+    return rv;
+}
+
+static int time_convert_doy(time_convert_ctx_t *pctx, int argc, char *argv[])
+{
+    int type;
+    doy_t *pdoy = &pctx->doy;
+    time_convert_state_t state;
+    char typename[10];
+    int rv = 0;
+    char yesorno[10];
+    bool input_time = true;
+
+    if (pdoy->year) {
+        printf("do you want to input doy time again[y/n]: ");
+        scanf("%s", yesorno);
+        if (memcmp(yesorno, "n", strlen("n")) == 0) {
+            input_time = false;
+        }
+    }
+
+    if (input_time) {
+        printf("Please input doy: \n");
+        printf("year: ");
+        scanf("%u", &pdoy->year);
+        printf("day: ");
+        scanf("%u", &pdoy->day);
+        printf("seconds: ");
+        scanf("%d", &pdoy->tod.sn);
+        printf("Fractional of seconds: ");
+        scanf("%lf", &pdoy->tod.tos);
+    }
+
+    if (TIME_DBG_OPEN) {
+        printf("doy.year     : %d\n", pdoy->year);
+        printf("doy.day      : %d\n", pdoy->day);
+        printf("doy.tod.sn   : %d\n", pdoy->tod.sn);
+        printf("doy.tod.tos  : %lf\n", pdoy->tod.tos);
+    }
+
+    while (1) {
+        printf("\ndoy convert to [ct|jd|gt|mjd|all|quit|exit]: ");
+        scanf("%s", typename);
+        type = time_get_type_from_name(typename);
+        if (type == -2) {
+            continue;
+        }
+
+        switch (type) {
+            case TIME_GPS:
+                state = TIME_doy_t_TO_GPS;
+                break;
+            case TIME_COMMON:
+                state = TIME_doy_t_TO_COMMON;
+                break;
+            case TIME_JULIAN:
+                state = TIME_doy_t_TO_JULIAN;
+                break;
+            case TIME_MJD:
+                state = TIME_doy_t_TO_MJD;
+                break;
+            case TIME_MAX:
+                state = TIME_doy_t_TO_ALL;
+                break;
+            default:
+                return -1;
+        }
+
+        rv = time_convert_show(pctx, pdoy, state);
+    }
+
+    return rv;
+}
+
+static int time_convert_mjd(time_convert_ctx_t *pctx, int argc, char *argv[])
 {
     int type;
-    julianday_t *pjd = &g_jd;
+    new_julianday_t *pmjd = &pctx->mjd;
     time_convert_state_t state;
     char typename[10];
     int rv = 0;
-    char yesorno[10];
-    bool input_time = true;
+    char yesorno[10];
+    bool input_time = true;
+
+    if (pmjd->day) {
+        printf("do you want to input mjd time again[y/n]: ");
+        scanf("%s", yesorno);
+        if (memcmp(yesorno, "n", strlen("n")) == 0) {
+            input_time = false;
+        }
+    }
+
+    if (input_time) {
+        printf("Please input mjd: \n");
+        printf("day: ");
+        scanf("%ld", &pmjd->day);
+        printf("seconds: ");
+        scanf("%ld", &pmjd->tod.sn);
+        printf("Fractional of seconds: ");
+        scanf("%lf", &pmjd->tod.tos);
+    }
+
+    if (TIME_DBG_OPEN) {
+        printf("mjd.day      : %ld\n", pmjd->day);
+        printf("mjd.tod.sn   : %ld\n", pmjd->tod.sn);
+        printf("mjd.tod.tos  : %lf\n", pmjd->tod.tos);
+    }
+
+    while (1) {
+        printf("\nmjd convert to [ct|jd|gps|doy|all|quit|exit]: ");
+        scanf("%s", typename);
+        type = time_get_type_from_name(typename);
+        if (type == -2) {
+            continue;
+        }
+
+        switch (type) {
+            case TIME_COMMON:
+                state = TIME_MJD_TO_COMMON;
+                break;
+            case TIME_JULIAN:
+                state = TIME_MJD_TO_JULIAN;
+                break;
+            case TIME_GPS:
+                state = TIME_MJD_TO_GPS;
+                break;
+            case TIME_doy_t:
+                state = TIME_MJD_TO_doy_t;
+                break;
+            case TIME_MAX:
+                state = TIME_MJD_TO_ALL;
+                break;
+            default:
+                return -1;
+        }
+
+        rv = time_convert_show(pctx, pmjd, state);
+    }
+
+    return rv;
+}
+
+static int time_write_all(int fd, const char *buf, size_t len)
+{
+    ssize_t n;
+
+    while (len > 0) {
+        n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+
+    return 0;
+}
+
+/*
+ * 二进制历元文件: 按列存储转换后的历元, 重新加载时整体mmap, 各列直接作为数组使用, 不再解析文本.
+ * 文件由头部、若干数据块和块索引依次组成, 数值为主机字节序(头部byte_order用于识别):
+ *     头部  : time_epoch_header_t, 64字节
+ *     数据块: 最多TIME_EPOCH_BLOCK_RECORDS条历元, 块内依次为各列的定长数组:
+ *             ns  : int64, 自GPS起点的纳秒数(time_ns_t), 总是存在
+ *             tow : int64, 周内纳秒数, columns含TIME_EPOCH_COL_GPS时存在
+ *             wn  : int32, GPS周数, 同上
+ *             doy : uint16年、uint16年积日, columns含TIME_EPOCH_COL_DOY时存在
+ *     块索引: 每块一项time_epoch_index_t, 记录块的偏移、条数及ns列的最小、最大值,
+ *             按时间范围读取时不在范围内的块整块跳过.
+ * 8字节的列排在前面且每块按8字节补齐, 映射后各列数组都自然对齐.
+ * 写入端逐块缓冲, 结束时写出块索引并回填头部, 因此输出必须是普通文件.
+ */
+#define TIME_EPOCH_MAGIC            "TCEPOCH1"
+#define TIME_EPOCH_VERSION          (1)
+#define TIME_EPOCH_BYTE_ORDER       (0x01020304U)
+#define TIME_EPOCH_BLOCK_RECORDS    (65536)
+#define TIME_EPOCH_COL_GPS          (1U << 0)   //wn、tow列
+#define TIME_EPOCH_COL_DOY          (1U << 1)   //doy列
+
+typedef struct time_epoch_header_s {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t columns;
+    uint32_t block_records;
+    uint64_t count;             //历元总数
+    uint64_t nblocks;
+    uint64_t index_offset;      //块索引在文件中的偏移
+    uint8_t reserved[16];
+} time_epoch_header_t;
+
+typedef struct time_epoch_index_s {
+    uint64_t offset;            //数据块在文件中的偏移
+    uint32_t count;
+    uint32_t reserved;
+    time_ns_t min_ns;
+    time_ns_t max_ns;
+} time_epoch_index_t;
+
+typedef struct time_epoch_doy_s {
+    uint16_t year;
+    uint16_t day;
+} time_epoch_doy_t;
+
+//写入端: 缓冲一个数据块, 块满时按列写出
+typedef struct time_epoch_writer_s {
+    int fd;
+    uint32_t columns;
+    uint64_t count;
+    uint64_t offset;            //下一个数据块的偏移
+    time_epoch_index_t *index;
+    size_t nblocks;
+    size_t index_cap;
+    size_t n;                   //当前块已缓冲的历元数
+    time_ns_t *ns;
+    int64_t *tow;
+    int32_t *wn;
+    time_epoch_doy_t *doy;
+    bool day_valid;             //doy列缓存上一历元所在GPS日的年积日
+    long long day;
+    time_epoch_doy_t day_doy;
+} time_epoch_writer_t;
+
+//读取端: 整个文件只读映射
+typedef struct time_epoch_reader_s {
+    const char *map;
+    size_t size;
+    const time_epoch_header_t *hdr;
+    const time_epoch_index_t *index;
+} time_epoch_reader_t;
+
+//一个数据块的各列, 直接指向映射区, 文件中没有的列为NULL
+typedef struct time_epoch_block_s {
+    size_t n;
+    time_ns_t min_ns;
+    time_ns_t max_ns;
+    const time_ns_t *ns;
+    const int64_t *tow;
+    const int32_t *wn;
+    const time_epoch_doy_t *doy;
+} time_epoch_block_t;
+
+//n条历元的数据块字节数, 按8字节补齐
+static size_t time_epoch_block_size(uint32_t columns, size_t n)
+{
+    size_t size = n * sizeof(time_ns_t);
+
+    if (columns & TIME_EPOCH_COL_GPS) {
+        size += n * (sizeof(int64_t) + sizeof(int32_t));
+    }
+    if (columns & TIME_EPOCH_COL_DOY) {
+        size += n * sizeof(time_epoch_doy_t);
+    }
+
+    return (size + 7) & ~(size_t)7;
+}
+
+static void time_epoch_writer_free(time_epoch_writer_t *pw)
+{
+    free(pw->index);
+    free(pw->ns);
+    free(pw->tow);
+    free(pw->wn);
+    free(pw->doy);
+}
+
+//创建历元文件, columns为TIME_EPOCH_COL_*的组合
+static int time_epoch_writer_open(time_epoch_writer_t *pw, const char *path, uint32_t columns)
+{
+    time_epoch_header_t hdr;
+
+    memset(pw, 0, sizeof(*pw));
+    pw->columns = columns;
+    pw->offset = sizeof(hdr);
+
+    pw->ns = malloc(TIME_EPOCH_BLOCK_RECORDS * sizeof(*pw->ns));
+    if (columns & TIME_EPOCH_COL_GPS) {
+        pw->tow = malloc(TIME_EPOCH_BLOCK_RECORDS * sizeof(*pw->tow));
+        pw->wn = malloc(TIME_EPOCH_BLOCK_RECORDS * sizeof(*pw->wn));
+    }
+    if (columns & TIME_EPOCH_COL_DOY) {
+        pw->doy = malloc(TIME_EPOCH_BLOCK_RECORDS * sizeof(*pw->doy));
+    }
+    if (pw->ns == NULL || ((columns & TIME_EPOCH_COL_GPS) && (pw->tow == NULL || pw->wn == NULL))
+        || ((columns & TIME_EPOCH_COL_DOY) && pw->doy == NULL)) {
+        time_epoch_writer_free(pw);
+        return -1;
+    }
+
+    pw->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (pw->fd < 0) {
+        time_epoch_writer_free(pw);
+        return -1;
+    }
+
+    //头部先占位, 关闭时回填
+    memset(&hdr, 0, sizeof(hdr));
+    if (time_write_all(pw->fd, (const char *)&hdr, sizeof(hdr)) != 0) {
+        close(pw->fd);
+        time_epoch_writer_free(pw);
+        return -1;
+    }
+
+    return 0;
+}
+
+//写出当前缓冲的数据块并记入块索引
+static int time_epoch_writer_flush(time_epoch_writer_t *pw)
+{
+    static const char pad[8] = { 0 };
+    time_epoch_index_t *pi;
+    size_t n = pw->n;
+    size_t size, i;
+    void *index;
+
+    if (n == 0) {
+        return 0;
+    }
+
+    if (pw->nblocks == pw->index_cap) {
+        pw->index_cap = pw->index_cap ? pw->index_cap * 2 : 64;
+        index = realloc(pw->index, pw->index_cap * sizeof(*pw->index));
+        if (index == NULL) {
+            return -1;
+        }
+        pw->index = index;
+    }
+    pi = &pw->index[pw->nblocks];
+    memset(pi, 0, sizeof(*pi));
+    pi->offset = pw->offset;
+    pi->count = (uint32_t)n;
+    pi->min_ns = pw->ns[0];
+    pi->max_ns = pw->ns[0];
+    for (i = 1; i < n; i++) {
+        if (pw->ns[i] < pi->min_ns) {
+            pi->min_ns = pw->ns[i];
+        }
+        if (pw->ns[i] > pi->max_ns) {
+            pi->max_ns = pw->ns[i];
+        }
+    }
+
+    size = n * sizeof(*pw->ns);
+    if (time_write_all(pw->fd, (const char *)pw->ns, n * sizeof(*pw->ns)) != 0) {
+        return -1;
+    }
+    if (pw->columns & TIME_EPOCH_COL_GPS) {
+        size += n * (sizeof(*pw->tow) + sizeof(*pw->wn));
+        if (time_write_all(pw->fd, (const char *)pw->tow, n * sizeof(*pw->tow)) != 0
+            || time_write_all(pw->fd, (const char *)pw->wn, n * sizeof(*pw->wn)) != 0) {
+            return -1;
+        }
+    }
+    if (pw->columns & TIME_EPOCH_COL_DOY) {
+        size += n * sizeof(*pw->doy);
+        if (time_write_all(pw->fd, (const char *)pw->doy, n * sizeof(*pw->doy)) != 0) {
+            return -1;
+        }
+    }
+    if (time_write_all(pw->fd, pad, time_epoch_block_size(pw->columns, n) - size) != 0) {
+        return -1;
+    }
+
+    pw->offset += time_epoch_block_size(pw->columns, n);
+    pw->count += n;
+    pw->nblocks++;
+    pw->n = 0;
+
+    return 0;
+}
+
+//追加n条纳秒时间, 可选列由纳秒时间换算
+static int time_epoch_writer_add(time_epoch_writer_t *pw, const time_ns_t *pns, size_t n)
+{
+    long long wn, day;
+    int year, yday;
+    size_t i, k;
+
+    for (i = 0; i < n; i++) {
+        k = pw->n;
+        pw->ns[k] = pns[i];
+
+        if (pw->columns & TIME_EPOCH_COL_GPS) {
+            wn = time_floor_div(pns[i], TIME_NS_PER_WEEK);
+            pw->wn[k] = (int32_t)wn;
+            pw->tow[k] = pns[i] - wn * TIME_NS_PER_WEEK;
+        }
+        if (pw->columns & TIME_EPOCH_COL_DOY) {
+            day = time_floor_div(pns[i], TIME_NS_PER_DAY);
+            if (!pw->day_valid || day != pw->day) {
+                time_doy_from_days(day + TIME_GPS_EPOCH_DAYS, &year, &yday);
+                pw->day_doy.year = (uint16_t)year;
+                pw->day_doy.day = (uint16_t)yday;
+                pw->day = day;
+                pw->day_valid = true;
+            }
+            pw->doy[k] = pw->day_doy;
+        }
+
+        if (++pw->n == TIME_EPOCH_BLOCK_RECORDS && time_epoch_writer_flush(pw) != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+//写出剩余数据块和块索引, 回填头部并关闭文件; 无论成功与否都释放写入端
+static int time_epoch_writer_close(time_epoch_writer_t *pw)
+{
+    time_epoch_header_t hdr;
+    int rv = -1;
+
+    if (time_epoch_writer_flush(pw) == 0
+        && time_write_all(pw->fd, (const char *)pw->index, pw->nblocks * sizeof(*pw->index)) == 0) {
+        memset(&hdr, 0, sizeof(hdr));
+        memcpy(hdr.magic, TIME_EPOCH_MAGIC, sizeof(hdr.magic));
+        hdr.version = TIME_EPOCH_VERSION;
+        hdr.byte_order = TIME_EPOCH_BYTE_ORDER;
+        hdr.columns = pw->columns;
+        hdr.block_records = TIME_EPOCH_BLOCK_RECORDS;
+        hdr.count = pw->count;
+        hdr.nblocks = pw->nblocks;
+        hdr.index_offset = pw->offset;
+        if (pwrite(pw->fd, &hdr, sizeof(hdr), 0) == (ssize_t)sizeof(hdr)) {
+            rv = 0;
+        }
+    }
+
+    if (close(pw->fd) != 0) {
+        rv = -1;
+    }
+    time_epoch_writer_free(pw);
+
+    return rv;
+}
+
+//映射并校验历元文件, 之后各数据块的访问不再需要检查边界; 不是有效的历元文件时返回-2
+static int time_epoch_reader_open(time_epoch_reader_t *pr, int fd)
+{
+    const time_epoch_header_t *hdr;
+    const time_epoch_index_t *pi;
+    struct stat st;
+    uint64_t count = 0;
+    uint64_t i;
+    void *map;
+
+    memset(pr, 0, sizeof(*pr));
+    if (fstat(fd, &st) != 0) {
+        return -1;
+    }
+    if (!S_ISREG(st.st_mode) || (size_t)st.st_size < sizeof(*hdr)) {
+        return -2;
+    }
+
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+    pr->map = map;
+    pr->size = (size_t)st.st_size;
+    hdr = map;
+
+    if (memcmp(hdr->magic, TIME_EPOCH_MAGIC, sizeof(hdr->magic)) != 0 || hdr->version != TIME_EPOCH_VERSION
+        || hdr->byte_order != TIME_EPOCH_BYTE_ORDER || (hdr->columns & ~(TIME_EPOCH_COL_GPS | TIME_EPOCH_COL_DOY))
+        || hdr->block_records == 0 || hdr->index_offset < sizeof(*hdr) || hdr->index_offset % 8 != 0
+        || hdr->index_offset > pr->size || hdr->nblocks > (pr->size - hdr->index_offset) / sizeof(*pi)) {
+        goto invalid;
+    }
+
+    //各块须在头部与块索引之间、8字节对齐, 条数之和等于历元总数
+    pi = (const time_epoch_index_t *)(pr->map + hdr->index_offset);
+    for (i = 0; i < hdr->nblocks; i++) {
+        if (pi[i].count == 0 || pi[i].count > hdr->block_records || pi[i].offset < sizeof(*hdr)
+            || pi[i].offset % 8 != 0 || pi[i].offset > hdr->index_offset
+            || time_epoch_block_size(hdr->columns, pi[i].count) > hdr->index_offset - pi[i].offset) {
+            goto invalid;
+        }
+        count += pi[i].count;
+    }
+    if (count != hdr->count) {
+        goto invalid;
+    }
+
+    pr->hdr = hdr;
+    pr->index = pi;
+
+    return 0;
+
+invalid:
+    munmap(map, pr->size);
+    memset(pr, 0, sizeof(*pr));
+
+    return -2;
+}
+
+//取第i个数据块的各列
+static void time_epoch_reader_block(const time_epoch_reader_t *pr, size_t i, time_epoch_block_t *pblk)
+{
+    const time_epoch_index_t *pi = &pr->index[i];
+    const char *p = pr->map + pi->offset;
+    size_t n = pi->count;
+
+    pblk->n = n;
+    pblk->min_ns = pi->min_ns;
+    pblk->max_ns = pi->max_ns;
+    pblk->ns = (const time_ns_t *)p;
+    p += n * sizeof(*pblk->ns);
+    pblk->tow = NULL;
+    pblk->wn = NULL;
+    pblk->doy = NULL;
+    if (pr->hdr->columns & TIME_EPOCH_COL_GPS) {
+        pblk->tow = (const int64_t *)p;
+        p += n * sizeof(*pblk->tow);
+        pblk->wn = (const int32_t *)p;
+        p += n * sizeof(*pblk->wn);
+    }
+    if (pr->hdr->columns & TIME_EPOCH_COL_DOY) {
+        pblk->doy = (const time_epoch_doy_t *)p;
+    }
+}
+
+static void time_epoch_reader_close(time_epoch_reader_t *pr)
+{
+    if (pr->map != NULL) {
+        munmap((void *)pr->map, pr->size);
+    }
+    memset(pr, 0, sizeof(*pr));
+}
+
+/*
+ * 历元差分编码: 接收机历元几乎等间隔(如0.05秒、1秒), 按纳秒时间差分后游程编码.
+ * 编码流依次为:
+ *     首历元: zigzag varint GPS周数, varint周内纳秒数(周内秒及其小数按最近的纳秒取整)
+ *     游程  : zigzag varint 相邻历元的纳秒差, varint 连续使用该差值的历元数(>= 1)
+ * varint为小端base-128(每字节低7位有效, 最高位表示后续还有字节), zigzag把有符号数映射为无符号数,
+ * 时间倒退、跳变也能编码; 纳秒差按64位补码回绕计算, 相距超过int64范围的两个历元也能正确还原.
+ * 等间隔数据流整段只占一个游程, 间隔变化处开始新的游程.
+ * 编码、解码都可以分多次进行, 编码流不记录总数, 解到流末尾为止.
+ * 解码时每个历元直接经time_stream_t换算为所需的时间, 不经过中间数组.
+ */
+#define TIME_DELTA_VARINT_MAX   (10)        //64位varint的最大字节数
+#define TIME_DELTA_BOUND(n)     (((size_t)(n) + 1) * 2 * TIME_DELTA_VARINT_MAX)  //编码n个历元的最大输出字节数
+
+typedef struct time_delta_encoder_s {
+    bool started;
+    time_ns_t ns;               //上一历元
+    time_ns_t delta;            //当前游程的纳秒差
+    uint64_t count;             //当前游程的历元数, 0表示还没有游程
+} time_delta_encoder_t;
+
+typedef struct time_delta_decoder_s {
+    const uint8_t *p;
+    const uint8_t *end;
+    bool started;
+    time_ns_t ns;               //上一个输出的历元
+    time_ns_t delta;
+    uint64_t left;              //当前游程还未输出的历元数
+    time_stream_t stream;
+} time_delta_decoder_t;
+
+static uint8_t *time_delta_put_varint(uint8_t *p, uint64_t v)
+{
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+
+    return p;
+}
+
+//读一个varint, 数据不完整或超过10字节时返回NULL
+static const uint8_t *time_delta_get_varint(const uint8_t *p, const uint8_t *end, uint64_t *pv)
+{
+    uint64_t v = 0;
+    int shift;
+
+    for (shift = 0; shift < 7 * TIME_DELTA_VARINT_MAX && p < end; shift += 7) {
+        v |= (uint64_t)(*p & 0x7F) << shift;
+        if ((*p++ & 0x80) == 0) {
+            *pv = v;
+            return p;
+        }
+    }
+
+    return NULL;
+}
+
+static uint64_t time_delta_zigzag(int64_t v)
+{
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t time_delta_unzigzag(uint64_t v)
+{
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static void time_delta_encoder_init(time_delta_encoder_t *pe)
+{
+    memset(pe, 0, sizeof(*pe));
+}
+
+//编码n个纳秒时间到out, 返回写入的字节数; out至少TIME_DELTA_BOUND(n)字节. 最后一个游程留到下次或finish时写出
+static size_t time_delta_encode(time_delta_encoder_t *pe, const time_ns_t *pns, size_t n, uint8_t *out)
+{
+    uint8_t *p = out;
+    time_ns_t ns, delta;
+    long long wn;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        ns = pns[i];
+        if (!pe->started) {
+            wn = time_floor_div(ns, TIME_NS_PER_WEEK);
+            p = time_delta_put_varint(p, time_delta_zigzag(wn));
+            p = time_delta_put_varint(p, (uint64_t)(ns - wn * TIME_NS_PER_WEEK));
+            pe->started = true;
+            pe->ns = ns;
+            continue;
+        }
+
+        delta = (time_ns_t)((uint64_t)ns - (uint64_t)pe->ns);
+        pe->ns = ns;
+        if (pe->count > 0 && delta == pe->delta) {
+            pe->count++;
+            continue;
+        }
+        if (pe->count > 0) {
+            p = time_delta_put_varint(p, time_delta_zigzag(pe->delta));
+            p = time_delta_put_varint(p, pe->count);
+        }
+        pe->delta = delta;
+        pe->count = 1;
+    }
+
+    return (size_t)(p - out);
+}
+
+//写出最后一个游程, 返回写入的字节数; out至少TIME_DELTA_BOUND(0)字节
+static size_t time_delta_finish(time_delta_encoder_t *pe, uint8_t *out)
+{
+    uint8_t *p = out;
+
+    if (pe->count > 0) {
+        p = time_delta_put_varint(p, time_delta_zigzag(pe->delta));
+        p = time_delta_put_varint(p, pe->count);
+        pe->count = 0;
+    }
+
+    return (size_t)(p - out);
+}
+
+static void time_delta_decoder_init(time_delta_decoder_t *pd, const void *data, size_t len)
+{
+    memset(pd, 0, sizeof(*pd));
+    pd->p = data;
+    pd->end = pd->p + len;
+    time_stream_init(&pd->stream);
+}
+
+/*
+ * 解码至多cap个历元, 各历元同时换算为GPS时、通用时、儒略日、年积日, 不需要的数组传NULL.
+ * 解出的个数写入*pn, 为0表示已到流末尾; 编码流损坏时返回-1.
+ */
+static int time_delta_decode(time_delta_decoder_t *pd, gps_time_t *pgt, common_time_t *pct, julianday_t *pjd,
+    doy_t *pdoy, size_t cap, size_t *pn)
+{
+    const uint8_t *p;
+    uint64_t v1, v2;
+    int64_t wn;
+    gps_time_t gt;
+    size_t i;
+
+    for (i = 0; i < cap; i++) {
+        if (pd->left == 0) {
+            if (pd->p == pd->end) {
+                break;
+            }
+            p = time_delta_get_varint(pd->p, pd->end, &v1);
+            p = (p != NULL) ? time_delta_get_varint(p, pd->end, &v2) : NULL;
+            if (p == NULL) {
+                return -1;
+            }
+            pd->p = p;
+
+            if (!pd->started) {
+                //首历元: 周数和周内纳秒数
+                wn = time_delta_unzigzag(v1);
+                if (v2 >= (uint64_t)TIME_NS_PER_WEEK || wn < INT64_MIN / TIME_NS_PER_WEEK
+                    || wn > (INT64_MAX - (int64_t)v2) / TIME_NS_PER_WEEK) {
+                    return -1;
+                }
+                pd->ns = wn * TIME_NS_PER_WEEK + (time_ns_t)v2;
+                pd->started = true;
+            } else if (v2 == 0) {
+                return -1;
+            } else {
+                pd->delta = time_delta_unzigzag(v1);
+                pd->left = v2;
+            }
+        }
+        if (pd->left > 0) {
+            pd->ns = (time_ns_t)((uint64_t)pd->ns + (uint64_t)pd->delta);
+            pd->left--;
+        }
+
+        time_conver_ns_to_gpstime(&pd->ns, &gt);
+        time_stream_gpstime(&pd->stream, &gt, (pct != NULL) ? &pct[i] : NULL, (pjd != NULL) ? &pjd[i] : NULL,
+            (pdoy != NULL) ? &pdoy[i] : NULL);
+        if (pgt != NULL) {
+            pgt[i] = gt;
+        }
+    }
+    *pn = i;
+
+    return 0;
+}
+
+/*
+ * 非交互批处理模式:
+ *     time_conver --from gps --to ct,doy [-i file] < in > out
+ * 每行一条记录, 按TIME_BATCH_RECORDS条一批解析、批量转换、格式化到输出缓冲区, 每批一次write.
+ * 输入为普通文件(包括重定向的标准输入)时整体mmap, 管道等其他输入按TIME_BATCH_READ_SIZE大块读取.
+ * -j N(N > 1)且输入可以mmap时按记录边界切块, 由N个线程并行转换, 输出仍保持输入顺序.
+ *
+ * 输入格式:
+ *     ct  : yyyymmddhhmmss.xx 或 YYYY-MM-DDThh:mm:ss.sssZ
+ *     gps : 周数 周内秒(可带小数)
+ *     jd  : 整数天数 天内秒整数部分 秒小数部分
+ *     doy : yyyy:ddd:sssss(可带小数)
+ *     mjd : 整数天数 天内秒(可带小数)
+ * 输出每行按--to给出的顺序列出各时间, 时间之间以逗号分隔, 各时间按--format模板输出(见time_fmt_time),
+ * 默认csv模板的字段为:
+ *     ct  : 年,月,日,时,分,秒
+ *     gps : 周数,周内秒
+ *     jd  : 整数天数,天内秒
+ *     doy : 年,年积日,天内秒
+ *     mjd : 整数天数,天内秒
+ * 给出-o时不输出文本, 源时间换算为纳秒时间写入二进制历元文件(见time_epoch_writer_t);
+ * 给出--encode时源时间换算为纳秒时间后差分编码输出(见time_delta_encoder_t).
+ * 这两种输出中超出纳秒时间范围(约1688-2272年)的记录按无法解析的行报告, 不写入输出.
+ */
+#define TIME_BATCH_RECORDS      (4096)
+#define TIME_BATCH_READ_SIZE    (1 << 20)
+#define TIME_BATCH_LINE_MAX     (256)
+#define TIME_PAR_CHUNK_SIZE     (1 << 20)   //并行模式每块的大致字节数
+#define TIME_PAR_WINDOW         (4)         //每个线程最多领先输出的块数, 限制未输出结果占用的内存
+#define TIME_PAR_THREAD_MAX     (256)
+
+//北斗时、伽利略系统时、准天顶系统时的一批时间, 同一时刻只用其中一种
+typedef union time_gnss_batch_u {
+    bdt_time_t bdt[TIME_BATCH_RECORDS];
+    gst_time_t gst[TIME_BATCH_RECORDS];
+    qzsst_time_t qzs[TIME_BATCH_RECORDS];
+} time_gnss_batch_t;
+
+typedef struct time_batch_s {
+    size_t n;
+    common_time_t ct[TIME_BATCH_RECORDS];
+    julianday_t jd[TIME_BATCH_RECORDS];
+    gps_time_t gt[TIME_BATCH_RECORDS];
+    doy_t doy[TIME_BATCH_RECORDS];
+    new_julianday_t mjd[TIME_BATCH_RECORDS];
+    time_ns_t ns[TIME_BATCH_RECORDS];
+    size_t line[TIME_BATCH_RECORDS];    //各记录的输入行号, 报告超出可表示范围的记录用
+    size_t bad[TIME_BATCH_RECORDS];     //-o、--encode: 超出纳秒时间范围的记录的行号
+    time_gnss_batch_t sys[2];       //周计时系统时的源时间和目标时间
+    double dt[TIME_BATCH_RECORDS];  //--interval: 与上一条源时间之差(秒)
+} time_batch_t;
+
+//并行模式下一块中无法解析的行, 由输出线程按全局行号报告
+typedef struct time_par_err_s {
+    size_t lineno;
+    const char *line;           //NULL: 超出可表示范围的记录
+    size_t len;
+} time_par_err_t;
+
+//并行模式的一块输入及其转换结果
+typedef struct time_par_chunk_s {
+    const char *data;
+    size_t len;
+    char *out;
+    size_t out_len;
+    size_t out_cap;
+    time_par_err_t *err;
+    size_t nerr;
+    size_t err_cap;
+    size_t lines;
+    bool done;
+} time_par_chunk_t;
+
+/*
+ * 批处理的时标: 输入、输出时间默认都为GPST, 其他时标先换算到GPST再转换,
+ * 输入、输出都是北斗、伽利略、准天顶、格洛纳斯系统时时由两者之间的批量核心直接换算.
+ * UTC、TAI、GLONASST以通用时为基本表示, 其余表示由通用时换算, 跳秒当秒只有通用时能表示为23:59:60;
+ * BDT、GST、QZSST以本系统的周数和周内秒为基本表示(gps列), 其余表示为本时标的日历时间.
+ */
+typedef enum time_scale_e {
+    TIME_SCALE_GPST = 0,
+    TIME_SCALE_UTC,
+    TIME_SCALE_TAI,
+    TIME_SCALE_BDT,
+    TIME_SCALE_GST,
+    TIME_SCALE_QZSST,
+    TIME_SCALE_GLONASST,
+    TIME_SCALE_MAX
+} time_scale_t;
+
+typedef struct time_batch_ctx_s {
+    time_type_t from;
+    time_type_t to[TIME_MAX];
+    int nto;
+    int out_fd;
+    int nthread;
+    size_t lineno;
+    size_t errors;
+    time_fmt_template_t fmt;
+    time_batch_t *pb;
+    char *out;
+    time_par_chunk_t *chunk;    //非NULL时结果追加到该块而不是写到out_fd
+    time_stream_t stream;       //通用时、GPS时输入按数据流转换, 跨批次保留上一历元所在日
+    time_epoch_writer_t *epoch; //非NULL时源时间写入历元文件, 不输出文本
+    time_delta_encoder_t *delta;    //非NULL时源时间差分编码输出, 不输出文本
+    time_rollover_t rollover;   //GPS时输入的周数翻转解算, modulus为0时不解算
+    double shift;               //转换前源时间平移的秒数
+    time_scale_t scale_from;    //输入记录的时标
+    time_scale_t scale_to;      //输出时间的时标
+    time_leap_table_t leap;     //UTC时标用的跳秒表, 每个线程的上下文各有一份副本
+    bool has_since;             //只保留源时间不早于since、早于until的记录
+    bool has_until;
+    time_convert_ctx_t since;   //按--from的表示给出的范围
+    time_convert_ctx_t until;
+    bool interval;              //每行追加与上一条源时间之差(秒)
+    bool has_prev;
+    time_convert_ctx_t prev;    //上一批最后一条源时间
+} time_batch_ctx_t;
+
+static int time_batch_type_from_name(const char *name, size_t len)
+{
+    static const char *const names[TIME_MAX] = { "ct", "jd", "gps", "doy", "mjd" };
+    int i;
+
+    for (i = 0; i < TIME_MAX; i++) {
+        if (strlen(names[i]) == len && memcmp(name, names[i], len) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static int time_batch_scale_from_name(const char *name, time_scale_t *pscale)
+{
+    static const char *const names[TIME_SCALE_MAX] = { "gpst", "utc", "tai", "bdt", "gst", "qzsst", "glonasst" };
+    int i;
+
+    for (i = 0; i < TIME_SCALE_MAX; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *pscale = i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+static int time_batch_fmt_from_name(const char *name, time_fmt_template_t *pfmt)
+{
+    static const char *const names[TIME_FMT_MAX] = { "csv", "iso", "rinex", "wntow" };
+    int i;
+
+    for (i = 0; i < TIME_FMT_MAX; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *pfmt = i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+//解析逗号分隔的目标列表, "all"表示全部五种
+static int time_batch_parse_targets(time_batch_ctx_t *pctx, const char *list)
+{
+    const char *p = list;
+    const char *e;
+    int type, i;
+
+    pctx->nto = 0;
+    while (*p) {
+        e = strchr(p, ',');
+        if (e == NULL) {
+            e = p + strlen(p);
+        }
+
+        if (e - p == 3 && memcmp(p, "all", 3) == 0) {
+            for (i = 0; i < TIME_MAX; i++) {
+                pctx->to[i] = i;
+            }
+            pctx->nto = TIME_MAX;
+        } else {
+            type = time_batch_type_from_name(p, (size_t)(e - p));
+            if (type < 0 || pctx->nto >= TIME_MAX) {
+                return -1;
+            }
+            pctx->to[pctx->nto++] = type;
+        }
+
+        p = *e ? e + 1 : e;
+    }
+
+    return pctx->nto > 0 ? 0 : -1;
+}
+
+//解析一行记录(长度为len, 不要求以'\0'结尾)到第i个源时间, 成功返回0
+static int time_batch_parse_line(time_batch_ctx_t *pctx, const char *line, size_t len, size_t i)
+{
+    time_batch_t *pb = pctx->pb;
+
+    switch (pctx->from) {
+        case TIME_COMMON:
+            return time_parse_commontime(line, len, &pb->ct[i]);
+        case TIME_GPS:
+            return time_parse_gpstime(line, len, &pb->gt[i]);
+        case TIME_JULIAN:
+            return time_parse_julianday(line, len, &pb->jd[i]);
+        case TIME_doy_t:
+            return time_parse_doy(line, len, &pb->doy[i]);
+        case TIME_MJD:
+            return time_parse_mjd(line, len, &pb->mjd[i]);
+        default:
+            return -1;
+    }
+}
+
+//按from的格式解析--since/--until给出的时间, 成功返回0
+static int time_batch_parse_bound(time_type_t from, const char *text, time_convert_ctx_t *pbound)
+{
+    size_t len = strlen(text);
+
+    switch (from) {
+        case TIME_COMMON:
+            return time_parse_commontime(text, len, &pbound->ct);
+        case TIME_JULIAN:
+            return time_parse_julianday(text, len, &pbound->jd);
+        case TIME_GPS:
+            return time_parse_gpstime(text, len, &pbound->gt);
+        case TIME_doy_t:
+            return time_parse_doy(text, len, &pbound->doy);
+        case TIME_MJD:
+            return time_parse_mjd(text, len, &pbound->mjd);
+        default:
+            return -1;
+    }
+}
+
+//由源时间批量转换出一种目标时间
+static void time_batch_convert(time_batch_t *pb, time_type_t from, time_type_t to)
+{
+    size_t n = pb->n;
+
+    switch (from) {
+        case TIME_COMMON:
+            if (to == TIME_MJD) {
+                time_conver_commontime_to_mjd_batch(pb->ct, pb->mjd, n);
+            } else if (to == TIME_JULIAN) {
+                time_conver_commontime_to_julianday_batch(pb->ct, pb->jd, n);
+            } else if (to == TIME_GPS) {
+                time_conver_commontime_to_gpstime_batch(pb->ct, pb->gt, n);
+            } else if (to == TIME_doy_t) {
+                time_conver_commontime_to_doy_batch(pb->ct, pb->doy, n);
+            }
+            break;
+        case TIME_JULIAN:
+            if (to == TIME_MJD) {
+                time_conver_julianday_to_mjd_batch(pb->jd, pb->mjd, n);
+            } else if (to == TIME_COMMON) {
+                time_conver_julianday_to_commontime_batch(pb->jd, pb->ct, n);
+            } else if (to == TIME_GPS) {
+                time_conver_julianday_to_gpstime_batch(pb->jd, pb->gt, n);
+            } else if (to == TIME_doy_t) {
+                time_conver_julianday_to_doy_batch(pb->jd, pb->doy, n);
+            }
+            break;
+        case TIME_GPS:
+            if (to == TIME_MJD) {
+                time_conver_gpstime_to_mjd_batch(pb->gt, pb->mjd, n);
+            } else if (to == TIME_COMMON) {
+                time_conver_gpstime_to_commontime_batch(pb->gt, pb->ct, n);
+            } else if (to == TIME_JULIAN) {
+                time_conver_gpstime_to_julianday_batch(pb->gt, pb->jd, n);
+            } else if (to == TIME_doy_t) {
+                time_conver_gpstime_to_doy_batch(pb->gt, pb->doy, n);
+            }
+            break;
+        case TIME_doy_t:
+            if (to == TIME_MJD) {
+                time_conver_doy_to_mjd_batch(pb->doy, pb->mjd, n);
+            } else if (to == TIME_COMMON) {
+                time_conver_doy_to_commontime_batch(pb->doy, pb->ct, n);
+            } else if (to == TIME_JULIAN) {
+                time_conver_doy_to_julianday_batch(pb->doy, pb->jd, n);
+            } else if (to == TIME_GPS) {
+                time_conver_doy_to_gpstime_batch(pb->doy, pb->gt, n);
+            }
+            break;
+        case TIME_MJD:
+            if (to == TIME_COMMON) {
+                time_conver_mjd_to_commontime_batch(pb->mjd, pb->ct, n);
+            } else if (to == TIME_JULIAN) {
+                time_conver_mjd_to_julianday_batch(pb->mjd, pb->jd, n);
+            } else if (to == TIME_GPS) {
+                time_conver_mjd_to_gpstime_batch(pb->mjd, pb->gt, n);
+            } else if (to == TIME_doy_t) {
+                time_conver_mjd_to_doy_batch(pb->mjd, pb->doy, n);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+//源时间就地平移sec秒
+static void time_batch_shift(time_batch_t *pb, time_type_t from, double sec)
+{
+    switch (from) {
+        case TIME_COMMON:
+            time_commontime_add_batch(pb->ct, sec, pb->n);
+            break;
+        case TIME_JULIAN:
+            time_julianday_add_batch(pb->jd, sec, pb->n);
+            break;
+        case TIME_GPS:
+            time_gpstime_add_batch(pb->gt, sec, pb->n);
+            break;
+        case TIME_doy_t:
+            time_doy_add_batch(pb->doy, sec, pb->n);
+            break;
+        case TIME_MJD:
+            time_mjd_add_batch(pb->mjd, sec, pb->n);
+            break;
+        default:
+            break;
+    }
+}
+
+//--since/--until: 在源时间的表示上直接比较, 就地只保留范围内的记录, 行号随记录一同保留
+static void time_batch_select(time_batch_ctx_t *pctx)
+{
+    time_batch_t *pb = pctx->pb;
+    const time_convert_ctx_t *plo = pctx->has_since ? &pctx->since : NULL;
+    const time_convert_ctx_t *phi = pctx->has_until ? &pctx->until : NULL;
+    size_t *pline = pb->line;
+
+    switch (pctx->from) {
+        case TIME_COMMON:
+            pb->n = time_commontime_select(pb->ct, pb->n, plo ? &plo->ct : NULL, phi ? &phi->ct : NULL, pline);
+            break;
+        case TIME_JULIAN:
+            pb->n = time_julianday_select(pb->jd, pb->n, plo ? &plo->jd : NULL, phi ? &phi->jd : NULL, pline);
+            break;
+        case TIME_GPS:
+            pb->n = time_gpstime_select(pb->gt, pb->n, plo ? &plo->gt : NULL, phi ? &phi->gt : NULL, pline);
+            break;
+        case TIME_doy_t:
+            pb->n = time_doy_select(pb->doy, pb->n, plo ? &plo->doy : NULL, phi ? &phi->doy : NULL, pline);
+            break;
+        case TIME_MJD:
+            pb->n = time_mjd_select(pb->mjd, pb->n, plo ? &plo->mjd : NULL, phi ? &phi->mjd : NULL, pline);
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * --interval: 源时间逐条与上一条求差, 不经过日历; 跨批次保留上一批的最后一条, 第一条记录的差为0.
+ */
+#define TIME_BATCH_INTERVAL(name, src, last) \
+    do { \
+        pb->dt[0] = pctx->has_prev ? time_##name##_diff(&pb->src[0], &pctx->prev.last) : 0.0; \
+        time_##name##_diff_batch(pb->src + 1, pb->src, pb->dt + 1, pb->n - 1); \
+        pctx->prev.last = pb->src[pb->n - 1]; \
+    } while (0)
+
+static void time_batch_interval(time_batch_ctx_t *pctx)
+{
+    time_batch_t *pb = pctx->pb;
+
+    switch (pctx->from) {
+        case TIME_COMMON:
+            TIME_BATCH_INTERVAL(commontime, ct, ct);
+            break;
+        case TIME_JULIAN:
+            TIME_BATCH_INTERVAL(julianday, jd, jd);
+            break;
+        case TIME_GPS:
+            TIME_BATCH_INTERVAL(gpstime, gt, gt);
+            break;
+        case TIME_doy_t:
+            TIME_BATCH_INTERVAL(doy, doy, doy);
+            break;
+        case TIME_MJD:
+            TIME_BATCH_INTERVAL(mjd, mjd, mjd);
+            break;
+        default:
+            break;
+    }
+    pctx->has_prev = true;
+}
+
+/*
+ * 源时间批量换算为纳秒时间, 简化儒略日经GPS时换算. 超出纳秒时间范围的记录不输出,
+ * 按行号报告为无法解析的记录; 其余记录紧凑存入ns, pb->n更新为其个数.
+ */
+static void time_batch_to_ns(time_batch_ctx_t *pctx, time_type_t from)
+{
+    time_batch_t *pb = pctx->pb;
+    size_t n = pb->n;
+    size_t m, k;
+
+    switch (from) {
+        case TIME_COMMON:
+            m = time_conver_commontime_to_ns_batch(pb->ct, pb->ns, n, pb->line, pb->bad);
+            break;
+        case TIME_JULIAN:
+            m = time_conver_julianday_to_ns_batch(pb->jd, pb->ns, n, pb->line, pb->bad);
+            break;
+        case TIME_GPS:
+            m = time_conver_gpstime_to_ns_batch(pb->gt, pb->ns, n, pb->line, pb->bad);
+            break;
+        case TIME_doy_t:
+            m = time_conver_doy_to_ns_batch(pb->doy, pb->ns, n, pb->line, pb->bad);
+            break;
+        case TIME_MJD:
+            time_conver_mjd_to_gpstime_batch(pb->mjd, pb->gt, n);
+            m = time_conver_gpstime_to_ns_batch(pb->gt, pb->ns, n, pb->line, pb->bad);
+            break;
+        default:
+            m = 0;
+            break;
+    }
+
+    for (k = 0; k < n - m; k++) {
+        fprintf(stderr, "line %zu: invalid record: time out of range\n", pb->bad[k]);
+    }
+    pctx->errors += n - m;
+    pb->n = m;
+}
+
+//通用时、GPS时输入: 一次遍历经time_stream_t得到儒略日、年积日和另一种时间, 简化儒略日仍按批量核心转换
+static void time_batch_stream(time_batch_ctx_t *pctx)
+{
+    time_batch_t *pb = pctx->pb;
+    bool want[TIME_MAX] = { false };
+    size_t i;
+    int k;
+
+    for (k = 0; k < pctx->nto; k++) {
+        want[pctx->to[k]] = true;
+    }
+
+    if (pctx->from == TIME_GPS) {
+        for (i = 0; i < pb->n; i++) {
+            time_stream_gpstime(&pctx->stream, &pb->gt[i], want[TIME_COMMON] ? &pb->ct[i] : NULL,
+                want[TIME_JULIAN] ? &pb->jd[i] : NULL, want[TIME_doy_t] ? &pb->doy[i] : NULL);
+        }
+    } else {
+        for (i = 0; i < pb->n; i++) {
+            time_stream_commontime(&pctx->stream, &pb->ct[i], want[TIME_GPS] ? &pb->gt[i] : NULL,
+                want[TIME_JULIAN] ? &pb->jd[i] : NULL, want[TIME_doy_t] ? &pb->doy[i] : NULL);
+        }
+    }
+    if (want[TIME_MJD]) {
+        time_batch_convert(pb, pctx->from, TIME_MJD);
+    }
+}
+
+//源时间换算为--from-scale时标的基本表示: 通用时在pb->ct, 周计时系统时在pb->sys[0]
+static void time_batch_scale_load(time_batch_ctx_t *pctx, time_type_t from)
+{
+    time_batch_t *pb = pctx->pb;
+    time_type_t base = (pctx->scale_from >= TIME_SCALE_BDT && pctx->scale_from <= TIME_SCALE_QZSST)
+        ? TIME_GPS : TIME_COMMON;
+
+    if (from != base) {
+        time_batch_convert(pb, from, base);
+    }
+    if (from == TIME_GPS && base == TIME_GPS) {     //gps列即本系统的周数和周内秒
+        memcpy(pb->sys[0].bdt, pb->gt, sizeof(pb->gt[0]) * pb->n);
+        return;
+    }
+    switch (pctx->scale_from) {
+        case TIME_SCALE_BDT:
+            time_gnss_bdt_from_calendar(pb->gt, pb->sys[0].bdt, pb->n);
+            break;
+        case TIME_SCALE_GST:
+            time_gnss_gst_from_calendar(pb->gt, pb->sys[0].gst, pb->n);
+            break;
+        case TIME_SCALE_QZSST:
+            time_gnss_qzsst_from_calendar(pb->gt, pb->sys[0].qzs, pb->n);
+            break;
+        default:
+            break;
+    }
+}
+
+//由--to-scale时标的基本表示得到各目标时间, 周计时系统时的gps列为本系统的周数和周内秒
+static void time_batch_scale_store(time_batch_ctx_t *pctx)
+{
+    time_batch_t *pb = pctx->pb;
+    time_type_t base = TIME_COMMON;
+    bool sys_week = false;
+    int k;
+
+    switch (pctx->scale_to) {
+        case TIME_SCALE_BDT:
+            time_gnss_bdt_to_calendar(pb->sys[1].bdt, pb->gt, pb->n);
+            break;
+        case TIME_SCALE_GST:
+            time_gnss_gst_to_calendar(pb->sys[1].gst, pb->gt, pb->n);
+            break;
+        case TIME_SCALE_QZSST:
+            time_gnss_qzsst_to_calendar(pb->sys[1].qzs, pb->gt, pb->n);
+            break;
+        default:
+            break;
+    }
+    if (pctx->scale_to >= TIME_SCALE_BDT && pctx->scale_to <= TIME_SCALE_QZSST) {
+        base = TIME_GPS;
+    }
+
+    for (k = 0; k < pctx->nto; k++) {
+        if (pctx->to[k] == TIME_GPS && base == TIME_GPS) {
+            sys_week = true;
+        } else if (pctx->to[k] != base) {
+            time_batch_convert(pb, base, pctx->to[k]);
+        }
+    }
+    if (sys_week) {
+        memcpy(pb->gt, pb->sys[1].bdt, sizeof(pb->gt[0]) * pb->n);
+    }
+}
+
+/*
+ * 时标之间的批量换算, 源、目标为各自的基本表示(GPST为pb->gt).
+ * 北斗、伽利略、准天顶、格洛纳斯系统时两两之间用直接的批量核心, 其余经GPST.
+ */
+static void time_batch_scale_convert(time_batch_ctx_t *pctx, time_scale_t from, time_scale_t to)
+{
+    time_batch_t *pb = pctx->pb;
+    time_leap_table_t *ptbl = &pctx->leap;
+    time_gnss_batch_t *pin = &pb->sys[0];
+    time_gnss_batch_t *pout = &pb->sys[1];
+    size_t i, n = pb->n;
+
+#define TIME_SCALE_PAIR(a, b)   ((a) * TIME_SCALE_MAX + (b))
+    switch (TIME_SCALE_PAIR(from, to)) {
+        case TIME_SCALE_PAIR(TIME_SCALE_BDT, TIME_SCALE_GST):
+            time_conver_bdt_to_gst_batch(pin->bdt, pout->gst, n);
+            return;
+        case TIME_SCALE_PAIR(TIME_SCALE_GST, TIME_SCALE_BDT):
+            time_conver_gst_to_bdt_batch(pin->gst, pout->bdt, n);
+            return;
+        case TIME_SCALE_PAIR(TIME_SCALE_BDT, TIME_SCALE_QZSST):
+            time_conver_bdt_to_qzsst_batch(pin->bdt, pout->qzs, n);
+            return;
+        case TIME_SCALE_PAIR(TIME_SCALE_QZSST, TIME_SCALE_BDT):
+            time_conver_qzsst_to_bdt_batch(pin->qzs, pout->bdt, n);
+            return;
+        case TIME_SCALE_PAIR(TIME_SCALE_GST, TIME_SCALE_QZSST):
+            time_conver_gst_to_qzsst_batch(pin->gst, pout->qzs, n);
+            return;
+        case TIME_SCALE_PAIR(TIME_SCALE_QZSST, TIME_SCALE_GST):
+            time_conver_qzsst_to_gst_batch(pin->qzs, pout->gst, n);
+            return;
+        case TIME_SCALE_PAIR(TIME_SCALE_BDT, TIME_SCALE_GLONASST):
+            time_conver_bdt_to_glonasst_batch(ptbl, pin->bdt, pb->ct, n);
+            return;
+        case TIME_SCALE_PAIR(TIME_SCALE_GLONASST, TIME_SCALE_BDT):
+            time_conver_glonasst_to_bdt_batch(ptbl, pb->ct, pout->bdt, n);
+            return;
+        case TIME_SCALE_PAIR(TIME_SCALE_GST, TIME_SCALE_GLONASST):
+            time_conver_gst_to_glonasst_batch(ptbl, pin->gst, pb->ct, n);
+            return;
+        case TIME_SCALE_PAIR(TIME_SCALE_GLONASST, TIME_SCALE_GST):
+            time_conver_glonasst_to_gst_batch(ptbl, pb->ct, pout->gst, n);
+            return;
+        case TIME_SCALE_PAIR(TIME_SCALE_QZSST, TIME_SCALE_GLONASST):
+            time_conver_qzsst_to_glonasst_batch(ptbl, pin->qzs, pb->ct, n);
+            return;
+        case TIME_SCALE_PAIR(TIME_SCALE_GLONASST, TIME_SCALE_QZSST):
+            time_conver_glonasst_to_qzsst_batch(ptbl, pb->ct, pout->qzs, n);
+            return;
+        default:
+            break;
+    }
+#undef TIME_SCALE_PAIR
+
+    switch (from) {
+        case TIME_SCALE_UTC:
+            time_conver_utc_to_gpstime_batch(ptbl, pb->ct, pb->gt, n);
+            break;
+        case TIME_SCALE_TAI:
+            for (i = 0; i < n; i++) {
+                time_conver_tai_to_gpstime(&pb->ct[i], &pb->gt[i]);
+            }
+            break;
+        case TIME_SCALE_BDT:
+            time_conver_bdt_to_gpstime_batch(pin->bdt, pb->gt, n);
+            break;
+        case TIME_SCALE_GST:
+            time_conver_gst_to_gpstime_batch(pin->gst, pb->gt, n);
+            break;
+        case TIME_SCALE_QZSST:
+            time_conver_qzsst_to_gpstime_batch(pin->qzs, pb->gt, n);
+            break;
+        case TIME_SCALE_GLONASST:
+            time_conver_glonasst_to_gpstime_batch(ptbl, pb->ct, pb->gt, n);
+            break;
+        default:
+            break;
+    }
+    switch (to) {
+        case TIME_SCALE_UTC:
+            time_conver_gpstime_to_utc_batch(ptbl, pb->gt, pb->ct, n);
+            break;
+        case TIME_SCALE_TAI:
+            for (i = 0; i < n; i++) {
+                time_conver_gpstime_to_tai(&pb->gt[i], &pb->ct[i]);
+            }
+            break;
+        case TIME_SCALE_BDT:
+            time_conver_gpstime_to_bdt_batch(pb->gt, pout->bdt, n);
+            break;
+        case TIME_SCALE_GST:
+            time_conver_gpstime_to_gst_batch(pb->gt, pout->gst, n);
+            break;
+        case TIME_SCALE_QZSST:
+            time_conver_gpstime_to_qzsst_batch(pb->gt, pout->qzs, n);
+            break;
+        case TIME_SCALE_GLONASST:
+            time_conver_gpstime_to_glonasst_batch(ptbl, pb->gt, pb->ct, n);
+            break;
+        default:
+            break;
+    }
+}
+
+//源时间由--from-scale时标换算为GPST, 结果在pb->gt
+static void time_batch_scale_in(time_batch_ctx_t *pctx, time_type_t from)
+{
+    time_batch_scale_load(pctx, from);
+    time_batch_scale_convert(pctx, pctx->scale_from, TIME_SCALE_GPST);
+}
+
+//GPST源时间换算到--to-scale时标, 再由该时标的基本表示得到各目标时间
+static void time_batch_scale_out(time_batch_ctx_t *pctx, time_type_t from)
+{
+    if (from != TIME_GPS) {
+        time_batch_convert(pctx->pb, from, TIME_GPS);
+    }
+    time_batch_scale_convert(pctx, TIME_SCALE_GPST, pctx->scale_to);
+    time_batch_scale_store(pctx);
+}
+
+//纳秒时间批量换算为各目标时间, 简化儒略日经GPS时换算; 输出时标不是GPST时经GPS时换算
+static void time_batch_from_ns(time_batch_ctx_t *pctx)
+{
+    time_batch_t *pb = pctx->pb;
+    size_t n = pb->n;
+    bool gt_done = false;
+    int k;
+
+    if (pctx->scale_to != TIME_SCALE_GPST) {
+        time_conver_ns_to_gpstime_batch(pb->ns, pb->gt, n);
+        time_batch_scale_out(pctx, TIME_GPS);
+        return;
+    }
+
+    for (k = 0; k < pctx->nto; k++) {
+        switch (pctx->to[k]) {
+            case TIME_COMMON:
+                time_conver_ns_to_commontime_batch(pb->ns, pb->ct, n);
+                break;
+            case TIME_JULIAN:
+                time_conver_ns_to_julianday_batch(pb->ns, pb->jd, n);
+                break;
+            case TIME_doy_t:
+                time_conver_ns_to_doy_batch(pb->ns, pb->doy, n);
+                break;
+            case TIME_GPS:
+            case TIME_MJD:
+                if (!gt_done) {
+                    time_conver_ns_to_gpstime_batch(pb->ns, pb->gt, n);
+                    gt_done = true;
+                }
+                if (pctx->to[k] == TIME_MJD) {
+                    time_conver_gpstime_to_mjd_batch(pb->gt, pb->mjd, n);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+//按模板输出批次中第i个时间
+static char *time_batch_format(char *p, time_fmt_template_t fmt, const time_batch_t *pb, time_type_t type, size_t i)
+{
+    switch (type) {
+        case TIME_COMMON:
+            return time_fmt_time(p, fmt, type, &pb->ct[i]);
+        case TIME_JULIAN:
+            return time_fmt_time(p, fmt, type, &pb->jd[i]);
+        case TIME_GPS:
+            return time_fmt_time(p, fmt, type, &pb->gt[i]);
+        case TIME_doy_t:
+            return time_fmt_time(p, fmt, type, &pb->doy[i]);
+        case TIME_MJD:
+            return time_fmt_time(p, fmt, type, &pb->mjd[i]);
+        default:
+            return p;
+    }
+}
+
+//动态数组扩容到至少need个元素
+static int time_par_grow(void **pbuf, size_t *pcap, size_t need, size_t size)
+{
+    size_t cap = *pcap ? *pcap : 16;
+    void *buf;
+
+    if (need <= *pcap) {
+        return 0;
+    }
+    while (cap < need) {
+        cap *= 2;
+    }
+    buf = realloc(*pbuf, cap * size);
+    if (buf == NULL) {
+        return -1;
+    }
+    *pbuf = buf;
+    *pcap = cap;
+
+    return 0;
+}
+
+//报告无法解析的行: 串行模式直接输出, 并行模式记到块中
+static int time_batch_report(time_batch_ctx_t *pctx, const char *line, size_t n)
+{
+    time_par_chunk_t *pc = pctx->chunk;
+
+    pctx->errors++;
+    if (pc == NULL) {
+        fprintf(stderr, "line %zu: invalid record: %.*s\n", pctx->lineno,
+            (int)(n < TIME_BATCH_LINE_MAX ? n : TIME_BATCH_LINE_MAX), line);
+        return 0;
+    }
+
+    if (time_par_grow((void **)&pc->err, &pc->err_cap, pc->nerr + 1, sizeof(*pc->err)) != 0) {
+        return -1;
+    }
+    pc->err[pc->nerr].lineno = pctx->lineno;
+    pc->err[pc->nerr].line = line;
+    pc->err[pc->nerr].len = n;
+    pc->nerr++;
+
+    return 0;
+}
+
+//报告超出可表示范围的记录, lineno为其输入行号
+static int time_batch_report_range(time_batch_ctx_t *pctx, size_t lineno)
+{
+    time_par_chunk_t *pc = pctx->chunk;
+
+    pctx->errors++;
+    if (pc == NULL) {
+        fprintf(stderr, "line %zu: invalid record: time out of range\n", lineno);
+        return 0;
+    }
+
+    if (time_par_grow((void **)&pc->err, &pc->err_cap, pc->nerr + 1, sizeof(*pc->err)) != 0) {
+        return -1;
+    }
+    pc->err[pc->nerr].lineno = lineno;
+    pc->err[pc->nerr].line = NULL;
+    pc->err[pc->nerr].len = 0;
+    pc->nerr++;
+
+    return 0;
+}
+
+/*
+ * 年积日只能表示100-65535年: 输出年积日或平移年积日输入时, 平移后超出这一范围的记录
+ * 按行号报告, 不参与转换, 其余记录就地紧凑. 按简化儒略日判断, 年积日输入的两位年份与加秒时一样补全.
+ */
+#define TIME_BATCH_DOY_RANGE(src, to_mjd) \
+    do { \
+        for (i = 0; i < pb->n; i++) { \
+            to_mjd(&pb->src[i], &mjd); \
+            time_mjd_add(&mjd, pctx->shift); \
+            if (mjd.day - TIME_CIVIL_EPOCH_MJD < TIME_DOY_DAYS_MIN \
+                || mjd.day - TIME_CIVIL_EPOCH_MJD >= TIME_DOY_DAYS_END) { \
+                if (time_batch_report_range(pctx, pb->line[i]) != 0) { \
+                    return -1; \
+                } \
+                continue; \
+            } \
+            pb->line[m] = pb->line[i]; \
+            pb->src[m++] = pb->src[i]; \
+        } \
+    } while (0)
+
+static void time_batch_doy_to_mjd(const doy_t *pdoy, new_julianday_t *pmjd)
+{
+    pmjd->day = (long)(TIME_CIVIL_EPOCH_MJD + time_doy_days(pdoy));
+    pmjd->tod = pdoy->tod;
+}
+
+static void time_batch_mjd_to_mjd(const new_julianday_t *pin, new_julianday_t *pout)
+{
+    *pout = *pin;
+}
+
+//输出年积日, 或年积日输入需要平移
+static bool time_batch_want_doy(const time_batch_ctx_t *pctx)
+{
+    int k;
+
+    if (pctx->from == TIME_doy_t && pctx->shift != 0) {
+        return true;
+    }
+    for (k = 0; k < pctx->nto; k++) {
+        if (pctx->to[k] == TIME_doy_t) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static int time_batch_doy_range(time_batch_ctx_t *pctx)
+{
+    time_batch_t *pb = pctx->pb;
+    new_julianday_t mjd;
+    size_t i, m = 0;
+
+    switch (pctx->from) {
+        case TIME_COMMON:
+            TIME_BATCH_DOY_RANGE(ct, time_conver_commontime_to_mjd);
+            break;
+        case TIME_JULIAN:
+            TIME_BATCH_DOY_RANGE(jd, time_conver_julianday_to_mjd);
+            break;
+        case TIME_GPS:
+            TIME_BATCH_DOY_RANGE(gt, time_conver_gpstime_to_mjd);
+            break;
+        case TIME_doy_t:
+            TIME_BATCH_DOY_RANGE(doy, time_batch_doy_to_mjd);
+            break;
+        case TIME_MJD:
+            TIME_BATCH_DOY_RANGE(mjd, time_batch_mjd_to_mjd);
+            break;
+        default:
+            m = pb->n;
+            break;
+    }
+    pb->n = m;
+
+    return 0;
+}
+
+//按--to格式化当前批次并输出
+static int time_batch_write(time_batch_ctx_t *pctx)
+{
+    time_batch_t *pb = pctx->pb;
+    time_par_chunk_t *pc;
+    char *p = pctx->out;
+    size_t i;
+    int k;
+
+    for (i = 0; i < pb->n; i++) {
+        for (k = 0; k < pctx->nto; k++) {
+            if (k) {
+                *p++ = ',';
+            }
+            p = time_batch_format(p, pctx->fmt, pb, pctx->to[k], i);
+        }
+        if (pctx->interval) {
+            *p++ = ',';
+            p = time_fmt_double(p, pb->dt[i], 0);
+        }
+        *p++ = '\n';
+    }
+    pb->n = 0;
+
+    if (pctx->chunk != NULL) {
+        pc = pctx->chunk;
+        if (time_par_grow((void **)&pc->out, &pc->out_cap, pc->out_len + (size_t)(p - pctx->out), 1) != 0) {
+            return -1;
+        }
+        memcpy(pc->out + pc->out_len, pctx->out, (size_t)(p - pctx->out));
+        pc->out_len += (size_t)(p - pctx->out);
+        return 0;
+    }
+
+    return time_write_all(pctx->out_fd, pctx->out, (size_t)(p - pctx->out));
+}
+
+//转换并输出当前批次
+static int time_batch_flush(time_batch_ctx_t *pctx)
+{
+    time_batch_t *pb = pctx->pb;
+    time_type_t from = pctx->from;
+    size_t i;
+    int k;
+
+    if (pctx->rollover.modulus != 0) {
+        time_rollover_resolve_batch(&pctx->rollover, pb->gt, pb->n);
+    }
+    if (pctx->has_since || pctx->has_until) {
+        time_batch_select(pctx);
+    }
+    if (time_batch_want_doy(pctx) && time_batch_doy_range(pctx) != 0) {
+        return -1;
+    }
+    if (pb->n == 0) {
+        return 0;
+    }
+    if (pctx->interval) {
+        time_batch_interval(pctx);
+    }
+    if (pctx->shift != 0) {
+        time_batch_shift(pb, from, pctx->shift);
+    }
+    if (pctx->scale_from != TIME_SCALE_GPST && pctx->scale_to != TIME_SCALE_GPST) {
+        time_batch_scale_load(pctx, from);
+        time_batch_scale_convert(pctx, pctx->scale_from, pctx->scale_to);
+        time_batch_scale_store(pctx);
+        return time_batch_write(pctx);
+    }
+    if (pctx->scale_from != TIME_SCALE_GPST) {
+        time_batch_scale_in(pctx, from);
+        from = TIME_GPS;
+    }
+
+    if (pctx->epoch != NULL || pctx->delta != NULL) {
+        time_batch_to_ns(pctx, from);
+        i = pb->n;
+        pb->n = 0;
+        if (pctx->epoch != NULL) {
+            return time_epoch_writer_add(pctx->epoch, pb->ns, i);
+        }
+        i = time_delta_encode(pctx->delta, pb->ns, i, (uint8_t *)pctx->out);
+        return time_write_all(pctx->out_fd, pctx->out, i);
+    }
+
+    if (pctx->scale_to != TIME_SCALE_GPST) {
+        time_batch_scale_out(pctx, from);
+    } else if (from == pctx->from && (from == TIME_COMMON || from == TIME_GPS)) {
+        time_batch_stream(pctx);
+    } else {
+        for (k = 0; k < pctx->nto; k++) {
+            if (pctx->to[k] != from) {
+                time_batch_convert(pb, from, pctx->to[k]);
+            }
+        }
+    }
+
+    return time_batch_write(pctx);
+}
+
+//处理缓冲区中的完整行, 返回已消耗的字节数; eof为真时最后一行可以没有换行符
+static size_t time_batch_feed(time_batch_ctx_t *pctx, const char *data, size_t len, bool eof)
+{
+    const char *p = data;
+    const char *end = data + len;
+    const char *nl;
+    size_t n;
+
+    while (p < end) {
+        nl = memchr(p, '\n', (size_t)(end - p));
+        if (nl == NULL) {
+            if (!eof) {
+                break;
+            }
+            nl = end;
+        }
+
+        pctx->lineno++;
+        n = (size_t)(nl - p);
+        if (n > 0 && p[n - 1] == '\r') {
+            n--;
+        }
+        if (n > 0) {
+            pctx->pb->line[pctx->pb->n] = pctx->lineno;
+            if (time_batch_parse_line(pctx, p, n, pctx->pb->n) == 0) {
+                if (++pctx->pb->n == TIME_BATCH_RECORDS && time_batch_flush(pctx) != 0) {
+                    return (size_t)-1;
+                }
+            } else if (time_batch_report(pctx, p, n) != 0) {
+                return (size_t)-1;
+            }
+        }
+
+        p = (nl < end) ? nl + 1 : nl;
+    }
+
+    return (size_t)(p - data);
+}
+
+/*
+ * 并行模式: 输入按记录边界切成约TIME_PAR_CHUNK_SIZE字节的块, 块号轮流分到各线程的双端队列,
+ * 线程从自己队列的头部(块号最小处)取块, 自己的队列空了再从其他线程队列的尾部窃取.
+ * 每块独立解析、批量转换、格式化到块自己的输出缓冲区, 调用线程按块号顺序写出, 输出与串行模式一致.
+ * 线程只处理块号小于"已写出块数 + TIME_PAR_WINDOW * 线程数"的块, 未写出的结果因此有上限.
+ */
+typedef struct time_par_queue_s {
+    pthread_mutex_t lock;
+    size_t *idx;
+    size_t head;
+    size_t tail;
+} time_par_queue_t;
+
+typedef struct time_par_s {
+    const time_batch_ctx_t *proto;
+    time_par_chunk_t *chunk;
+    size_t nchunk;
+    time_par_queue_t *queue;
+    int nthread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    size_t written;
+    bool stop;                  //出错或已全部写出, 各线程应退出
+} time_par_t;
+
+typedef struct time_par_worker_s {
+    time_par_t *par;
+    int id;
+} time_par_worker_t;
+
+//取下一个块: 先取自己队列的头部, 再窃取其他队列的尾部; 全部取完返回false
+static bool time_par_take(time_par_t *par, int id, size_t *pci)
+{
+    time_par_queue_t *pq;
+    int i;
+
+    for (i = 0; i < par->nthread; i++) {
+        pq = &par->queue[(id + i) % par->nthread];
+        pthread_mutex_lock(&pq->lock);
+        if (pq->head < pq->tail) {
+            *pci = (i == 0) ? pq->idx[pq->head++] : pq->idx[--pq->tail];
+            pthread_mutex_unlock(&pq->lock);
+            return true;
+        }
+        pthread_mutex_unlock(&pq->lock);
+    }
+
+    return false;
+}
+
+static void *time_par_worker(void *arg)
+{
+    time_par_worker_t *pw = (time_par_worker_t *)arg;
+    time_par_t *par = pw->par;
+    time_par_chunk_t *pc;
+    time_batch_ctx_t ctx;
+    size_t window = (size_t)TIME_PAR_WINDOW * (size_t)par->nthread;
+    size_t ci;
+    bool stop;
+    int rv;
+
+    ctx = *par->proto;
+    ctx.pb = malloc(sizeof(*ctx.pb));
+    ctx.out = malloc((size_t)TIME_BATCH_RECORDS * TIME_MAX * (TIME_FMT_TIME_MAX + 1));
+    if (ctx.pb == NULL || ctx.out == NULL) {
+        free(ctx.pb);
+        free(ctx.out);
+        pthread_mutex_lock(&par->lock);
+        par->stop = true;
+        pthread_cond_broadcast(&par->cond);
+        pthread_mutex_unlock(&par->lock);
+        return NULL;
+    }
+
+    while (time_par_take(par, pw->id, &ci)) {
+        pthread_mutex_lock(&par->lock);
+        while (!par->stop && ci >= par->written + window) {
+            pthread_cond_wait(&par->cond, &par->lock);
+        }
+        stop = par->stop;
+        pthread_mutex_unlock(&par->lock);
+        if (stop) {
+            break;
+        }
+
+        pc = &par->chunk[ci];
+        ctx.chunk = pc;
+        ctx.lineno = 0;
+        ctx.pb->n = 0;
+        rv = (time_batch_feed(&ctx, pc->data, pc->len, true) == (size_t)-1) ? -1 : time_batch_flush(&ctx);
+
+        pthread_mutex_lock(&par->lock);
+        if (rv != 0) {
+            par->stop = true;
+        } else {
+            pc->lines = ctx.lineno;
+            pc->done = true;
+        }
+        pthread_cond_broadcast(&par->cond);
+        pthread_mutex_unlock(&par->lock);
+    }
+
+    free(ctx.pb);
+    free(ctx.out);
+
+    return NULL;
+}
+
+//按记录边界切块
+static size_t time_par_split(time_par_chunk_t *pchunk, const char *data, size_t len)
+{
+    const char *p = data;
+    const char *end = data + len;
+    const char *e;
+    size_t n = 0;
+
+    while (p < end) {
+        e = ((size_t)(end - p) > TIME_PAR_CHUNK_SIZE) ? p + TIME_PAR_CHUNK_SIZE : end;
+        if (e < end) {
+            e = memchr(e, '\n', (size_t)(end - e));
+            e = (e == NULL) ? end : e + 1;
+        }
+        pchunk[n].data = p;
+        pchunk[n].len = (size_t)(e - p);
+        n++;
+        p = e;
+    }
+
+    return n;
+}
+
+//并行转换整个输入, 行号与错误计数累计到pctx
+static int time_par_run(time_batch_ctx_t *pctx, const char *data, size_t len)
+{
+    time_par_t par;
+    time_par_worker_t *worker;
+    pthread_t *tid;
+    time_par_chunk_t *pc;
+    size_t *idx;
+    size_t i, k;
+    int started = 0;
+    int rv = 0;
+    int t;
+
+    memset(&par, 0, sizeof(par));
+    par.proto = pctx;
+    par.nthread = pctx->nthread;
+    par.chunk = calloc(len / TIME_PAR_CHUNK_SIZE + 1, sizeof(*par.chunk));
+    par.queue = calloc((size_t)par.nthread, sizeof(*par.queue));
+    idx = malloc((len / TIME_PAR_CHUNK_SIZE + 1) * sizeof(*idx));
+    worker = calloc((size_t)par.nthread, sizeof(*worker));
+    tid = calloc((size_t)par.nthread, sizeof(*tid));
+    if (par.chunk == NULL || par.queue == NULL || idx == NULL || worker == NULL || tid == NULL) {
+        rv = -1;
+        goto out;
+    }
+    par.nchunk = time_par_split(par.chunk, data, len);
+
+    //块号轮流分配, 各队列内按块号递增排列
+    k = 0;
+    for (t = 0; t < par.nthread; t++) {
+        pthread_mutex_init(&par.queue[t].lock, NULL);
+        par.queue[t].idx = idx + k;
+        par.queue[t].head = 0;
+        for (i = (size_t)t; i < par.nchunk; i += (size_t)par.nthread) {
+            idx[k++] = i;
+        }
+        par.queue[t].tail = (size_t)(idx + k - par.queue[t].idx);
+    }
+    pthread_mutex_init(&par.lock, NULL);
+    pthread_cond_init(&par.cond, NULL);
+
+    for (t = 0; t < par.nthread; t++) {
+        worker[t].par = &par;
+        worker[t].id = t;
+        if (pthread_create(&tid[t], NULL, time_par_worker, &worker[t]) != 0) {
+            break;
+        }
+        started++;
+    }
+
+    for (i = 0; i < par.nchunk && started > 0; i++) {
+        pc = &par.chunk[i];
+        pthread_mutex_lock(&par.lock);
+        while (!pc->done && !par.stop) {
+            pthread_cond_wait(&par.cond, &par.lock);
+        }
+        pthread_mutex_unlock(&par.lock);
+        if (!pc->done) {
+            rv = -1;
+            break;
+        }
+
+        for (k = 0; k < pc->nerr; k++) {
+            if (pc->err[k].line == NULL) {
+                fprintf(stderr, "line %zu: invalid record: time out of range\n", pctx->lineno + pc->err[k].lineno);
+                continue;
+            }
+            fprintf(stderr, "line %zu: invalid record: %.*s\n", pctx->lineno + pc->err[k].lineno,
+                (int)(pc->err[k].len < TIME_BATCH_LINE_MAX ? pc->err[k].len : TIME_BATCH_LINE_MAX),
+                pc->err[k].line);
+        }
+        pctx->errors += pc->nerr;
+        pctx->lineno += pc->lines;
+        rv = time_write_all(pctx->out_fd, pc->out, pc->out_len);
+        free(pc->out);
+        free(pc->err);
+        pc->out = NULL;
+        pc->err = NULL;
+
+        pthread_mutex_lock(&par.lock);
+        par.written = i + 1;
+        if (rv != 0) {
+            par.stop = true;
+        }
+        pthread_cond_broadcast(&par.cond);
+        pthread_mutex_unlock(&par.lock);
+        if (rv != 0) {
+            break;
+        }
+    }
+    if (started == 0) {
+        rv = -1;
+    }
+
+    //通知各线程退出(出错时可能还有线程在等待输出窗口)
+    pthread_mutex_lock(&par.lock);
+    par.stop = true;
+    pthread_cond_broadcast(&par.cond);
+    pthread_mutex_unlock(&par.lock);
+    for (t = 0; t < started; t++) {
+        pthread_join(tid[t], NULL);
+    }
+
+    for (t = 0; t < par.nthread; t++) {
+        pthread_mutex_destroy(&par.queue[t].lock);
+    }
+    pthread_mutex_destroy(&par.lock);
+    pthread_cond_destroy(&par.cond);
+    for (i = 0; i < par.nchunk; i++) {
+        free(par.chunk[i].out);
+        free(par.chunk[i].err);
+    }
+
+out:
+    free(par.chunk);
+    free(par.queue);
+    free(idx);
+    free(worker);
+    free(tid);
+
+    return rv;
+}
+
+static int time_batch_run(time_batch_ctx_t *pctx, int in_fd)
+{
+    struct stat st;
+    char *buf;
+    void *map;
+    size_t used = 0;
+    size_t done;
+    ssize_t n;
+
+    //普通文件: 整体映射后一次处理
+    if (fstat(in_fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, in_fd, 0);
+        if (map != MAP_FAILED) {
+            if (pctx->nthread > 1 && (size_t)st.st_size > TIME_PAR_CHUNK_SIZE) {
+                done = (time_par_run(pctx, map, (size_t)st.st_size) == 0) ? 0 : (size_t)-1;
+                munmap(map, (size_t)st.st_size);
+                return (done == 0) ? 0 : -1;
+            }
+            madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+            done = time_batch_feed(pctx, map, (size_t)st.st_size, true);
+            munmap(map, (size_t)st.st_size);
+            if (done == (size_t)-1) {
+                return -1;
+            }
+            return time_batch_flush(pctx);
+        }
+    }
+
+    //管道等: 大块读取, 未结束的行移到缓冲区开头
+    buf = malloc(TIME_BATCH_READ_SIZE);
+    if (buf == NULL) {
+        return -1;
+    }
+
+    while ((n = read(in_fd, buf + used, TIME_BATCH_READ_SIZE - used)) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            free(buf);
+            return -1;
+        }
+        used += (size_t)n;
+        done = time_batch_feed(pctx, buf, used, used == TIME_BATCH_READ_SIZE);
+        if (done == (size_t)-1) {
+            free(buf);
+            return -1;
+        }
+        memmove(buf, buf + done, used - done);
+        used -= done;
+    }
+
+    done = time_batch_feed(pctx, buf, used, true);
+    free(buf);
+    if (done == (size_t)-1) {
+        return -1;
+    }
+
+    return time_batch_flush(pctx);
+}
+
+/*
+ * RINEX观测文件历元索引: time_conver --rinex [-i file] [--format fmt]
+ * 只解析观测历元行, 换算为GPS时和年积日, 每个历元输出一行"字节偏移,GPS时,年积日",
+ * 字节偏移为历元行首在文件中的位置, 可用于随机访问. 历元行的格式:
+ *     RINEX 3: "> yyyy mm dd hh mm ss.sssssss  f nnn", 之后nnn行为各卫星的观测记录
+ *     RINEX 2: " yy mm dd hh mm ss.sssssss  f nnn卫星列表", 卫星列表每行12颗,
+ *              之后每颗卫星ceil(观测类型数/5)行, 观测类型数取自头部"# / TYPES OF OBSERV"
+ * 观测记录不逐行解析: RINEX 3直接查找下一个以'>'开头的行, RINEX 2按行数整段跳过.
+ * 事件标志2-5之后nnn行为头部记录, 跳过且不输出; 标志6(周跳记录)与观测记录一样跳过, 不输出.
+ * 历元行无法解析时报告行号(出错时才从上次报告处数换行符), 之后逐行查找下一个历元行.
+ * 普通文件整体mmap, 管道等输入先全部读入内存.
+ */
+#define TIME_RINEX_LABEL_COL    (60)        //头部记录的标签起始列
+#define TIME_RINEX_SAT_PER_LINE (12)        //RINEX 2历元行每行的卫星数
+#define TIME_RINEX_OBS_PER_LINE (5)         //RINEX 2每行的观测值个数
+
+//历元行各字段的起始列
+typedef struct time_rinex_layout_s {
+    int year;
+    int year_width;
+    int month;
+    int day;
+    int hour;
+    int minute;
+    int second;     //F11.7
+    int flag;
+    int nsat;       //I3
+} time_rinex_layout_t;
+
+static const time_rinex_layout_t g_rinex_layout[2] = {
+    { 1, 2, 4, 7, 10, 13, 15, 28, 29 },     //RINEX 2
+    { 2, 4, 7, 10, 13, 16, 18, 31, 32 },    //RINEX 3
+};
+
+typedef struct time_rinex_s {
+    const char *data;
+    const char *end;
+    int version;
+    int nobs;               //RINEX 2的观测类型数
+    const char *line_pos;   //行号计数的位置, 出错时从这里继续数换行符
+    size_t lineno;          //line_pos所在行的行号
+} time_rinex_t;
+
+//下一行行首
+static const char *time_rinex_next_line(const char *p, const char *end)
+{
+    const char *q = memchr(p, '\n', (size_t)(end - p));
+
+    return (q != NULL) ? q + 1 : end;
+}
+
+//行长度, 不含换行符
+static size_t time_rinex_line_len(const char *p, const char *end)
+{
+    const char *q = time_rinex_next_line(p, end);
+
+    if (q > p && q[-1] == '\n') {
+        q--;
+    }
+    if (q > p && q[-1] == '\r') {
+        q--;
+    }
+
+    return (size_t)(q - p);
+}
+
+//定宽整数字段: 右对齐, 前面可以有空格; 全为空格时返回blank
+static int time_rinex_int(const char *s, size_t len, int off, int width, int blank, int *pv)
+{
+    int v = 0;
+    int i = off;
+
+    if ((size_t)(off + width) > len) {
+        //行尾空格可能被截掉, 超出行长的字段视为空
+        for (; i < off + width && (size_t)i < len; i++) {
+            if (s[i] != ' ') {
+                return -1;
+            }
+        }
+        *pv = blank;
+        return (blank < 0) ? -1 : 0;
+    }
+
+    while (i < off + width && s[i] == ' ') {
+        i++;
+    }
+    if (i == off + width) {
+        *pv = blank;
+        return (blank < 0) ? -1 : 0;
+    }
+    for (; i < off + width; i++) {
+        if (s[i] < '0' || s[i] > '9') {
+            return -1;
+        }
+        v = v * 10 + (s[i] - '0');
+    }
+    *pv = v;
+
+    return 0;
+}
+
+/*
+ * 解析历元行的事件标志和卫星数(或特殊记录行数), 标志为0、1、6时再解析历元时刻.
+ * 两位年份按RINEX 2的约定补全(80-99为19xx). 秒的小数部分另由ptos返回, 不经过pct->second的double舍入.
+ */
+static int time_rinex_epoch(const char *s, size_t len, int version, common_time_t *pct, double *ptos, int *pflag, int *pnsat)
+{
+    const time_rinex_layout_t *pl = &g_rinex_layout[version >= 3];
+    const char *p, *end;
+    long long isec, num;
+    int nfrac;
+
+    if (time_rinex_int(s, len, pl->flag, 1, 0, pflag) != 0 || *pflag > 6
+        || time_rinex_int(s, len, pl->nsat, 3, 0, pnsat) != 0) {
+        return -1;
+    }
+    if (*pflag >= 2 && *pflag <= 5) {
+        return 0;
+    }
+
+    if (len < (size_t)(pl->second + 11) || s[pl->year - 1] != ' ' || s[pl->month - 1] != ' ' || s[pl->day - 1] != ' ' || s[pl->hour - 1] != ' ' || s[pl->minute - 1] != ' '
+        || time_rinex_int(s, len, pl->year, pl->year_width, -1, &pct->year) != 0
+        || time_rinex_int(s, len, pl->month, 2, -1, &pct->month) != 0
+        || time_rinex_int(s, len, pl->day, 2, -1, &pct->day) != 0
+        || time_rinex_int(s, len, pl->hour, 2, -1, &pct->hour) != 0
+        || time_rinex_int(s, len, pl->minute, 2, -1, &pct->minute) != 0
+        || pct->month < 1 || pct->month > 12 || pct->day < 1 || pct->day > 31
+        || pct->hour > 23 || pct->minute > 59) {
+        return -1;
+    }
+
+    end = s + pl->second + 11;
+    p = time_parse_skip_space(s + pl->second, end);
+    p = time_parse_decimal(p, end, &isec, &num, &nfrac);
+    if (p != end || isec < 0 || isec > 60) {
+        return -1;
+    }
+    pct->year = time_civil_year(pct->year);
+    *ptos = time_parse_frac(num, nfrac);
+    pct->second = (double)isec + *ptos;
+
+    return 0;
+}
+
+//第一个字段(行首)为以空格分隔的十进制整数部分
+static int time_rinex_version(const char *s, size_t len)
+{
+    size_t i = 0;
+    int v = 0;
+
+    while (i < len && s[i] == ' ') {
+        i++;
+    }
+    if (i == len || s[i] < '0' || s[i] > '9') {
+        return -1;
+    }
+    while (i < len && s[i] >= '0' && s[i] <= '9') {
+        v = v * 10 + (s[i++] - '0');
+    }
+
+    return v;
+}
+
+static bool time_rinex_label(const char *s, size_t len, const char *label)
+{
+    size_t n = strlen(label);
+
+    return len >= TIME_RINEX_LABEL_COL + n && memcmp(s + TIME_RINEX_LABEL_COL, label, n) == 0;
+}
+
+//解析头部, 返回观测记录第一行, 头部无效时返回NULL
+static const char *time_rinex_header(time_rinex_t *pr)
+{
+    const char *p = pr->data;
+    size_t len;
+    int n;
+
+    len = time_rinex_line_len(p, pr->end);
+    if (!time_rinex_label(p, len, "RINEX VERSION / TYPE") || p[20] != 'O') {
+        fprintf(stderr, "ERROR: not a RINEX observation file\n");
+        return NULL;
+    }
+    pr->version = time_rinex_version(p, 9);
+    if (pr->version < 1) {
+        fprintf(stderr, "ERROR: invalid RINEX version\n");
+        return NULL;
+    }
+
+    while (p < pr->end) {
+        len = time_rinex_line_len(p, pr->end);
+        if (time_rinex_label(p, len, "END OF HEADER")) {
+            break;
+        }
+        if (time_rinex_label(p, len, "# / TYPES OF OBSERV") && time_rinex_int(p, len, 0, 6, -1, &n) == 0) {
+            pr->nobs = n;
+        }
+        p = time_rinex_next_line(p, pr->end);
+    }
+    if (p >= pr->end) {
+        fprintf(stderr, "ERROR: RINEX header has no END OF HEADER\n");
+        return NULL;
+    }
+    if (pr->version < 3 && pr->nobs <= 0) {
+        fprintf(stderr, "ERROR: RINEX 2 header has no # / TYPES OF OBSERV\n");
+        return NULL;
+    }
+
+    return time_rinex_next_line(p, pr->end);
+}
+
+//跳过n行
+static const char *time_rinex_skip_lines(const char *p, const char *end, long n)
+{
+    while (n-- > 0 && p < end) {
+        p = time_rinex_next_line(p, end);
+    }
+
+    return p;
+}
+
+//报告无法解析的历元行, 行号从上次报告的位置数起
+static int time_rinex_report(time_batch_ctx_t *pctx, time_rinex_t *pr, const char *line, size_t len)
+{
+    const char *p = pr->line_pos;
+    const char *q;
+
+    while ((q = memchr(p, '\n', (size_t)(line - p))) != NULL) {
+        pr->lineno++;
+        p = q + 1;
+    }
+    pr->line_pos = line;
+    pctx->lineno = pr->lineno;
+
+    return time_batch_report(pctx, line, len);
+}
+
+//出错后查找下一个历元行
+static const char *time_rinex_resync(const time_rinex_t *pr, const char *p)
+{
+    common_time_t ct;
+    double tos;
+    int flag, nsat;
+
+    for (; p < pr->end; p = time_rinex_next_line(p, pr->end)) {
+        if (pr->version >= 3) {
+            if (*p == '>') {
+                break;
+            }
+        } else if (time_rinex_epoch(p, time_rinex_line_len(p, pr->end), pr->version, &ct, &tos, &flag, &nsat) == 0) {
+            break;
+        }
+    }
+
+    return p;
+}
+
+//扫描观测记录并输出历元索引, 头部无效时返回-2
+static int time_rinex_scan(time_batch_ctx_t *pctx, const char *data, size_t size)
+{
+    time_rinex_t r;
+    const char *p, *line;
+    common_time_t ct;
+    gps_time_t gt;
+    doy_t doy;
+    double tos;
+    char *out = pctx->out;
+    size_t len, n = 0;
+    long skip;
+    int flag, nsat;
+
+    memset(&r, 0, sizeof(r));
+    r.data = data;
+    r.end = data + size;
+    r.line_pos = data;
+    r.lineno = 1;
+
+    p = time_rinex_header(&r);
+    if (p == NULL) {
+        return -2;
+    }
+
+    while (p < r.end) {
+        line = p;
+        len = time_rinex_line_len(line, r.end);
+        p = time_rinex_next_line(line, r.end);
+        if (len == 0) {
+            continue;
+        }
+
+        if ((r.version >= 3 && *line != '>') || time_rinex_epoch(line, len, r.version, &ct, &tos, &flag, &nsat) != 0) {
+            if (time_rinex_report(pctx, &r, line, len) != 0) {
+                return -1;
+            }
+            p = time_rinex_resync(&r, p);
+            continue;
+        }
+
+        //事件记录之后为nsat行头部记录, 观测历元之后为各卫星的观测记录
+        if (r.version >= 3 || (flag >= 2 && flag <= 5)) {
+            skip = nsat;
+        } else {
+            skip = (nsat > 0 ? (nsat - 1) / TIME_RINEX_SAT_PER_LINE : 0)
+                + (long)nsat * ((r.nobs + TIME_RINEX_OBS_PER_LINE - 1) / TIME_RINEX_OBS_PER_LINE);
+        }
+        p = time_rinex_skip_lines(p, r.end, skip);
+        if (flag > 1) {
+            continue;
+        }
+
+        time_stream_commontime(&pctx->stream, &ct, &gt, NULL, &doy);
+        gt.tow.tos = tos;
+        doy.tod.tos = tos;
+        out = time_fmt_uint(out, (unsigned long long)(line - data), 0);
+        *out++ = ',';
+        out = time_fmt_time(out, pctx->fmt, TIME_GPS, &gt);
+        *out++ = ',';
+        out = time_fmt_time(out, pctx->fmt, TIME_doy_t, &doy);
+        *out++ = '\n';
+        if (++n == TIME_BATCH_RECORDS) {
+            if (time_write_all(pctx->out_fd, pctx->out, (size_t)(out - pctx->out)) != 0) {
+                return -1;
+            }
+            out = pctx->out;
+            n = 0;
+        }
+    }
+
+    return time_write_all(pctx->out_fd, pctx->out, (size_t)(out - pctx->out));
+}
+
+//整个输入读入内存后交给scan处理: 普通文件整体映射, 管道等全部读入
+static int time_input_run(time_batch_ctx_t *pctx, int in_fd, int (*scan)(time_batch_ctx_t *, const char *, size_t))
+{
+    struct stat st;
+    void *map;
+    char *buf = NULL;
+    size_t cap = 0;
+    size_t used = 0;
+    ssize_t n;
+    int rv;
+
+    //普通文件: 整体映射
+    if (fstat(in_fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, in_fd, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+            rv = scan(pctx, map, (size_t)st.st_size);
+            munmap(map, (size_t)st.st_size);
+            return rv;
+        }
+    }
+
+    //管道等: 全部读入内存
+    for (;;) {
+        if (time_par_grow((void **)&buf, &cap, used + TIME_BATCH_READ_SIZE, 1) != 0) {
+            free(buf);
+            return -1;
+        }
+        n = read(in_fd, buf + used, cap - used);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            free(buf);
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        used += (size_t)n;
+    }
+
+    rv = scan(pctx, buf, used);
+    free(buf);
+
+    return rv;
+}
+
+/*
+ * NMEA时间语句解码: 从任意切分的字节流中提取$--ZDA和$--RMC(任意双字符发送方标识)的UTC时刻,
+ * 校验和通过后换算为GPS时和儒略日.
+ * 完整落在本次输入中的语句直接在输入上解析, 只有跨越两次输入的语句才拷贝到解码器内的行缓冲,
+ * 解码过程不分配内存. 超过TIME_NMEA_SENTENCE_MAX字节的语句无论是否跨越两次输入都计为错误并丢弃. 日期换算经time_stream_t缓存, 同一天的语句只换算时分秒.
+ * NMEA时刻为UTC: 给出跳秒表时GPS时按跳秒修正(可表示23:59:60), 否则按time_conver_commontime_to_gpstime
+ * 直接换算; 儒略日为UTC时刻的儒略日.
+ */
+#define TIME_NMEA_SENTENCE_MAX  (128)       //NMEA 0183规定不超过82字节, 留出余量
+
+typedef enum time_nmea_type_e {
+    TIME_NMEA_ZDA,
+    TIME_NMEA_RMC
+} time_nmea_type_t;
+
+typedef struct time_nmea_epoch_s {
+    time_nmea_type_t type;
+    common_time_t utc;
+    gps_time_t gt;
+    julianday_t jd;
+} time_nmea_epoch_t;
+
+typedef struct time_nmea_s {
+    char buf[TIME_NMEA_SENTENCE_MAX];   //跨越两次输入的语句
+    size_t len;
+    bool skip;                          //超长语句, 丢弃到行尾
+    time_leap_table_t *pleap;           //为NULL时不做跳秒修正
+    time_stream_t stream;
+    size_t sentences;                   //校验和正确的语句数
+    size_t bad;                         //格式或校验和错误的语句数
+} time_nmea_t;
+
+static void time_nmea_init(time_nmea_t *pn, time_leap_table_t *pleap)
+{
+    memset(pn, 0, sizeof(*pn));
+    pn->pleap = pleap;
+    time_stream_init(&pn->stream);
+}
+
+static int time_nmea_hex(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+
+    return -1;
+}
+
+//'$'与'*'之间各字节的异或, 每次按8字节异或后再折叠
+static unsigned int time_nmea_checksum(const char *s, size_t len)
+{
+    uint64_t x = 0;
+    uint64_t v;
+    unsigned int c = 0;
+    size_t i = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        memcpy(&v, s + i, sizeof(v));
+        x ^= v;
+    }
+    x ^= x >> 32;
+    x ^= x >> 16;
+    x ^= x >> 8;
+    c = (unsigned int)(x & 0xFF);
+    for (; i < len; i++) {
+        c ^= (unsigned char)s[i];
+    }
+
+    return c;
+}
+
+//取下一个以','分隔的字段, 返回字段结束位置
+static const char *time_nmea_field(const char *p, const char *end, const char **pstart)
+{
+    const char *q = memchr(p, ',', (size_t)(end - p));
+
+    *pstart = p;
+
+    return (q != NULL) ? q : end;
+}
+
+//hhmmss[.ss], 秒的小数部分另存到*ptos, 不经过整数秒与小数相加再拆分的舍入
+static int time_nmea_time(const char *p, const char *end, common_time_t *pct, double *ptos)
+{
+    long long isec, num;
+    int nfrac;
+
+    if (end - p < 6 || time_parse_2digits(p, &pct->hour) != 0 || time_parse_2digits(p + 2, &pct->minute) != 0
+        || p[4] < '0' || p[4] > '9' || p[5] < '0' || p[5] > '9') {
+        return -1;
+    }
+    if (time_parse_decimal(p + 4, end, &isec, &num, &nfrac) != end) {
+        return -1;
+    }
+    *ptos = time_parse_frac(num, nfrac);
+    pct->second = (double)isec + *ptos;
+
+    return (pct->hour < ONE_DAY_HOURS && pct->minute < ONE_HOUR_MINUTES && pct->second < ONE_MINUTE_SECONDS + 1)
+        ? 0 : -1;
+}
+
+//按字段序号跳过若干字段
+static const char *time_nmea_skip_fields(const char *p, const char *end, int n)
+{
+    const char *q;
+
+    while (n-- > 0) {
+        q = memchr(p, ',', (size_t)(end - p));
+        if (q == NULL) {
+            return NULL;
+        }
+        p = q + 1;
+    }
+
+    return p;
+}
+
+//解析一条完整语句(不含行尾), 是ZDA/RMC且有效时返回0, 其他语句返回1, 错误返回-1
+static int time_nmea_sentence(time_nmea_t *pn, const char *s, size_t len, time_nmea_epoch_t *pe)
+{
+    const char *end = s + len;
+    const char *p, *f, *fe;
+    common_time_t *pct = &pe->utc;
+    double tos;
+    long long t;
+    int hi, lo, v, i;
+
+    while (end > s && (end[-1] == '\r' || end[-1] == ' ')) {
+        end--;
+    }
+    if (end - s < 10 || end[-3] != '*' || (hi = time_nmea_hex(end[-2])) < 0 || (lo = time_nmea_hex(end[-1])) < 0
+        || time_nmea_checksum(s + 1, (size_t)(end - s - 4)) != (unsigned int)(hi * 16 + lo)) {
+        return -1;
+    }
+    pn->sentences++;
+    end -= 3;
+
+    if (memcmp(s + 3, "ZDA,", 4) == 0) {
+        pe->type = TIME_NMEA_ZDA;
+        fe = time_nmea_field(s + 7, end, &f);
+        if (f == fe) {
+            return 1;                   //接收机尚未得到时间
+        }
+        if (time_nmea_time(f, fe, pct, &tos) != 0 || fe == end) {
+            return -1;
+        }
+        fe = time_nmea_field(fe + 1, end, &f);
+        if (fe - f != 2 || time_parse_2digits(f, &pct->day) != 0 || fe == end) {
+            return -1;
+        }
+        fe = time_nmea_field(fe + 1, end, &f);
+        if (fe - f != 2 || time_parse_2digits(f, &pct->month) != 0 || fe == end) {
+            return -1;
+        }
+        fe = time_nmea_field(fe + 1, end, &f);
+        if (fe - f != 4 || time_parse_2digits(f, &v) != 0 || time_parse_2digits(f + 2, &pct->year) != 0) {
+            return -1;
+        }
+        pct->year += v * 100;
+    } else if (memcmp(s + 3, "RMC,", 4) == 0) {
+        pe->type = TIME_NMEA_RMC;
+        fe = time_nmea_field(s + 7, end, &f);
+        if (f == fe) {
+            return 1;
+        }
+        if (time_nmea_time(f, fe, pct, &tos) != 0) {
+            return -1;
+        }
+        //时间之后依次为状态、纬度、N/S、经度、E/W、航速、航向, 第9个字段为ddmmyy
+        p = time_nmea_skip_fields(fe, end, 8);
+        if (p == NULL) {
+            return -1;
+        }
+        fe = time_nmea_field(p, end, &f);
+        if (f == fe) {
+            return 1;
+        }
+        if (fe - f != 6 || time_parse_2digits(f, &pct->day) != 0 || time_parse_2digits(f + 2, &pct->month) != 0
+            || time_parse_2digits(f + 4, &pct->year) != 0) {
+            return -1;
+        }
+        pct->year = time_civil_year(pct->year);
+    } else {
+        return 1;
+    }
+    if (pct->month < 1 || pct->month > 12 || pct->day < 1 || pct->day > 31) {
+        return -1;
+    }
+
+    time_stream_commontime(&pn->stream, pct, &pe->gt, &pe->jd, NULL);
+    pe->gt.tow.tos = tos;
+    pe->jd.tod.tos = tos;
+    if (pn->pleap != NULL) {
+        //跳秒当秒与次日0时的日历值相同, 按跳秒前的区间取偏差
+        t = (long long)pe->gt.wn * ONE_WEEK_SECONDS + pe->gt.tow.sn;
+        i = time_leap_find(pn->pleap, pct->second >= ONE_MINUTE_SECONDS ? t - 1 : t, 0);
+        t += pn->pleap->entry[i].tai_utc - TIME_TAI_MINUS_GPS;
+        pe->gt.wn = (int)time_floor_div(t, ONE_WEEK_SECONDS);
+        pe->gt.tow.sn = (long)(t - (long long)pe->gt.wn * ONE_WEEK_SECONDS);
+    }
+
+    return 0;
+}
+
+//解码一条语句并计数, 得到历元时返回1
+static int time_nmea_emit(time_nmea_t *pn, const char *s, size_t len, time_nmea_epoch_t *pe)
+{
+    int rv = time_nmea_sentence(pn, s, len, pe);
+
+    if (rv < 0) {
+        pn->bad++;
+    }
+
+    return rv == 0;
+}
+
+/*
+ * 输入一段字节流, 最多输出cap个历元到pout, 个数写入*pcount.
+ * 返回已消耗的字节数: 输出数组写满时停在下一条语句之前, 调用者应从返回位置继续输入;
+ * 末尾不完整的语句保存在解码器中, 计入已消耗.
+ */
+static size_t time_nmea_feed(time_nmea_t *pn, const char *data, size_t len, time_nmea_epoch_t *pout, size_t cap,
+    size_t *pcount)
+{
+    const char *p = data;
+    const char *end = data + len;
+    const char *s, *q;
+    size_t n = 0;
+    size_t take;
+
+    while (p < end && n < cap) {
+        //上次输入末尾的不完整语句或超长语句
+        if (pn->len > 0 || pn->skip) {
+            q = memchr(p, '\n', (size_t)(end - p));
+            take = (size_t)((q != NULL ? q : end) - p);
+            if (!pn->skip && pn->len + take > sizeof(pn->buf)) {
+                pn->skip = true;
+                pn->bad++;
+            }
+            if (!pn->skip) {
+                memcpy(pn->buf + pn->len, p, take);
+                pn->len += take;
+            }
+            if (q == NULL) {
+                p = end;
+                break;
+            }
+            p = q + 1;
+            if (!pn->skip) {
+                n += (size_t)time_nmea_emit(pn, pn->buf, pn->len, &pout[n]);
+            }
+            pn->len = 0;
+            pn->skip = false;
+            continue;
+        }
+
+        s = memchr(p, '$', (size_t)(end - p));
+        if (s == NULL) {
+            p = end;
+            break;
+        }
+        q = memchr(s, '\n', (size_t)(end - s));
+        if (q == NULL) {
+            if ((size_t)(end - s) > sizeof(pn->buf)) {
+                pn->skip = true;
+                pn->bad++;
+            } else {
+                memcpy(pn->buf, s, (size_t)(end - s));
+                pn->len = (size_t)(end - s);
+            }
+            p = end;
+            break;
+        }
+        if ((size_t)(q - s) > sizeof(pn->buf)) {
+            pn->bad++;                  //超长语句与跨越两次输入时一样丢弃, 结果不随输入的切分变化
+        } else {
+            n += (size_t)time_nmea_emit(pn, s, (size_t)(q - s), &pout[n]);
+        }
+        p = q + 1;
+    }
+
+    *pcount = n;
+
+    return (size_t)(p - data);
+}
+
+//NMEA流的最后一条语句可以没有行尾
+static size_t time_nmea_finish(time_nmea_t *pn, time_nmea_epoch_t *pe)
+{
+    size_t n = 0;
+
+    if (pn->len > 0 && !pn->skip) {
+        n = (size_t)time_nmea_emit(pn, pn->buf, pn->len, pe);
+    }
+    pn->len = 0;
+    pn->skip = false;
+
+    return n;
+}
+
+/*
+ * 命令行NMEA模式: time_conver --nmea [-i file] [--format fmt]
+ * 按到达的数据块增量解码(串口、TCP等管道输入也可), 每个ZDA/RMC历元输出一行"GPS时,儒略日",
+ * 每块输入处理完即写出. 结束时在标准错误输出统计, 有错误语句时退出码为3.
+ */
+#define TIME_NMEA_EPOCHS        (1024)
+
+static int time_nmea_run(time_batch_ctx_t *pctx, int in_fd)
+{
+    static time_nmea_epoch_t epochs[TIME_NMEA_EPOCHS];
+    time_nmea_t nmea;
+    char *buf, *out;
+    size_t off, done, count, i;
+    ssize_t n;
+    int rv = 0;
+
+    buf = malloc(TIME_BATCH_READ_SIZE);
+    if (buf == NULL) {
+        return -1;
+    }
+    time_nmea_init(&nmea, &pctx->leap);
+
+    for (;;) {
+        n = read(in_fd, buf, TIME_BATCH_READ_SIZE);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            rv = -1;
+            break;
+        }
+
+        off = 0;
+        do {
+            if (n == 0) {
+                done = 0;
+                count = time_nmea_finish(&nmea, epochs);
+            } else {
+                done = time_nmea_feed(&nmea, buf + off, (size_t)n - off, epochs, TIME_NMEA_EPOCHS, &count);
+            }
+            off += done;
+
+            out = pctx->out;
+            for (i = 0; i < count; i++) {
+                out = time_fmt_time(out, pctx->fmt, TIME_GPS, &epochs[i].gt);
+                *out++ = ',';
+                out = time_fmt_time(out, pctx->fmt, TIME_JULIAN, &epochs[i].jd);
+                *out++ = '\n';
+            }
+            if (time_write_all(pctx->out_fd, pctx->out, (size_t)(out - pctx->out)) != 0) {
+                rv = -1;
+                break;
+            }
+        } while (off < (size_t)n);
+
+        if (rv != 0 || n == 0) {
+            break;
+        }
+    }
+    free(buf);
+
+    fprintf(stderr, "nmea: %zu sentences, %zu invalid\n", nmea.sentences, nmea.bad);
+    pctx->errors = nmea.bad;
+
+    return rv;
+}
+
+/*
+ * 命令行历元文件读取: time_conver --epochs -i file --to types [--since gps] [--until gps] [--format fmt]
+ * 映射历元文件, 把ns列按批由time_conver_ns_to_*_batch换算为--to的各时间后输出, 只输出[since, until)内的历元;
+ * 块索引的最小、最大值与范围不相交的数据块整块跳过, 不访问其数据.
+ */
+static int time_epoch_run(time_batch_ctx_t *pctx, int in_fd, time_ns_t since, time_ns_t until)
+{
+    time_epoch_reader_t reader;
+    time_epoch_block_t blk;
+    time_batch_t *pb = pctx->pb;
+    time_ns_t shift;
+    size_t i, k;
+    int rv;
+
+    rv = time_epoch_reader_open(&reader, in_fd);
+    if (rv == -2) {
+        fprintf(stderr, "ERROR: not a valid epoch file\n");
+    }
+    if (rv != 0) {
+        return rv;
+    }
+
+    shift = time_ns_from_tos(pctx->shift);
+    for (i = 0; i < reader.hdr->nblocks && rv == 0; i++) {
+        time_epoch_reader_block(&reader, i, &blk);
+        if (blk.max_ns < since || blk.min_ns >= until) {
+            continue;
+        }
+        for (k = 0; k < blk.n; k++) {
+            if (blk.ns[k] < since || blk.ns[k] >= until) {
+                continue;
+            }
+            pb->ns[pb->n] = blk.ns[k] + shift;
+            if (++pb->n == TIME_BATCH_RECORDS) {
+                time_batch_from_ns(pctx);
+                if (time_batch_write(pctx) != 0) {
+                    rv = -1;
+                    break;
+                }
+            }
+        }
+    }
+    if (rv == 0 && pb->n > 0) {
+        time_batch_from_ns(pctx);
+        rv = time_batch_write(pctx);
+    }
+    time_epoch_reader_close(&reader);
+
+    return rv;
+}
+
+/*
+ * 命令行差分解码: time_conver --decode [-i file] --to types [--format fmt]
+ * 编码流(time_conver --from type --encode的输出)逐批解码, 解码时直接换算出--to需要的时间.
+ */
+static int time_delta_scan(time_batch_ctx_t *pctx, const char *data, size_t size)
+{
+    time_delta_decoder_t dec;
+    time_batch_t *pb = pctx->pb;
+    bool want[TIME_MAX] = { false };
+    int k;
+
+    for (k = 0; k < pctx->nto; k++) {
+        want[pctx->to[k]] = true;
+    }
+
+    if (pctx->scale_to != TIME_SCALE_GPST) {
+        memset(want, 0, sizeof(want));      //解码出GPS时后再按时标换算
+    }
+
+    time_delta_decoder_init(&dec, data, size);
+    for (;;) {
+        if (time_delta_decode(&dec, pb->gt, want[TIME_COMMON] ? pb->ct : NULL, want[TIME_JULIAN] ? pb->jd : NULL,
+            want[TIME_doy_t] ? pb->doy : NULL, TIME_BATCH_RECORDS, &pb->n) != 0) {
+            fprintf(stderr, "ERROR: corrupt delta stream at byte %zu\n", (size_t)(dec.p - (const uint8_t *)data));
+            return -2;
+        }
+        if (pb->n == 0) {
+            return 0;
+        }
+        if (pctx->scale_to != TIME_SCALE_GPST) {
+            time_batch_scale_out(pctx, TIME_GPS);
+        } else if (want[TIME_MJD]) {
+            time_batch_convert(pb, TIME_GPS, TIME_MJD);
+        }
+        if (time_batch_write(pctx) != 0) {
+            return -1;
+        }
+    }
+}
+
+/*
+ * 基准测试: time_conver --bench [-j N]
+ * 结果以CSV输出到标准输出(以'#'开头的行为说明), 每行一项测量:
+ *     section  : call(time_convert单次调用, 25种state), batch(time_conver_*_batch),
+ *                soa(列存储的time_conver_*_soa, 按CPU分派到AVX-512/AVX2或标量内核),
+ *                stream(time_stream_t由ct或gps转换为其余类型),
+ *                e2e(解析、转换为全部类型、格式化并写到/dev/null的完整批处理流程)
+ *     dataset  : uniform(1980-2037均匀随机历元), stream10hz(连续10Hz历元),
+ *                boundary(天、周、年边界前后2秒内的历元)
+ *     path     : state名称或"源类型_to_目标类型"
+ *     records  : 每轮处理的记录数, batch和soa按L1/L2/DRAM驻留取TIME_BENCH_L1/L2/DRAM条
+ * 数据集由固定种子的xorshift64*生成, 不依赖libc的rand, 不同版本、平台之间可直接比较.
+ * 每项测量重复运行至少TIME_BENCH_MIN_NS, 取TIME_BENCH_REPEAT次中最快的一次.
+ */
+#define TIME_BENCH_SEED         (20110106ULL)
+#define TIME_BENCH_MIN_NS       (100000000LL)
+#define TIME_BENCH_REPEAT       (3)
+#define TIME_BENCH_L1           (256)
+#define TIME_BENCH_L2           (8192)
+#define TIME_BENCH_DRAM         (1 << 20)
+#define TIME_BENCH_E2E          (1 << 20)
+
+typedef enum time_bench_dataset_e {
+    TIME_BENCH_UNIFORM,
+    TIME_BENCH_STREAM_10HZ,
+    TIME_BENCH_BOUNDARY,
+    TIME_BENCH_DATASET_MAX
+} time_bench_dataset_t;
+
+typedef struct time_bench_data_s {
+    size_t n;
+    common_time_t *ct;
+    julianday_t *jd;
+    gps_time_t *gt;
+    doy_t *doy;
+    new_julianday_t *mjd;
+} time_bench_data_t;
+
+static const char *const g_bench_dataset_name[TIME_BENCH_DATASET_MAX] = { "uniform", "stream10hz", "boundary" };
+static const char *const g_bench_type_name[TIME_MAX] = { "ct", "jd", "gps", "doy", "mjd" };
+static const char *const g_bench_state_name[] = {
+    "COMMON_TO_JULIAN", "COMMON_TO_GPS", "COMMON_TO_DOY", "COMMON_TO_MJD", "COMMON_TO_ALL",
+    "JULIAN_TO_COMMON", "JULIAN_TO_GPS", "JULIAN_TO_DOY", "JULIAN_TO_MJD", "JULIAN_TO_ALL",
+    "GPS_TO_COMMON", "GPS_TO_JULIAN", "GPS_TO_DOY", "GPS_TO_MJD", "GPS_TO_ALL",
+    "DOY_TO_COMMON", "DOY_TO_JULIAN", "DOY_TO_GPS", "DOY_TO_MJD", "DOY_TO_ALL",
+    "MJD_TO_COMMON", "MJD_TO_JULIAN", "MJD_TO_GPS", "MJD_TO_DOY", "MJD_TO_ALL"
+};
+
+//防止被测代码的结果被编译器优化掉
+static volatile long g_bench_sink;
+
+static uint64_t time_bench_rand(uint64_t *pstate)
+{
+    uint64_t x = *pstate;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *pstate = x;
+
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static long long time_bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+//GPS时加上秒数偏移(可为负), 周内秒借位到周数
+static void time_bench_gps_add(gps_time_t *pgt, long sn, double tos)
+{
+    long long t = (long long)pgt->wn * ONE_WEEK_SECONDS + pgt->tow.sn + sn;
+
+    pgt->tow.tos += tos;
+    if (pgt->tow.tos < 0) {
+        pgt->tow.tos += 1.0;
+        t--;
+    } else if (pgt->tow.tos >= 1.0) {
+        pgt->tow.tos -= 1.0;
+        t++;
+    }
+    pgt->wn = (int)time_floor_div(t, ONE_WEEK_SECONDS);
+    pgt->tow.sn = (long)(t - (long long)pgt->wn * ONE_WEEK_SECONDS);
+}
+
+static void time_bench_data_free(time_bench_data_t *pd)
+{
+    free(pd->ct);
+    free(pd->jd);
+    free(pd->gt);
+    free(pd->doy);
+    free(pd->mjd);
+    memset(pd, 0, sizeof(*pd));
+}
+
+static int time_bench_data_alloc(time_bench_data_t *pd, size_t n)
+{
+    pd->n = n;
+    pd->ct = malloc(n * sizeof(*pd->ct));
+    pd->jd = malloc(n * sizeof(*pd->jd));
+    pd->gt = malloc(n * sizeof(*pd->gt));
+    pd->doy = malloc(n * sizeof(*pd->doy));
+    pd->mjd = malloc(n * sizeof(*pd->mjd));
+    if (pd->ct == NULL || pd->jd == NULL || pd->gt == NULL || pd->doy == NULL || pd->mjd == NULL) {
+        time_bench_data_free(pd);
+        return -1;
+    }
+
+    return 0;
+}
 
-    if (pjd->tod.sn) {
-        printf("do you want to input julianday time again[y/n]: ");
-        scanf("%s", yesorno);
-        if (memcmp(yesorno, "n", strlen("n")) == 0) {
-            input_time = false;
+//生成数据集: 先生成GPS时, 再由直接转换得到其他四种表示
+static void time_bench_generate(time_bench_data_t *pd, time_bench_dataset_t set)
+{
+    uint64_t state = TIME_BENCH_SEED + (uint64_t)set;
+    uint64_t r;
+    gps_time_t *pgt;
+    doy_t doy;
+    size_t i;
+
+    for (i = 0; i < pd->n; i++) {
+        pgt = &pd->gt[i];
+        r = time_bench_rand(&state);
+
+        switch (set) {
+            case TIME_BENCH_UNIFORM:
+                pgt->wn = (int)(r % 3000);
+                pgt->tow.sn = (long)((r >> 12) % ONE_WEEK_SECONDS);
+                pgt->tow.tos = (double)((r >> 32) % 1000000) / 1000000.0;
+                break;
+            case TIME_BENCH_STREAM_10HZ:
+                pgt->wn = 1617;
+                pgt->tow.sn = 0;
+                pgt->tow.tos = 0;
+                time_bench_gps_add(pgt, (long)(i / 10), (double)(i % 10) / 10.0);
+                break;
+            default:
+                //天、周、年边界各占三分之一
+                if (r % 3 == 0) {
+                    pgt->wn = (int)((r >> 8) % 3000);
+                    pgt->tow.sn = (long)((r >> 20) % 7) * ONE_DAY_SECONDS;
+                } else if (r % 3 == 1) {
+                    pgt->wn = (int)((r >> 8) % 3000);
+                    pgt->tow.sn = 0;
+                } else {
+                    doy.year = (unsigned short)(1981 + (r >> 8) % 57);
+                    doy.day = 1;
+                    doy.tod.sn = 0;
+                    doy.tod.tos = 0;
+                    time_conver_doy_to_gpstime(&doy, pgt);
+                }
+                pgt->tow.tos = 0;
+                time_bench_gps_add(pgt, (long)((r >> 32) % 4000) / 1000 - 2, (double)((r >> 44) % 1000) / 1000.0);
+                break;
         }
+
+        time_conver_gpstime_to_commontime(pgt, &pd->ct[i]);
+        time_conver_gpstime_to_julianday(pgt, &pd->jd[i]);
+        time_conver_gpstime_to_doy(pgt, &pd->doy[i]);
+        time_conver_gpstime_to_mjd(pgt, &pd->mjd[i]);
     }
+}
 
-    if (input_time) {
-        printf("Please input julianday: \n");
-        printf("day: ");
-        scanf("%ld", &pjd->day);
-        printf("seconds: ");
-        scanf("%d", &pjd->tod.sn);
-        printf("Fractional of seconds: ");
-        scanf("%lf", &pjd->tod.tos);
+static void time_bench_report(const char *section, const char *dataset, const char *path, size_t records,
+    int nthread, long long ns, size_t bytes)
+{
+    double per = (double)ns / (double)records;
+
+    printf("%s,%s,%s,%zu,%d,%.3f,%.3f,", section, dataset, path, records, nthread, per, 1000.0 / per);
+    if (bytes) {
+        printf("%.1f\n", (double)bytes / ((double)ns / 1e9) / 1e6);
+    } else {
+        printf("\n");
     }
+}
 
-    if (TIME_DBG_OPEN) {
-        printf("jd.day      : %d\n", pjd->day);
-        printf("jd.tod.sn   : %d\n", pjd->tod.sn);
-        printf("jd.tod.tos  : %lf\n", pjd->tod.tos);
+//time_convert单次调用, records为一轮的调用次数, 返回每轮最快耗时(ns)
+static long long time_bench_call(const time_bench_data_t *pd, time_convert_state_t state, size_t records)
+{
+    time_convert_ctx_t ctx;
+    const char *base;
+    size_t size;
+    long long best = -1;
+    long long start, elapsed;
+    long sink = 0;
+    size_t rounds, r, i;
+    int k;
+
+    if (state <= TIME_COMMON_TO_ALL) {
+        base = (const char *)pd->ct;
+        size = sizeof(*pd->ct);
+    } else if (state <= TIME_JULIAN_TO_ALL) {
+        base = (const char *)pd->jd;
+        size = sizeof(*pd->jd);
+    } else if (state <= TIME_GPS_TO_ALL) {
+        base = (const char *)pd->gt;
+        size = sizeof(*pd->gt);
+    } else if (state <= TIME_doy_t_TO_ALL) {
+        base = (const char *)pd->doy;
+        size = sizeof(*pd->doy);
+    } else {
+        base = (const char *)pd->mjd;
+        size = sizeof(*pd->mjd);
     }
 
-    while (1) {
-        printf("\njulianday convert to [ct|gps|doy|all|quit|exit]: ");
-        scanf("%s", typename);
-        type = time_get_type_from_name(typename);
-        if (type == -2) {
-            continue;
+    memset(&ctx, 0, sizeof(ctx));
+    for (k = 0; k < TIME_BENCH_REPEAT; k++) {
+        rounds = 0;
+        start = time_bench_now();
+        do {
+            for (r = 0; r < 16; r++, rounds++) {
+                for (i = 0; i < records; i++) {
+                    time_convert(&ctx, base + i * size, state);
+                    sink += ctx.ct.day + ctx.jd.day + ctx.gt.wn + ctx.doy.day + ctx.mjd.day;
+                }
+            }
+            elapsed = time_bench_now() - start;
+        } while (elapsed < TIME_BENCH_MIN_NS);
+
+        elapsed /= (long long)rounds;
+        if (best < 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    g_bench_sink = sink;
+
+    return best;
+}
+
+static void time_bench_batch_run(const time_bench_data_t *pin, time_bench_data_t *pout, time_type_t from,
+    time_type_t to, size_t n)
+{
+    switch (from * TIME_MAX + to) {
+        case TIME_COMMON * TIME_MAX + TIME_JULIAN:
+            time_conver_commontime_to_julianday_batch(pin->ct, pout->jd, n);
+            break;
+        case TIME_COMMON * TIME_MAX + TIME_GPS:
+            time_conver_commontime_to_gpstime_batch(pin->ct, pout->gt, n);
+            break;
+        case TIME_COMMON * TIME_MAX + TIME_doy_t:
+            time_conver_commontime_to_doy_batch(pin->ct, pout->doy, n);
+            break;
+        case TIME_JULIAN * TIME_MAX + TIME_COMMON:
+            time_conver_julianday_to_commontime_batch(pin->jd, pout->ct, n);
+            break;
+        case TIME_JULIAN * TIME_MAX + TIME_GPS:
+            time_conver_julianday_to_gpstime_batch(pin->jd, pout->gt, n);
+            break;
+        case TIME_JULIAN * TIME_MAX + TIME_doy_t:
+            time_conver_julianday_to_doy_batch(pin->jd, pout->doy, n);
+            break;
+        case TIME_GPS * TIME_MAX + TIME_COMMON:
+            time_conver_gpstime_to_commontime_batch(pin->gt, pout->ct, n);
+            break;
+        case TIME_GPS * TIME_MAX + TIME_JULIAN:
+            time_conver_gpstime_to_julianday_batch(pin->gt, pout->jd, n);
+            break;
+        case TIME_GPS * TIME_MAX + TIME_doy_t:
+            time_conver_gpstime_to_doy_batch(pin->gt, pout->doy, n);
+            break;
+        case TIME_doy_t * TIME_MAX + TIME_COMMON:
+            time_conver_doy_to_commontime_batch(pin->doy, pout->ct, n);
+            break;
+        case TIME_doy_t * TIME_MAX + TIME_JULIAN:
+            time_conver_doy_to_julianday_batch(pin->doy, pout->jd, n);
+            break;
+        case TIME_doy_t * TIME_MAX + TIME_GPS:
+            time_conver_doy_to_gpstime_batch(pin->doy, pout->gt, n);
+            break;
+        case TIME_COMMON * TIME_MAX + TIME_MJD:
+            time_conver_commontime_to_mjd_batch(pin->ct, pout->mjd, n);
+            break;
+        case TIME_JULIAN * TIME_MAX + TIME_MJD:
+            time_conver_julianday_to_mjd_batch(pin->jd, pout->mjd, n);
+            break;
+        case TIME_GPS * TIME_MAX + TIME_MJD:
+            time_conver_gpstime_to_mjd_batch(pin->gt, pout->mjd, n);
+            break;
+        case TIME_doy_t * TIME_MAX + TIME_MJD:
+            time_conver_doy_to_mjd_batch(pin->doy, pout->mjd, n);
+            break;
+        case TIME_MJD * TIME_MAX + TIME_COMMON:
+            time_conver_mjd_to_commontime_batch(pin->mjd, pout->ct, n);
+            break;
+        case TIME_MJD * TIME_MAX + TIME_JULIAN:
+            time_conver_mjd_to_julianday_batch(pin->mjd, pout->jd, n);
+            break;
+        case TIME_MJD * TIME_MAX + TIME_GPS:
+            time_conver_mjd_to_gpstime_batch(pin->mjd, pout->gt, n);
+            break;
+        case TIME_MJD * TIME_MAX + TIME_doy_t:
+            time_conver_mjd_to_doy_batch(pin->mjd, pout->doy, n);
+            break;
+        default:
+            break;
+    }
+}
+
+//经time_stream_t把n条通用时或GPS时转换为其余三种时间
+static void time_bench_stream_run(const time_bench_data_t *pin, time_bench_data_t *pout, time_type_t from, size_t n)
+{
+    time_stream_t stream;
+    size_t i;
+
+    time_stream_init(&stream);
+    if (from == TIME_GPS) {
+        for (i = 0; i < n; i++) {
+            time_stream_gpstime(&stream, &pin->gt[i], &pout->ct[i], &pout->jd[i], &pout->doy[i]);
+        }
+    } else {
+        for (i = 0; i < n; i++) {
+            time_stream_commontime(&stream, &pin->ct[i], &pout->gt[i], &pout->jd[i], &pout->doy[i]);
+        }
+    }
+}
+
+//批量转换n条, to为TIME_MAX时经time_stream_t转换为全部类型, 返回每轮最快耗时(ns)
+static long long time_bench_batch(const time_bench_data_t *pin, time_bench_data_t *pout, time_type_t from,
+    time_type_t to, size_t n)
+{
+    long long best = -1;
+    long long start, elapsed;
+    size_t rounds;
+    int k;
+
+    for (k = 0; k < TIME_BENCH_REPEAT; k++) {
+        rounds = 0;
+        start = time_bench_now();
+        do {
+            if (to == TIME_MAX) {
+                time_bench_stream_run(pin, pout, from, n);
+            } else {
+                time_bench_batch_run(pin, pout, from, to, n);
+            }
+            rounds++;
+            elapsed = time_bench_now() - start;
+        } while (elapsed < TIME_BENCH_MIN_NS);
+
+        elapsed /= (long long)rounds;
+        if (best < 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    g_bench_sink = pout->ct[n - 1].day + pout->jd[n - 1].day + pout->gt[n - 1].wn + pout->doy[n - 1].day
+        + pout->mjd[n - 1].day;
+
+    return best;
+}
+
+//列存储测量用的三种容器, 由数据集逐列填入
+typedef struct time_bench_soa_s {
+    gps_time_soa_t gt;
+    julianday_soa_t jd;
+    common_time_soa_t ct;
+} time_bench_soa_t;
+
+static const char *const g_bench_soa_name[] = { "jd_to_gps", "gps_to_jd", "gps_to_ct", "ct_to_gps" };
+
+static void time_bench_soa_free(time_bench_soa_t *ps)
+{
+    time_soa_gps_free(&ps->gt);
+    time_soa_jd_free(&ps->jd);
+    time_soa_ct_free(&ps->ct);
+}
+
+static int time_bench_soa_alloc(time_bench_soa_t *ps, size_t n)
+{
+    if (time_soa_gps_alloc(&ps->gt, n) != 0 || time_soa_jd_alloc(&ps->jd, n) != 0
+        || time_soa_ct_alloc(&ps->ct, n) != 0) {
+        time_bench_soa_free(ps);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void time_bench_soa_fill(const time_bench_data_t *pd, time_bench_soa_t *ps)
+{
+    size_t i;
+
+    for (i = 0; i < ps->gt.n; i++) {
+        ps->gt.wn[i] = pd->gt[i].wn;
+        ps->gt.tow_sn[i] = (int)pd->gt[i].tow.sn;
+        ps->gt.tow_tos[i] = pd->gt[i].tow.tos;
+        ps->jd.day[i] = (int)pd->jd[i].day;
+        ps->jd.tod_sn[i] = (int)pd->jd[i].tod.sn;
+        ps->jd.tod_tos[i] = pd->jd[i].tod.tos;
+        ps->ct.year[i] = pd->ct[i].year;
+        ps->ct.month[i] = pd->ct[i].month;
+        ps->ct.day[i] = pd->ct[i].day;
+        ps->ct.hour[i] = pd->ct[i].hour;
+        ps->ct.minute[i] = pd->ct[i].minute;
+        ps->ct.second[i] = pd->ct[i].second;
+    }
+}
+
+//列存储转换前n条, path为g_bench_soa_name的下标; 各列由同一组历元换算得到, 结果与原列相同, 直接写回容器
+static long long time_bench_soa(time_bench_soa_t *ps, int path, size_t n)
+{
+    gps_time_soa_t gt = ps->gt;
+    julianday_soa_t jd = ps->jd;
+    common_time_soa_t ct = ps->ct;
+    long long best = -1;
+    long long start, elapsed;
+    size_t rounds;
+    int k;
+
+    gt.n = n;
+    jd.n = n;
+    ct.n = n;
+    for (k = 0; k < TIME_BENCH_REPEAT; k++) {
+        rounds = 0;
+        start = time_bench_now();
+        do {
+            switch (path) {
+                case 0:
+                    time_conver_julianday_to_gpstime_soa(&jd, &gt);
+                    break;
+                case 1:
+                    time_conver_gpstime_to_julianday_soa(&gt, &jd);
+                    break;
+                case 2:
+                    time_conver_gpstime_to_commontime_soa(&gt, &ct);
+                    break;
+                default:
+                    time_conver_commontime_to_gpstime_soa(&ct, &gt);
+                    break;
+            }
+            rounds++;
+            elapsed = time_bench_now() - start;
+        } while (elapsed < TIME_BENCH_MIN_NS);
+
+        elapsed /= (long long)rounds;
+        if (best < 0 || elapsed < best) {
+            best = elapsed;
         }
+    }
+    g_bench_sink = ps->gt.wn[n - 1] + ps->jd.day[n - 1] + ps->ct.day[n - 1];
+
+    return best;
+}
+
+//把数据集的前n条按输入格式写成文本, 返回长度
+static size_t time_bench_render(const time_bench_data_t *pd, time_type_t type, size_t n, char *buf)
+{
+    char *p = buf;
+    size_t i;
 
+    for (i = 0; i < n; i++) {
         switch (type) {
-            case TIME_GPS:
-                state = TIME_JULIAN_TO_GPS;
-                break;
             case TIME_COMMON:
-                state = TIME_JULIAN_TO_COMMON;
+                p = time_fmt_native(p, type, &pd->ct[i]);
                 break;
-            case TIME_doy_t:
-                state = TIME_JULIAN_TO_doy_t;
+            case TIME_JULIAN:
+                p = time_fmt_native(p, type, &pd->jd[i]);
                 break;
-            case TIME_MAX:
-                state = TIME_JULIAN_TO_ALL;
+            case TIME_GPS:
+                p = time_fmt_native(p, type, &pd->gt[i]);
+                break;
+            case TIME_MJD:
+                p = time_fmt_native(p, type, &pd->mjd[i]);
                 break;
             default:
-                return -1;
+                p = time_fmt_native(p, type, &pd->doy[i]);
+                break;
         }
-
-        rv = time_convert(pjd, state);
+        *p++ = '\n';
     }
 
-    return rv;
+    return (size_t)(p - buf);
 }
 
-static int time_convert_doy(int argc, char *argv[])
+//完整批处理流程: 解析text, 转换为全部类型, 按csv模板格式化并写到out_fd; 返回最快一次耗时(ns), 出错返回-1
+static long long time_bench_e2e(time_batch_ctx_t *pctx, time_type_t from, const char *text, size_t len)
 {
-    int type;
-    doy_t *pdoy = &g_doy;
-    time_convert_state_t state;
-    char typename[10];
-    int rv = 0;
-    char yesorno[10];
-    bool input_time = true;
+    long long best = -1;
+    long long start, elapsed;
+    int k, rv;
 
-    if (pdoy->year) {
-        printf("do you want to input doy time again[y/n]: ");
-        scanf("%s", yesorno);
-        if (memcmp(yesorno, "n", strlen("n")) == 0) {
-            input_time = false;
+    for (k = 0; k < TIME_BENCH_REPEAT; k++) {
+        pctx->from = from;
+        pctx->lineno = 0;
+        pctx->errors = 0;
+        pctx->pb->n = 0;
+        start = time_bench_now();
+        if (pctx->nthread > 1) {
+            rv = time_par_run(pctx, text, len);
+        } else {
+            rv = (time_batch_feed(pctx, text, len, true) == (size_t)-1) ? -1 : time_batch_flush(pctx);
+        }
+        elapsed = time_bench_now() - start;
+        if (rv != 0 || pctx->errors != 0) {
+            return -1;
+        }
+        if (best < 0 || elapsed < best) {
+            best = elapsed;
         }
     }
 
-    if (input_time) {
-        printf("Please input doy: \n");
-        printf("year: ");
-        scanf("%u", &pdoy->year);
-        printf("day: ");
-        scanf("%u", &pdoy->day);
-        printf("seconds: ");
-        scanf("%d", &pdoy->tod.sn);
-        printf("Fractional of seconds: ");
-        scanf("%lf", &pdoy->tod.tos);
-    }
+    return best;
+}
 
-    if (TIME_DBG_OPEN) {
-        printf("doy.year     : %d\n", pdoy->year);
-        printf("doy.day      : %d\n", pdoy->day);
-        printf("doy.tod.sn   : %d\n", pdoy->tod.sn);
-        printf("doy.tod.tos  : %lf\n", pdoy->tod.tos);
+static int time_bench_main(int nthread)
+{
+    static const size_t sizes[] = { TIME_BENCH_L1, TIME_BENCH_L2, TIME_BENCH_DRAM };
+    static const char *const size_name[] = { "l1", "l2", "dram" };
+    static const char *const simd_name[] = { "none", "avx2", "avx512" };
+    time_bench_data_t data, out;
+    time_bench_soa_t soa;
+    time_batch_ctx_t ctx;
+    char path[64];
+    char *text = NULL;
+    size_t len;
+    long long ns;
+    int set, st, from, to, s, t;
+    int rv = -1;
+
+    memset(&data, 0, sizeof(data));
+    memset(&out, 0, sizeof(out));
+    memset(&soa, 0, sizeof(soa));
+    memset(&ctx, 0, sizeof(ctx));
+    if (time_bench_data_alloc(&data, TIME_BENCH_DRAM) != 0 || time_bench_data_alloc(&out, TIME_BENCH_DRAM) != 0
+        || time_bench_soa_alloc(&soa, TIME_BENCH_DRAM) != 0) {
+        goto out;
+    }
+    text = malloc((size_t)TIME_BENCH_E2E * (TIME_FMT_TIME_MAX + 1));
+    ctx.pb = malloc(sizeof(*ctx.pb));
+    ctx.out = malloc((size_t)TIME_BATCH_RECORDS * TIME_MAX * (TIME_FMT_TIME_MAX + 1));
+    ctx.out_fd = open("/dev/null", O_WRONLY);
+    if (text == NULL || ctx.pb == NULL || ctx.out == NULL || ctx.out_fd < 0) {
+        goto out;
     }
+    for (t = 0; t < TIME_MAX; t++) {
+        ctx.to[t] = t;
+    }
+    ctx.nto = TIME_MAX;
+    ctx.fmt = TIME_FMT_CSV;
 
-    while (1) {
-        printf("\ndoy convert to [ct|jd|gt|all|quit|exit]: ");
-        scanf("%s", typename);
-        type = time_get_type_from_name(typename);
-        if (type == -2) {
-            continue;
+    printf("# time_conver bench seed=%llu simd=%s min_ns=%lld repeat=%d\n", TIME_BENCH_SEED,
+        simd_name[time_simd_level()], TIME_BENCH_MIN_NS, TIME_BENCH_REPEAT);
+    printf("section,dataset,path,records,threads,ns_per_record,mrecords_per_s,mb_per_s\n");
+
+    for (set = 0; set < TIME_BENCH_DATASET_MAX; set++) {
+        time_bench_generate(&data, set);
+
+        for (st = 0; st <= TIME_MJD_TO_ALL; st++) {
+            ns = time_bench_call(&data, st, TIME_BENCH_L1);
+            time_bench_report("call", g_bench_dataset_name[set], g_bench_state_name[st], TIME_BENCH_L1, 1, ns, 0);
         }
 
-        switch (type) {
-            case TIME_GPS:
-                state = TIME_doy_t_TO_GPS;
+        for (s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+            for (from = 0; from < TIME_MAX; from++) {
+                for (to = 0; to < TIME_MAX; to++) {
+                    if (from == to) {
+                        continue;
+                    }
+                    snprintf(path, sizeof(path), "%s_to_%s_%s", g_bench_type_name[from], g_bench_type_name[to],
+                        size_name[s]);
+                    ns = time_bench_batch(&data, &out, from, to, sizes[s]);
+                    time_bench_report("batch", g_bench_dataset_name[set], path, sizes[s], 1, ns, 0);
+                }
+            }
+        }
+
+        time_bench_soa_fill(&data, &soa);
+        for (s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+            for (t = 0; t < (int)(sizeof(g_bench_soa_name) / sizeof(g_bench_soa_name[0])); t++) {
+                snprintf(path, sizeof(path), "%s_%s", g_bench_soa_name[t], size_name[s]);
+                ns = time_bench_soa(&soa, t, sizes[s]);
+                time_bench_report("soa", g_bench_dataset_name[set], path, sizes[s], 1, ns, 0);
+            }
+        }
+
+        for (from = 0; from < TIME_MAX; from++) {
+            if (from != TIME_COMMON && from != TIME_GPS) {
+                continue;
+            }
+            for (s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+                snprintf(path, sizeof(path), "%s_to_all_%s", g_bench_type_name[from], size_name[s]);
+                ns = time_bench_batch(&data, &out, from, TIME_MAX, sizes[s]);
+                time_bench_report("stream", g_bench_dataset_name[set], path, sizes[s], 1, ns, 0);
+            }
+        }
+
+        for (from = 0; from < TIME_MAX; from++) {
+            len = time_bench_render(&data, from, TIME_BENCH_E2E, text);
+            for (t = 1; t <= nthread; t = (t < nthread && t * 2 > nthread) ? nthread : t * 2) {
+                ctx.nthread = t;
+                ns = time_bench_e2e(&ctx, from, text, len);
+                if (ns < 0) {
+                    goto out;
+                }
+                snprintf(path, sizeof(path), "%s_to_all", g_bench_type_name[from]);
+                time_bench_report("e2e", g_bench_dataset_name[set], path, TIME_BENCH_E2E, t, ns, len);
+            }
+        }
+        fflush(stdout);
+    }
+    rv = 0;
+
+out:
+    if (ctx.out_fd > 0) {
+        close(ctx.out_fd);
+    }
+    free(ctx.pb);
+    free(ctx.out);
+    free(text);
+    time_bench_data_free(&data);
+    time_bench_data_free(&out);
+    time_bench_soa_free(&soa);
+
+    return rv;
+}
+
+static void time_batch_usage(const char *prog)
+{
+    fprintf(stderr, "Usage:\n");
+    fprintf(stderr, "%s --from <ct|jd|gps|doy|mjd> --to <type[,type...]|all> [--input file]\n", prog);
+    fprintf(stderr, "    [--format csv|iso|rinex|wntow] [-j threads]\n");
+    fprintf(stderr, "  reads one record per line from file or stdin, writes converted records to stdout\n");
+    fprintf(stderr, "  -j N converts a regular input file on N threads (0: one per CPU), output keeps input order\n");
+    fprintf(stderr, "  --rollover 10|13 resolves truncated gps week numbers against --ref-week (default: current week),\n");
+    fprintf(stderr, "    --sliding moves the reference to each resolved week\n");
+    fprintf(stderr, "  --shift SEC adds SEC seconds to every input record before converting it\n");
+    fprintf(stderr, "  --since/--until T keep only the records in [since, until), T in the --from format\n");
+    fprintf(stderr, "  --interval appends the seconds elapsed since the previous record\n");
+    fprintf(stderr, "  --from-scale/--to-scale gpst|utc|tai|bdt|gst|qzsst|glonasst set the time scale of the input/output records\n");
+    fprintf(stderr, "    (default: gpst), gps columns of bdt/gst/qzsst are the system's own week and time of week\n");
+    fprintf(stderr, "  --leap-file FILE loads the leap second table (leap-seconds.list format) used for utc, glonasst and --nmea\n");
+    fprintf(stderr, "%s --rinex [--input file] [--format csv|iso|rinex|wntow]\n", prog);
+    fprintf(stderr, "  indexes the epochs of a RINEX 2/3 observation file: byte offset,gps time,doy\n");
+    fprintf(stderr, "%s --nmea [--input file] [--format csv|iso|rinex|wntow]\n", prog);
+    fprintf(stderr, "  decodes $--ZDA/$--RMC sentences from a stream: gps time,julian day\n");
+    fprintf(stderr, "%s --from <ct|jd|gps|doy|mjd> --output file [--to gps,doy] [--input file]\n", prog);
+    fprintf(stderr, "  writes the records to a binary epoch file, --to adds the optional gps/doy columns\n");
+    fprintf(stderr, "%s --epochs --input file --to <type[,type...]|all> [--since gps] [--until gps]\n", prog);
+    fprintf(stderr, "    [--format csv|iso|rinex|wntow]\n");
+    fprintf(stderr, "  converts the epochs of a binary epoch file in [since, until) to text\n");
+    fprintf(stderr, "%s --from <ct|jd|gps|doy|mjd> --encode [--input file]\n", prog);
+    fprintf(stderr, "  writes the records as a delta/run-length encoded gps time stream to stdout\n");
+    fprintf(stderr, "%s --decode --to <type[,type...]|all> [--input file] [--format csv|iso|rinex|wntow]\n", prog);
+    fprintf(stderr, "  decodes an encoded stream and converts it to text\n");
+    fprintf(stderr, "%s --bench [-j threads]\n", prog);
+    fprintf(stderr, "  runs the built-in benchmarks and writes the results to stdout as CSV\n");
+}
+
+static int time_batch_main(int argc, char *argv[])
+{
+    static const struct option batch_options[] = {
+        {"from", required_argument, NULL, 'f'},
+        {"to", required_argument, NULL, 't'},
+        {"input", required_argument, NULL, 'i'},
+        {"format", required_argument, NULL, 'F'},
+        {"jobs", required_argument, NULL, 'j'},
+        {"bench", no_argument, NULL, 'B'},
+        {"rinex", no_argument, NULL, 'R'},
+        {"nmea", no_argument, NULL, 'N'},
+        {"output", required_argument, NULL, 'o'},
+        {"epochs", no_argument, NULL, 'E'},
+        {"since", required_argument, NULL, 's'},
+        {"until", required_argument, NULL, 'u'},
+        {"encode", no_argument, NULL, 'e'},
+        {"decode", no_argument, NULL, 'd'},
+        {"rollover", required_argument, NULL, 'W'},
+        {"ref-week", required_argument, NULL, 'r'},
+        {"sliding", no_argument, NULL, 'S'},
+        {"shift", required_argument, NULL, 'D'},
+        {"from-scale", required_argument, NULL, 'x'},
+        {"to-scale", required_argument, NULL, 'X'},
+        {"leap-file", required_argument, NULL, 'L'},
+        {"interval", no_argument, NULL, 'I'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    time_batch_ctx_t ctx;
+    time_epoch_writer_t writer;
+    time_delta_encoder_t enc;
+    const char *input = NULL;
+    const char *output = NULL;
+    const char *leap_file = NULL;
+    const char *since_text = NULL;
+    const char *until_text = NULL;
+    int in_fd = STDIN_FILENO;
+    int from = -1;
+    bool bench = false;
+    bool rinex = false;
+    bool nmea = false;
+    bool epochs = false;
+    bool encode = false;
+    bool decode = false;
+    bool sliding = false;
+    int rollover = 0;
+    int ref_week = (int)((time(NULL) - (long long)TIME_GPS_EPOCH_DAYS * ONE_DAY_SECONDS) / ONE_WEEK_SECONDS);
+    time_ns_t since = INT64_MIN;
+    time_ns_t until = INT64_MAX;
+    uint32_t columns = 0;
+    gps_time_t gt;
+    int opt;
+    int rv;
+    int k;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.out_fd = STDOUT_FILENO;
+    time_leap_table_init(&ctx.leap);
+
+    while ((opt = getopt_long(argc, argv, "f:t:i:F:j:BRNo:Es:u:edW:r:SD:x:X:L:Ih", batch_options, NULL)) != -1) {
+        switch (opt) {
+            case 'f':
+                from = time_batch_type_from_name(optarg, strlen(optarg));
                 break;
-            case TIME_COMMON:
-                state = TIME_doy_t_TO_COMMON;
+            case 't':
+                if (time_batch_parse_targets(&ctx, optarg) != 0) {
+                    time_batch_usage(argv[0]);
+                    return 2;
+                }
                 break;
-            case TIME_JULIAN:
-                state = TIME_doy_t_TO_JULIAN;
+            case 'i':
+                input = optarg;
                 break;
-            case TIME_MAX:
-                state = TIME_doy_t_TO_ALL;
+            case 'j':
+                ctx.nthread = atoi(optarg);
+                if (ctx.nthread == 0) {
+                    ctx.nthread = (int)sysconf(_SC_NPROCESSORS_ONLN);
+                }
+                if (ctx.nthread < 1 || ctx.nthread > TIME_PAR_THREAD_MAX) {
+                    time_batch_usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'B':
+                bench = true;
+                break;
+            case 'R':
+                rinex = true;
+                break;
+            case 'N':
+                nmea = true;
+                break;
+            case 'o':
+                output = optarg;
+                break;
+            case 'E':
+                epochs = true;
+                break;
+            case 'e':
+                encode = true;
+                break;
+            case 'd':
+                decode = true;
+                break;
+            case 'W':
+                rollover = atoi(optarg);
+                break;
+            case 'r':
+                ref_week = atoi(optarg);
+                break;
+            case 'S':
+                sliding = true;
+                break;
+            case 'D':
+                ctx.shift = atof(optarg);
+                break;
+            case 'x':
+            case 'X':
+                if (time_batch_scale_from_name(optarg, (opt == 'x') ? &ctx.scale_from : &ctx.scale_to) != 0) {
+                    time_batch_usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'L':
+                leap_file = optarg;
+                break;
+            case 's':
+                since_text = optarg;
+                break;
+            case 'u':
+                until_text = optarg;
+                break;
+            case 'I':
+                ctx.interval = true;
+                break;
+            case 'F':
+                if (time_batch_fmt_from_name(optarg, &ctx.fmt) != 0) {
+                    time_batch_usage(argv[0]);
+                    return 2;
+                }
                 break;
             default:
-                return -1;
+                time_batch_usage(argv[0]);
+                return 2;
         }
+    }
 
-        rv = time_convert(pdoy, state);
+    if (bench) {
+        return (time_bench_main(ctx.nthread > 1 ? ctx.nthread : 1) == 0) ? 0 : 1;
     }
 
-    return rv;
+    //写历元文件时--to只选择可选列
+    if (output != NULL) {
+        for (k = 0; k < ctx.nto; k++) {
+            if (ctx.to[k] == TIME_GPS) {
+                columns |= TIME_EPOCH_COL_GPS;
+            } else if (ctx.to[k] == TIME_doy_t) {
+                columns |= TIME_EPOCH_COL_DOY;
+            } else {
+                time_batch_usage(argv[0]);
+                return 2;
+            }
+        }
+    }
+    if ((int)rinex + nmea + epochs + encode + decode + (output != NULL) > 1
+        || ((output != NULL || encode) && from < 0)
+        || ((epochs || decode) && ctx.nto == 0)
+        || (!rinex && !nmea && !epochs && !encode && !decode && output == NULL && (from < 0 || ctx.nto == 0))
+        || (ctx.scale_from != TIME_SCALE_GPST && from < 0)
+        || (ctx.scale_to != TIME_SCALE_GPST && (rinex || nmea || encode || output != NULL))
+        || ((since_text != NULL || until_text != NULL) && (rinex || nmea || decode))
+        || (ctx.interval && (rinex || nmea || epochs || encode || decode || output != NULL))) {
+        time_batch_usage(argv[0]);
+        return 2;
+    }
+
+    //--epochs的范围为GPS时, 其余按--from的格式给出, 与输入记录直接比较
+    if (epochs) {
+        if (since_text != NULL) {
+            if (time_parse_gpstime(since_text, strlen(since_text), &gt) != 0) {
+                time_batch_usage(argv[0]);
+                return 2;
+            }
+            if (time_conver_gpstime_to_ns(&gt, &since) != 0) {
+                time_batch_usage(argv[0]);
+                return 2;
+            }
+        }
+        if (until_text != NULL) {
+            if (time_parse_gpstime(until_text, strlen(until_text), &gt) != 0) {
+                time_batch_usage(argv[0]);
+                return 2;
+            }
+            if (time_conver_gpstime_to_ns(&gt, &until) != 0) {
+                time_batch_usage(argv[0]);
+                return 2;
+            }
+        }
+    } else {
+        ctx.has_since = (since_text != NULL);
+        ctx.has_until = (until_text != NULL);
+        if ((ctx.has_since && time_batch_parse_bound(from, since_text, &ctx.since) != 0)
+            || (ctx.has_until && time_batch_parse_bound(from, until_text, &ctx.until) != 0)) {
+            time_batch_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (leap_file != NULL && time_leap_table_load(&ctx.leap, leap_file) != 0) {
+        fprintf(stderr, "ERROR: cannot load leap second file %s\n", leap_file);
+        return 1;
+    }
+    ctx.from = from;
+    if (rollover != 0) {
+        if (from != TIME_GPS || time_rollover_init(&ctx.rollover, rollover, ref_week, sliding) != 0) {
+            time_batch_usage(argv[0]);
+            return 2;
+        }
+        if (sliding) {
+            ctx.nthread = 1;        //滑动窗口依赖输入顺序
+        }
+    }
+    if (ctx.interval) {
+        ctx.nthread = 1;            //与上一条记录求差依赖输入顺序
+    }
+
+    if (input != NULL) {
+        in_fd = open(input, O_RDONLY);
+        if (in_fd < 0) {
+            fprintf(stderr, "ERROR: cannot open %s: %s\n", input, strerror(errno));
+            return 1;
+        }
+    }
+
+    ctx.pb = malloc(sizeof(*ctx.pb));
+    ctx.out = malloc((size_t)TIME_BATCH_RECORDS * TIME_MAX * (TIME_FMT_TIME_MAX + 1));
+    if (ctx.pb == NULL || ctx.out == NULL) {
+        free(ctx.pb);
+        free(ctx.out);
+        return 1;
+    }
+    ctx.pb->n = 0;
+
+    if (output != NULL) {
+        if (time_epoch_writer_open(&writer, output, columns) != 0) {
+            fprintf(stderr, "ERROR: cannot create %s: %s\n", output, strerror(errno));
+            rv = -2;
+        } else {
+            ctx.epoch = &writer;
+            ctx.nthread = 1;        //历元文件按输入顺序逐块写出
+            rv = time_batch_run(&ctx, in_fd);
+            if (time_epoch_writer_close(&writer) != 0 && rv == 0) {
+                rv = -1;
+            }
+        }
+    } else if (encode) {
+        time_delta_encoder_init(&enc);
+        ctx.delta = &enc;
+        ctx.nthread = 1;            //编码流按输入顺序差分
+        rv = time_batch_run(&ctx, in_fd);
+        if (rv == 0) {
+            rv = time_write_all(ctx.out_fd, ctx.out, time_delta_finish(&enc, (uint8_t *)ctx.out));
+        }
+    } else if (rinex) {
+        rv = time_input_run(&ctx, in_fd, time_rinex_scan);
+    } else if (decode) {
+        rv = time_input_run(&ctx, in_fd, time_delta_scan);
+    } else if (nmea) {
+        rv = time_nmea_run(&ctx, in_fd);
+    } else if (epochs) {
+        rv = time_epoch_run(&ctx, in_fd, since, until);
+    } else {
+        rv = time_batch_run(&ctx, in_fd);
+    }
+    if (rv == -1) {
+        fprintf(stderr, "ERROR: %s\n", strerror(errno));
+    }
+
+    if (input != NULL) {
+        close(in_fd);
+    }
+    free(ctx.pb);
+    free(ctx.out);
+
+    return (rv != 0) ? 1 : (ctx.errors ? 3 : 0);
 }
 
 #if 0
@@ -786,9 +7819,16 @@ static void time_show_usage(char *argv)
 
 int main(int argc, char *argv[])  
 {
+    time_convert_ctx_t ctx;
     int rv = 0;
     int char_c;
 
+    if (argc > 1) {
+        return time_batch_main(argc, argv);
+    }
+
+    memset(&ctx, 0, sizeof(ctx));
+
 #if 0
     int arg_cnt = 0;
 
@@ -797,16 +7837,16 @@ int main(int argc, char *argv[])
  
         switch (char_c) {
             case 'c':
-                rv = time_convert_ct(argc, argv);
+                rv = time_convert_ct(&ctx, argc, argv);
                 break;
             case 'd':
-                rv = time_convert_doy(argc, argv);
+                rv = time_convert_doy(&ctx, argc, argv);
                 break;
             case 'g':
-                rv = time_convert_gps(argc, argv);
+                rv = time_convert_gps(&ctx, argc, argv);
                 break;
             case 'j':
-                rv = time_convert_jd(argc, argv);
+                rv = time_convert_jd(&ctx, argc, argv);
                 break;
             default:
                 rv = -1;
@@ -822,7 +7862,7 @@ int main(int argc, char *argv[])
     char typename[10];
 
     while (1) {
-        printf("Please input src time[ct|jd|gps|doy|quit|exit]: ");
+        printf("Please input src time[ct|jd|gps|doy|mjd|quit|exit]: ");
         scanf("%s", typename);
         type = time_get_type_from_name(typename);
         if (type == -2) {
@@ -831,16 +7871,19 @@ int main(int argc, char *argv[])
 
         switch (type) {
             case TIME_GPS:
-                rv = time_convert_gps(argc, argv);
+                rv = time_convert_gps(&ctx, argc, argv);
                 break;
             case TIME_COMMON:
-                rv = time_convert_ct(argc, argv);
+                rv = time_convert_ct(&ctx, argc, argv);
                 break;
             case TIME_doy_t:
-                rv = time_convert_doy(argc, argv);
+                rv = time_convert_doy(&ctx, argc, argv);
                 break;
             case TIME_JULIAN:
-                rv = time_convert_jd(argc, argv);
+                rv = time_convert_jd(&ctx, argc, argv);
+                break;
+            case TIME_MJD:
+                rv = time_convert_mjd(&ctx, argc, argv);
                 break;
             default:
                 rv = -2;